@@ -18,7 +18,6 @@ void Extract::GetStructureFromPDF(char* input)
 	fz_rect rect;
 	fz_matrix ctm;
 	fz_device* dev;
-	fz_pixmap *pix;
 	struct zblrouteset *getline=(struct zblrouteset *)malloc(sizeof(struct zblrouteset));
 	
 	ctx=fz_new_context(NULL,NULL,FZ_STORE_UNLIMITED);//ʼcontext
@@ -31,12 +30,11 @@ void Extract::GetStructureFromPDF(char* input)
 	ctm.d=1;
 	ctm.e=0;
 	ctm.f=0;
-	pix=fz_new_pixmap(ctx,fz_find_device_colorspace(ctx,"DeviceRGB"),rect.x1-rect.x0,rect.y1-rect.y0);
-	fz_clear_pixmap_with_value(ctx,pix,0xFF);//Ϊɫ
-	dev=fz_new_draw_device(ctx,pix);//ͼ豸
-	fz_run_page(doc,page,dev,ctm,0);//ҳƵpixmapɵĻͼ豸
+	dev=fz_new_capture_device(ctx,0);//ֻȡ,ٹդpixmap
+	fz_run_page(doc,page,dev,ctm,0);//ҳ,ȡڽ
 	//ȡ
-	fz_return_line(getline);
+	fz_return_line(dev,getline);
+	fz_free_device(dev);
 	/*
 		ӡṹȡ
 		printf("\n·%d\n",getline->count);
@@ -53,6 +51,8 @@ void Extract::GetStructureFromPDF(char* input)
 		}
 	*/
 	this->vectorset=new VectorSet(getline);
+	fz_free_line(getline);
+	free(getline);
 }
 VectorSet* Extract::getvectorset()
 {
@@ -1,48 +1,46 @@
 #include "Ipe_Bazeir.h"
 
 
-Ipe_Bazeir::Ipe_Bazeir(void)
+Ipe_Bazeir::Ipe_Bazeir(void):Ipe_GraphicCell(2,NULL)
+{
+	num=0;
+}
+
+Ipe_Bazeir::Ipe_Bazeir(Ipe_Geometry* store):Ipe_GraphicCell(2,store)
 {
 	num=0;
-	list=new Ipe_LinkList<Ipe_Point2D>;
 }
 
 
 Ipe_Bazeir::~Ipe_Bazeir(void)
 {
-	delete list;
-	//printf("Ipe_Bazeirͷ\n");
 }
 
 int Ipe_Bazeir::addpoint(double x1,double y1,double x2,double y2,double x3,double y3,int state)
 {
-	Ipe_Point2D* point1=new Ipe_Point2D(x1,y1,state);
-	Ipe_Point2D* point2=new Ipe_Point2D(x2,y2,state);
-	Ipe_Point2D* point3=new Ipe_Point2D(x3,y3,state);
-	list->add(point1);
-	list->add(point2);
-	list->add(point3);
+	appendpoint(x1,y1,state);
+	appendpoint(x2,y2,state);
+	appendpoint(x3,y3,state);
 	num++;
 	//printf("ӱ·:%d:%f %f  %f %f  %f %f",num,x1,y1,x2,y2,x3,y3);
 	return 0;
 }
-int Ipe_Bazeir::getnum()
+int Ipe_Bazeir::addmove(double x,double y)
 {
-	return num;
+	return addpoint(x,y,-1,-1,-1,-1,0);
 }
 
-Ipe_LinkList<class Ipe_Point2D>* Ipe_Bazeir::getlist()
+int Ipe_Bazeir::getnum()
 {
-	return list;
+	return num;
 }
+
 void Ipe_Bazeir::printPoint()
 {
 	printf("ߵĵ㼯%d\n",this->getnum());
-	Ipe_node<Ipe_Point2D>* p=list->headler;
-	while(p->next!=NULL)
+	for(int i=0;i<GetPointCount();i++)
 	{
-		printf("%f %f\n",p->next->t->getx(),p->next->t->gety());
-		p=p->next;
+		printf("%f %f\n",getx(i),gety(i));
 	}
 	//printf("ߵ㼯\n");
 }
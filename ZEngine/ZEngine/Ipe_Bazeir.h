@@ -1,20 +1,18 @@
 #pragma once
 #include "ipe_graphiccell.h"
-#include "Ipe_LinkList.h"
 #include "Ipe_Point2D.h"
 class EX_PORT Ipe_Bazeir :
 public Ipe_GraphicCell
 {
-	int num;//ߵ߶ε
-	Ipe_LinkList<class Ipe_Point2D>* list;//б
+	int num;//ߵĿ,ÿ,Ϊ3*num;״̬Ϊ0Ŀƶ,Ϊ߶
 public:
 	Ipe_Bazeir(void);
+	Ipe_Bazeir(Ipe_Geometry* store);//ӵĴ洢
 	~Ipe_Bazeir(void);
 	int addpoint(double x1,double y1,double x2,double y2,double x3,double y3,int state);//һ·,һ
+	int addmove(double x,double y);//һƶ,ռλ,״̬Ϊ0;ڿͷʱʾڴ˶Ͽ,֮߶δӸõ㿪ʼ
 	int getnum();//ñ߼е
-	Ipe_LinkList<class Ipe_Point2D>* getlist();//شűߵϢָ
 	virtual void printPoint();
-	virtual int gettype(){return 2;};//0- 1-ֱ߼ 2-߼
 	
 };
 
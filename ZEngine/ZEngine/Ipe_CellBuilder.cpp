@@ -0,0 +1,136 @@
+#include "Ipe_CellBuilder.h"
+
+
+Ipe_CellBuilder::Ipe_CellBuilder(Ipe_Geometry* store)
+{
+	this->store=store;
+	this->state=0;
+	this->originx=0;
+	this->originy=0;
+	this->currentx=0;
+	this->currenty=0;
+	this->lines=new Ipe_Lines(store);//ֱ߼
+	this->bazeir=new Ipe_Bazeir(store);//߶
+}
+
+
+Ipe_CellBuilder::~Ipe_CellBuilder(void)
+{
+	delete lines;
+	delete bazeir;
+}
+
+Ipe_GraphicCell* Ipe_CellBuilder::addpoint(int cmd,double p0,double p1,double p2,double p3,double p4,double p5)
+{
+	Ipe_GraphicCell* done=NULL;
+	if(state==0)//ʼ״̬Ϊ0
+	{
+		if(cmd==0)
+		{
+			originx=p0;
+			originy=p1;
+			currentx=p0;
+			currenty=p1;
+		}
+		else if(cmd==1)//ȷһֱ߼
+		{
+			state=1;
+			lines->addpoint(originx,originy,0);//
+			lines->addpoint(p0,p1,1);//ӵǰ
+			currentx=p0;
+			currenty=p1;
+		}
+		else if(cmd==3)//ȷһ߼
+		{
+			state=2;
+			bazeir->addpoint(originx,originy,-1,-1,-1,-1,0);
+			bazeir->addpoint(p0,p1,p2,p3,p4,p5,3);
+			currentx=p4;//ߵĵǰյ,ǵһƵ
+			currenty=p5;
+		}
+		return NULL;
+	}
+	if(state==1)//ֱ߼
+	{
+		if(cmd==1)//Ϊline to
+		{
+			lines->addpoint(p0,p1,1);
+			currentx=p0;
+			currenty=p1;
+		}
+		else if(cmd==3)//Ϊc ֱ߼,תΪߴ
+		{
+			done=lines;
+			lines=new Ipe_Lines(store);
+			bazeir->addpoint(currentx,currenty,-1,-1,-1,-1,0);//߼
+			bazeir->addpoint(p0,p1,p2,p3,p4,p5,3);
+			currentx=p4;
+			currenty=p5;
+			state=2;
+		}
+		else if(cmd==2)//Ϊh
+		{
+			lines->addpoint(originx,originy,2);//(·պ)
+			done=lines;
+			lines=new Ipe_Lines(store);
+			state=3;
+		}
+		return done;
+	}
+	if(state==2)//߼
+	{
+		if(cmd==1)//Ϊline to ߼,תΪֱߴ
+		{
+			done=bazeir;
+			bazeir=new Ipe_Bazeir(store);
+			lines->addpoint(currentx,currenty,0);
+			lines->addpoint(p0,p1,1);
+			currentx=p0;
+			currenty=p1;
+			state=1;
+		}
+		else if(cmd==3)//Ϊc
+		{
+			bazeir->addpoint(p0,p1,p2,p3,p4,p5,3);
+			currentx=p4;
+			currenty=p5;
+		}
+		else if(cmd==2)//Ϊh
+		{
+			bazeir->addpoint(originx,originy,-1,-1,-1,-1,2);
+			done=bazeir;
+			bazeir=new Ipe_Bazeir(store);
+			state=3;
+		}
+		return done;
+	}
+	//state==3 ¿ʼ·
+	originx=p0;
+	originy=p1;
+	currentx=p0;
+	currenty=p1;
+	state=0;
+	return NULL;
+}
+
+Ipe_GraphicCell* Ipe_CellBuilder::finish()
+{
+	Ipe_GraphicCell* done=NULL;
+	if(state==1)
+	{
+		done=lines;
+		lines=new Ipe_Lines(store);
+	}
+	else if(state==2)
+	{
+		done=bazeir;
+		bazeir=new Ipe_Bazeir(store);
+	}
+	state=0;
+	return done;
+}
+
+bool Ipe_CellBuilder::isclosed()
+{
+	return state==3;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Ipe_Geometry.h"
+#include "Ipe_GraphicCell.h"
+#include "Ipe_Lines.h"
+#include "Ipe_Bazeir.h"
+//ȡеm,l,h,cΪֱ߼߼,·ü·
+//ֱ߽ʱһ,hպϵǰ;ÿμӵһ,Ȩ
+class Ipe_CellBuilder
+{
+	Ipe_Geometry* store;
+	int state;//0- 1-ֱ߼ 2-߼ 3-ѱպ
+	double originx,originy;//ǰ·,ֱ߽ʱ,hʱպϵ
+	double currentx,currenty;//ǰ,Ϊյp4,p5
+	Ipe_Lines* lines;
+	Ipe_Bazeir* bazeir;
+public:
+	Ipe_CellBuilder(Ipe_Geometry* store);//ŵstore
+	~Ipe_CellBuilder(void);//ͷδļ
+	Ipe_GraphicCell* addpoint(int cmd,double p0,double p1,double p2,double p3,double p4,double p5);//cmdΪm,l,h,c(ֱӦ0,1,2,3),ļ,ûʱNULL
+	Ipe_GraphicCell* finish();//ȡĩβδպϵļ,ûʱNULL
+	bool isclosed();//һļǷhպ
+};
@@ -0,0 +1,351 @@
+#include "Ipe_ClipTable.h"
+#include "Ipe_Lines.h"
+#include "Ipe_Bazeir.h"
+#include "Ipe_CellBuilder.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define KEYSIZE 7//ÿԭʼ㱣p0-p5state
+
+static unsigned int mix(unsigned int h,unsigned int v)//FNV-1a
+{
+	for(int i=0;i<4;i++)
+	{
+		h^=(v>>(i*8))&0xff;
+		h*=16777619u;
+	}
+	return h;
+}
+
+static unsigned int floatbits(float f)
+{
+	unsigned int u;
+	memcpy(&u,&f,sizeof(u));
+	return u;
+}
+
+static void writepoint(Ipe_SvgWriter& w,const char* order,double x,double y)
+{
+	w.write(order);
+	w.writenumber(x);
+	w.write(' ');
+	w.writenumber(y);
+	w.write(' ');
+}
+
+Ipe_ClipTable::Ipe_ClipTable(const char* prefix)
+{
+	strncpy(this->prefix,prefix,sizeof(this->prefix)-1);
+	this->prefix[sizeof(this->prefix)-1]=0;
+	this->entries=NULL;
+	this->count=0;
+	this->capacity=0;
+	this->buckets=NULL;
+	this->bucketcount=0;
+	rehash(16);
+}
+
+Ipe_ClipTable::~Ipe_ClipTable(void)
+{
+	for(int i=0;i<this->count;i++)
+	{
+		freecells(&this->entries[i]);
+		free(this->entries[i].key);
+	}
+	free(this->entries);
+	free(this->buckets);
+}
+
+void Ipe_ClipTable::rehash(int bucketcount)
+{
+	free(this->buckets);
+	this->bucketcount=bucketcount;
+	this->buckets=(int*)malloc(bucketcount*sizeof(int));
+	for(int i=0;i<bucketcount;i++)
+		this->buckets[i]=-1;
+	for(int i=0;i<this->count;i++)
+	{
+		unsigned int b=this->entries[i].hash&(bucketcount-1);
+		while(this->buckets[b]!=-1)
+			b=(b+1)&(bucketcount-1);
+		this->buckets[b]=i;
+	}
+}
+
+int Ipe_ClipTable::intern(struct routepoint* clipheadler,int countclip,int type,int parent,fz_matrix matrix,int existcm,Ipe_Geometry* store)
+{
+	int i;
+	if(!existcm)
+		matrix=fz_identity;
+	//ȡԭʼ㲢ɢֵ
+	float* key=(float*)malloc((countclip>0?countclip:1)*KEYSIZE*sizeof(float));
+	struct routepoint* p=clipheadler;
+	for(i=0;i<countclip&&p->nextpoint!=NULL;i++)
+	{
+		p=p->nextpoint;
+		float* k=key+i*KEYSIZE;
+		k[0]=p->p0;
+		k[1]=p->p1;
+		k[2]=p->p2;
+		k[3]=p->p3;
+		k[4]=p->p4;
+		k[5]=p->p5;
+		k[6]=p->state;
+	}
+	countclip=i;
+	unsigned int h=2166136261u;
+	h=mix(h,type);
+	h=mix(h,parent);
+	h=mix(h,existcm);
+	h=mix(h,floatbits(matrix.a));
+	h=mix(h,floatbits(matrix.b));
+	h=mix(h,floatbits(matrix.c));
+	h=mix(h,floatbits(matrix.d));
+	h=mix(h,floatbits(matrix.e));
+	h=mix(h,floatbits(matrix.f));
+	for(i=0;i<countclip*KEYSIZE;i++)
+		h=mix(h,floatbits(key[i]));
+
+	unsigned int b=h&(this->bucketcount-1);
+	while(this->buckets[b]!=-1)//̽
+	{
+		struct clipentry* e=&this->entries[this->buckets[b]];
+		if(e->hash==h&&e->type==type&&e->parent==parent&&e->existcm==existcm&&e->keycount==countclip
+			&&e->matrix.a==matrix.a&&e->matrix.b==matrix.b&&e->matrix.c==matrix.c
+			&&e->matrix.d==matrix.d&&e->matrix.e==matrix.e&&e->matrix.f==matrix.f
+			&&memcmp(e->key,key,countclip*KEYSIZE*sizeof(float))==0)
+		{
+			free(key);
+			if(e->cells==NULL)//ѱͷŹ,½
+			{
+				build(e,store);
+				if(parent>=0)
+					retain(parent);
+			}
+			return this->buckets[b];
+		}
+		b=(b+1)&(this->bucketcount-1);
+	}
+	if(this->count==this->capacity)
+	{
+		this->capacity=this->capacity<16?16:this->capacity*2;
+		this->entries=(struct clipentry*)realloc(this->entries,this->capacity*sizeof(struct clipentry));
+	}
+	struct clipentry* e=&this->entries[this->count];
+	e->type=type;
+	e->parent=parent;
+	e->refs=0;//ջ
+	e->existcm=existcm;
+	e->matrix=matrix;
+	e->cells=NULL;
+	e->cellcount=0;
+	e->hash=h;
+	e->keycount=countclip;
+	e->key=key;
+	build(e,store);
+	if(parent>=0)//ü
+		retain(parent);
+	this->buckets[b]=this->count;
+	this->count++;
+	if(this->count*2>this->bucketcount)//װӳһʱ
+		rehash(this->bucketcount*2);
+	return this->count-1;
+}
+
+void Ipe_ClipTable::build(struct clipentry* e,Ipe_Geometry* store)//ԭʼΪֱ߼߼,store
+{
+	Ipe_CellBuilder builder(store);
+	Ipe_GraphicCell* cell;
+	e->cells=new Ipe_LinkList<Ipe_GraphicCell>();
+	e->cellcount=0;
+	for(int i=0;i<e->keycount;i++)
+	{
+		float* p=e->key+i*KEYSIZE;
+		cell=builder.addpoint((int)p[6],p[0],p[1],p[2],p[3],p[4],p[5]);
+		if(cell!=NULL)
+		{
+			e->cells->add(cell);
+			e->cellcount++;
+		}
+	}
+	cell=builder.finish();
+	if(cell!=NULL)
+	{
+		e->cells->add(cell);
+		e->cellcount++;
+	}
+}
+
+void Ipe_ClipTable::freecells(struct clipentry* e)
+{
+	if(e->cells==NULL)
+		return;
+	e->cells->deleteall();
+	delete e->cells;
+	e->cells=NULL;
+	e->cellcount=0;
+}
+
+void Ipe_ClipTable::retain(int index)
+{
+	if(index>=0&&index<this->count)
+		this->entries[index].refs++;
+}
+
+void Ipe_ClipTable::release(int index)
+{
+	while(index>=0&&index<this->count)//ü֮ͷ,⴦
+	{
+		struct clipentry* e=&this->entries[index];
+		if(e->refs<=0||--e->refs>0)
+			return;
+		freecells(e);
+		index=e->parent;
+	}
+}
+
+int Ipe_ClipTable::getcount()
+{
+	return this->count;
+}
+
+const char* Ipe_ClipTable::getprefix()
+{
+	return this->prefix;
+}
+
+int Ipe_ClipTable::gettype(int index)
+{
+	return this->entries[index].type;
+}
+
+int Ipe_ClipTable::getparent(int index)
+{
+	return this->entries[index].parent;
+}
+
+int Ipe_ClipTable::getcellcount(int index)
+{
+	return this->entries[index].cellcount;
+}
+
+Ipe_LinkList<Ipe_GraphicCell>* Ipe_ClipTable::getcells(int index)
+{
+	return this->entries[index].cells;
+}
+
+void Ipe_ClipTable::maketransform()
+{
+	for(int i=0;i<this->count;i++)
+	{
+		struct clipentry* e=&this->entries[i];
+		if(e->existcm!=1||e->cells==NULL)
+			continue;
+		Ipe_node<Ipe_GraphicCell>* cgc=e->cells->headler;
+		while(cgc->next!=NULL)
+		{
+			cgc=cgc->next;
+			cgc->t->transform(e->matrix);
+		}
+		e->existcm=0;//֮ͬĲüexistcmΪ0,ѱ任ĵ
+	}
+}
+
+size_t Ipe_ClipTable::getmemsize()
+{
+	size_t size=sizeof(Ipe_ClipTable)+(size_t)this->capacity*sizeof(struct clipentry)+(size_t)this->bucketcount*sizeof(int);
+	for(int i=0;i<this->count;i++)
+	{
+		size+=(size_t)this->entries[i].keycount*KEYSIZE*sizeof(float);
+		if(this->entries[i].cells!=NULL)
+			size+=sizeof(Ipe_LinkList<Ipe_GraphicCell>)+(size_t)this->entries[i].cellcount*(sizeof(Ipe_Bazeir)+sizeof(Ipe_node<Ipe_GraphicCell>));
+	}
+	return size;
+}
+
+void Ipe_ClipTable::writedefs(Ipe_SvgWriter& w,double height)
+{
+	int i,n,k;
+	bool opened=false;
+	for(i=0;i<this->count;i++)
+	{
+		struct clipentry* e=&this->entries[i];
+		if(e->refs<=0||e->cells==NULL)//Ѳκջ
+			continue;
+		if(!opened)
+		{
+			w.write("<defs>\n");
+			opened=true;
+		}
+		w.write("<clipPath id=\"");
+		w.write(this->prefix);
+		w.writeint(i+1);
+		w.write('"');
+		if(e->parent>=0)//ü
+		{
+			w.write(" clip-path=\"url(#");
+			w.write(this->prefix);
+			w.writeint(e->parent+1);
+			w.write(")\"");
+		}
+		w.write(">\n<path d=\"");
+		Ipe_node<Ipe_GraphicCell>* cgc=e->cells->headler;
+		while(cgc->next!=NULL)//ֱ߼
+		{
+			cgc=cgc->next;
+			if(cgc->t->gettype()==1)//ֱ߼
+			{
+				Ipe_Lines* lines=static_cast<Ipe_Lines*>(cgc->t);
+				for(n=0;n<lines->getnum();n++)
+				{
+					if(lines->getstate(n)==0)
+					{
+						writepoint(w,"M",lines->getx(n),height-lines->gety(n));
+					}
+					else if(lines->getstate(n)==1)
+					{
+						writepoint(w,"L",lines->getx(n),height-lines->gety(n));
+					}
+					else if(lines->getstate(n)==2)
+					{
+						writepoint(w,"L",lines->getx(n),height-lines->gety(n));
+						w.write("Z ");
+					}
+				}
+			}
+			else//߼
+			{
+				Ipe_Bazeir* bazeir=static_cast<Ipe_Bazeir*>(cgc->t);
+				if(bazeir->getnum()==0)
+					continue;
+				int pt=0;//ͼе±
+				writepoint(w,"M",bazeir->getx(pt),height-bazeir->gety(pt));//
+				pt+=3;
+				for(k=0;k<bazeir->getnum()-1;k++)
+				{
+					if(bazeir->getstate(pt)==0)//ڴ˶Ͽ
+					{
+						writepoint(w,"M",bazeir->getx(pt),height-bazeir->gety(pt));
+						pt+=3;
+						continue;
+					}
+					writepoint(w,"C",bazeir->getx(pt),height-bazeir->gety(pt));
+					pt++;
+					writepoint(w,"",bazeir->getx(pt),height-bazeir->gety(pt));
+					pt++;
+					w.writenumber(bazeir->getx(pt));
+					w.write(' ');
+					w.writenumber(height-bazeir->gety(pt));
+					w.write('\n');
+					pt++;
+				}
+			}
+		}
+		w.write('"');
+		if(e->type==2)//W*
+			w.write(" clip-rule=\"evenodd\"");
+		w.write("/>\n</clipPath>\n");
+	}
+	if(opened)
+		w.write("</defs>\n");
+}
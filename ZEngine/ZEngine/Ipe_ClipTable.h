@@ -0,0 +1,49 @@
+#pragma once
+#include "MuInclude.h"
+#include "Ipe_LinkList.h"
+#include "Ipe_Geometry.h"
+#include "Ipe_GraphicCell.h"
+#include "Ipe_SvgWriter.h"
+//ҳĲü·:ÿͬĲü·ֻȡһ,ջͨ±ò
+//ǶջĲüٸĵ,Ǽ¼ü±,ʱclipPathclip-path
+struct clipentry
+{
+	int type;//1-W 2-W*
+	int parent;//ü±,-1Ϊ
+	int refs;//ü,ջԱΪĲü
+	int existcm;//ǷҪmatrix任
+	fz_matrix matrix;//üʱջѺϲתþ
+	Ipe_LinkList<Ipe_GraphicCell>* cells;//ֱ߼߼,üΪ0ʱͷ
+	int cellcount;
+	unsigned int hash;
+	int keycount;//ԭʼ
+	float* key;//ԭʼ,ÿ7ֵ,жǷͬ
+};
+
+class EX_PORT Ipe_ClipTable
+{
+	struct clipentry* entries;
+	int count;
+	int capacity;
+	int* buckets;//Ŷַɢб,±,-1Ϊ
+	int bucketcount;//2
+	char prefix[32];//ʱclipPath idǰ׺
+	void rehash(int bucketcount);
+	void build(struct clipentry* e,Ipe_Geometry* store);
+	void freecells(struct clipentry* e);
+public:
+	Ipe_ClipTable(const char* prefix="c-star");//prefixΪidǰ׺,ԵĲüʹòͬǰ׺
+	~Ipe_ClipTable(void);
+	int intern(struct routepoint* clipheadler,int countclip,int type,int parent,fz_matrix matrix,int existcm,Ipe_Geometry* store);//һü·,±
+	void retain(int index);
+	void release(int index);//üΪ0ʱͷֱ߼߼,ͷü
+	int getcount();
+	const char* getprefix();
+	int gettype(int index);
+	int getparent(int index);
+	int getcellcount(int index);
+	Ipe_LinkList<Ipe_GraphicCell>* getcells(int index);
+	void maketransform();//ÿü·Լľֻ任һ
+	size_t getmemsize();
+	void writedefs(Ipe_SvgWriter& w,double height);//һ<defs>дԱõĲü·,idΪǰ׺±1
+};
@@ -15,3 +15,9 @@ Ipe_PdfDocument* Ipe_Engine::OpenPDFDocument(const char* path)
 	Ipe_PdfDocument* document=new Ipe_PdfDocument(path);
 	return document;
 }
+
+Ipe_PdfDocument* Ipe_Engine::OpenPDFDocument(const char* path,int threadcount)
+{
+	Ipe_PdfDocument* document=new Ipe_PdfDocument(path,threadcount);
+	return document;
+}
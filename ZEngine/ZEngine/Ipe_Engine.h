@@ -8,6 +8,7 @@ public:
 	Ipe_Engine(void);
 	~Ipe_Engine(void);
 	Ipe_PdfDocument* OpenPDFDocument(const char*); 
+	Ipe_PdfDocument* OpenPDFDocument(const char*,int threadcount);//߳ȡҳ
 	//Ipe_Render * createRender();
 
 };
@@ -0,0 +1,344 @@
+#include "Ipe_Flattener.h"
+#include "Ipe_PdfPage.h"
+#include "Ipe_PdfStack.h"
+#include "Ipe_PageView.h"
+#include <stdlib.h>
+#include <math.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#define IPE_FLATTEN_AVX
+#elif defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#include <emmintrin.h>
+#define IPE_FLATTEN_SSE2
+#endif
+#define IPE_FLATTEN_MAXSEGMENTS 1024//˻򼫴ߵ
+
+Ipe_Flattener::Ipe_Flattener(double tolerance)
+{
+	this->tolerance=tolerance>0?tolerance:0.05;
+	this->output=new Ipe_Geometry();
+	this->cells=NULL;
+	this->count=0;
+	this->capacity=0;
+}
+
+Ipe_Flattener::~Ipe_Flattener(void)
+{
+	delete this->output;
+	free(this->cells);
+}
+
+void Ipe_Flattener::settolerance(double tolerance)
+{
+	if(tolerance>0)
+		this->tolerance=tolerance;
+}
+
+double Ipe_Flattener::gettolerance()
+{
+	return this->tolerance;
+}
+
+void Ipe_Flattener::clear()
+{
+	this->output->clear();
+	this->count=0;
+}
+
+int Ipe_Flattener::segments(const double* x,const double* y,double tolerance)
+{
+	//nȷֺҸ߲ 3/4*max|P[i]-2P[i+1]+P[i+2]|/n^2
+	double ax=x[0]-2*x[1]+x[2],ay=y[0]-2*y[1]+y[2];
+	double bx=x[1]-2*x[2]+x[3],by=y[1]-2*y[2]+y[3];
+	double d=ax*ax+ay*ay;
+	double e=bx*bx+by*by;
+	if(e>d)
+		d=e;
+	double n=ceil(sqrt(0.75*sqrt(d)/tolerance));
+	if(!(n>=1))//NaN
+		return 1;
+	if(n>IPE_FLATTEN_MAXSEGMENTS)
+		return IPE_FLATTEN_MAXSEGMENTS;
+	return (int)n;
+}
+
+void Ipe_Flattener::evaluate(const double* x,const double* y,int n,double* outx,double* outy)
+{
+	//ݻϵ B(t)=((a*t+b)*t+c)*t+d
+	double ax=-x[0]+3*x[1]-3*x[2]+x[3],ay=-y[0]+3*y[1]-3*y[2]+y[3];
+	double bx=3*x[0]-6*x[1]+3*x[2],by=3*y[0]-6*y[1]+3*y[2];
+	double cx=3*(x[1]-x[0]),cy=3*(y[1]-y[0]);
+	double dx=x[0],dy=y[0];
+	double h=1.0/n;
+	int i=0;
+#if defined(IPE_FLATTEN_AVX)
+	__m256d vax=_mm256_set1_pd(ax),vbx=_mm256_set1_pd(bx),vcx=_mm256_set1_pd(cx),vdx=_mm256_set1_pd(dx);
+	__m256d vay=_mm256_set1_pd(ay),vby=_mm256_set1_pd(by),vcy=_mm256_set1_pd(cy),vdy=_mm256_set1_pd(dy);
+	__m256d vh=_mm256_set1_pd(h);
+	for(;i+4<=n-1;i+=4)//һĸ,ÿ,ûǰֵۻ
+	{
+		__m256d t=_mm256_mul_pd(_mm256_set_pd(i+4,i+3,i+2,i+1),vh);
+		__m256d px=_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(vax,t),vbx),t),vcx),t),vdx);
+		__m256d py=_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(vay,t),vby),t),vcy),t),vdy);
+		_mm256_storeu_pd(outx+i,px);
+		_mm256_storeu_pd(outy+i,py);
+	}
+#elif defined(IPE_FLATTEN_SSE2)
+	__m128d vax=_mm_set1_pd(ax),vbx=_mm_set1_pd(bx),vcx=_mm_set1_pd(cx),vdx=_mm_set1_pd(dx);
+	__m128d vay=_mm_set1_pd(ay),vby=_mm_set1_pd(by),vcy=_mm_set1_pd(cy),vdy=_mm_set1_pd(dy);
+	__m128d vh=_mm_set1_pd(h);
+	for(;i+2<=n-1;i+=2)//һ
+	{
+		__m128d t=_mm_mul_pd(_mm_set_pd(i+2,i+1),vh);
+		__m128d px=_mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(vax,t),vbx),t),vcx),t),vdx);
+		__m128d py=_mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(vay,t),vby),t),vcy),t),vdy);
+		_mm_storeu_pd(outx+i,px);
+		_mm_storeu_pd(outy+i,py);
+	}
+#endif
+	if(i<n-1)//ʣĵԼ֧SIMDʱ,ǰÿμӷ
+	{
+		double t=i*h;
+		double px=((ax*t+bx)*t+cx)*t+dx,py=((ay*t+by)*t+cy)*t+dy;
+		double h2=h*h,h3=h2*h;
+		//һ,,ײtֵ
+		double d1x=ax*(3*t*t*h+3*t*h2+h3)+bx*(2*t*h+h2)+cx*h;
+		double d1y=ay*(3*t*t*h+3*t*h2+h3)+by*(2*t*h+h2)+cy*h;
+		double d2x=ax*(6*t*h2+6*h3)+2*bx*h2,d2y=ay*(6*t*h2+6*h3)+2*by*h2;
+		double d3x=6*ax*h3,d3y=6*ay*h3;
+		for(;i<n-1;i++)
+		{
+			px+=d1x;
+			py+=d1y;
+			d1x+=d2x;
+			d1y+=d2y;
+			d2x+=d3x;
+			d2y+=d3y;
+			outx[i]=px;
+			outy[i]=py;
+		}
+	}
+	outx[n-1]=x[3];//յһεϸͬ
+	outy[n-1]=y[3];
+}
+
+int Ipe_Flattener::measure(Ipe_Bazeir* bazeir,int* segments)
+{
+	Ipe_Geometry* store=bazeir->getstore();
+	const double* x=store->getx()+bazeir->getoffset();
+	const double* y=store->gety()+bazeir->getoffset();
+	const int* state=store->getstate()+bazeir->getoffset();
+	double px[4],py[4];
+	int total=0;
+	if(bazeir->getnum()==0)
+		return 0;
+	px[3]=x[0];
+	py[3]=y[0];
+	total=1;//
+	for(int k=1,pt=3;k<bazeir->getnum();k++,pt+=3)
+	{
+		int n=1;
+		if(state[pt]==0)
+		{
+			px[3]=x[pt];
+			py[3]=y[pt];
+		}
+		else if(state[pt]!=2)
+		{
+			px[0]=px[3];
+			py[0]=py[3];
+			for(int j=0;j<3;j++)
+			{
+				px[j+1]=x[pt+j];
+				py[j+1]=y[pt+j];
+			}
+			n=Ipe_Flattener::segments(px,py,this->tolerance);
+		}
+		else
+		{
+			px[3]=x[pt];//պϺǰص
+			py[3]=y[pt];
+		}
+		if(segments!=NULL)
+			segments[k]=n;
+		total+=n;
+	}
+	return total;
+}
+
+void Ipe_Flattener::emit(Ipe_Bazeir* bazeir,const int* segments,int offset)
+{
+	Ipe_Geometry* store=bazeir->getstore();
+	const double* x=store->getx()+bazeir->getoffset();
+	const double* y=store->gety()+bazeir->getoffset();
+	const int* state=store->getstate()+bazeir->getoffset();
+	double* ox=this->output->getx()+offset;
+	double* oy=this->output->gety()+offset;
+	int* os=this->output->getstate()+offset;
+	double px[4],py[4];
+	ox[0]=px[3]=x[0];
+	oy[0]=py[3]=y[0];
+	os[0]=0;
+	int o=1;
+	for(int k=1,pt=3;k<bazeir->getnum();k++,pt+=3)
+	{
+		if(state[pt]==0||state[pt]==2)//ƶպϿһ
+		{
+			ox[o]=px[3]=x[pt];
+			oy[o]=py[3]=y[pt];
+			os[o++]=state[pt];
+			continue;
+		}
+		px[0]=px[3];
+		py[0]=py[3];
+		for(int j=0;j<3;j++)
+		{
+			px[j+1]=x[pt+j];
+			py[j+1]=y[pt+j];
+		}
+		int n=segments[k];
+		Ipe_Flattener::evaluate(px,py,n,ox+o,oy+o);
+		for(int j=0;j<n;j++)
+			os[o+j]=1;
+		o+=n;
+	}
+}
+
+int Ipe_Flattener::flatten(Ipe_Bazeir* bazeir)
+{
+	this->pending.push_back(bazeir);
+	flattenpending();
+	return this->count-1;
+}
+
+void Ipe_Flattener::collect(Ipe_LinkList<Ipe_PdfElement>* list)
+{
+	Ipe_node<Ipe_PdfElement>* current=list->headler;
+	while(current->next!=NULL)//ջ
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_node<Ipe_PdfPath>* pathlist=static_cast<Ipe_PdfStack*>(current->t)->getpathlist()->headler;
+		while(pathlist->next!=NULL)
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)
+			{
+				cplane=cplane->next;
+				Ipe_node<Ipe_GraphicCell>* cgc=cplane->t->getlist()->headler;
+				while(cgc->next!=NULL)
+				{
+					cgc=cgc->next;
+					if(cgc->t->gettype()==2)
+						this->pending.push_back(static_cast<Ipe_Bazeir*>(cgc->t));
+				}
+			}
+		}
+	}
+}
+
+void Ipe_Flattener::flattenpending()//:ÿĵȷܵ,һչ,ֱд
+{
+	int blocks=0,i;
+	int n=(int)this->pending.size();
+	for(i=0;i<n;i++)
+		blocks+=this->pending[i]->getnum();
+	if(this->count+n>this->capacity)
+	{
+		this->capacity=this->count+n>this->capacity*2?this->count+n:this->capacity*2;
+		this->cells=(struct flatcell*)realloc(this->cells,this->capacity*sizeof(struct flatcell));
+	}
+	int* segments=(int*)malloc((blocks>0?blocks:1)*sizeof(int));
+	int total=0,b=0;
+	for(i=0;i<n;i++)
+	{
+		struct flatcell* c=&this->cells[this->count+i];
+		c->bazeir=this->pending[i];
+		c->count=measure(c->bazeir,segments+b);
+		c->offset=total;
+		total+=c->count;
+		b+=c->bazeir->getnum();
+	}
+	int begin=this->output->extend(total);
+	b=0;
+	for(i=0;i<n;i++)
+	{
+		struct flatcell* c=&this->cells[this->count+i];
+		c->offset+=begin;
+		if(c->count>0)
+			emit(c->bazeir,segments+b,c->offset);
+		b+=c->bazeir->getnum();
+	}
+	free(segments);
+	this->count+=n;
+	this->pending.clear();
+}
+
+int Ipe_Flattener::flattenpage(Ipe_PdfPage* page)
+{
+	int before=this->count;
+	collect(page->getelement());
+	Ipe_node<Ipe_PdfXobject>* x=page->getxobjects()->headler;
+	while(x->next!=NULL)
+	{
+		x=x->next;
+		collect(x->t->getelement());
+	}
+	Ipe_node<Ipe_PdfPattern>* p=page->getpatterns()->headler;
+	while(p->next!=NULL)
+	{
+		p=p->next;
+		collect(p->t->getelement());
+	}
+	flattenpending();
+	return this->count-before;
+}
+
+int Ipe_Flattener::flattenview(Ipe_PageView* view)
+{
+	int before=this->count;
+	for(int i=0;i<view->getcount();i++)
+	{
+		struct viewplane* e=view->get(i);
+		if(e->plane==NULL)
+			continue;
+		Ipe_node<Ipe_GraphicCell>* cgc=e->cells->headler;
+		while(cgc->next!=NULL)
+		{
+			cgc=cgc->next;
+			if(cgc->t->gettype()==2)
+				this->pending.push_back(static_cast<Ipe_Bazeir*>(cgc->t));
+		}
+	}
+	flattenpending();
+	return this->count-before;
+}
+
+int Ipe_Flattener::getcount()
+{
+	return this->count;
+}
+
+struct flatcell* Ipe_Flattener::get(int index)
+{
+	return &this->cells[index];
+}
+
+Ipe_Geometry* Ipe_Flattener::getoutput()
+{
+	return this->output;
+}
+
+Ipe_Lines* Ipe_Flattener::tolines(int index,Ipe_Geometry* store)
+{
+	struct flatcell* c=&this->cells[index];
+	Ipe_Lines* lines=new Ipe_Lines(store);
+	double* x=this->output->getx()+c->offset;
+	double* y=this->output->gety()+c->offset;
+	int* state=this->output->getstate()+c->offset;
+	for(int i=0;i<c->count;i++)
+		lines->addpoint(x[i],y[i],state[i]);
+	return lines;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "MuInclude.h"
+#include "Ipe_LinkList.h"
+#include "Ipe_Geometry.h"
+#include "Ipe_Bazeir.h"
+#include "Ipe_Lines.h"
+#include "Ipe_PdfElement.h"
+//߼Ӧչ:ҸݲɿƵĶײ(Wangʽ)ֱÿߵĵȷ,ݹϸ
+//һ߼ͳƵһη,չ洢,ʽֱ߼ͬ:ƶΪ0,ֱΪ1,պΪ2(Ϊ·)
+//ȷֵֵ֧AVX/SSE2ʱһĸ/,ǰ
+struct flatcell//һ߼еλ
+{
+	Ipe_Bazeir* bazeir;
+	int offset;//һ洢е±
+	int count;
+};
+
+class EX_PORT Ipe_Flattener
+{
+	double tolerance;//Ҹ,ҳ浥λ
+	Ipe_Geometry* output;
+	struct flatcell* cells;
+	int count;
+	int capacity;
+	std::vector<Ipe_Bazeir*> pending;//չһ߼,
+	int measure(Ipe_Bazeir* bazeir,int* segments);//߼չĵ,segmentsΪÿĵȷ,ΪNULL
+	void emit(Ipe_Bazeir* bazeir,const int* segments,int offset);//measureĵȷдoutput[offset,...)
+	void collect(Ipe_LinkList<Ipe_PdfElement>* list);
+	void flattenpending();
+public:
+	Ipe_Flattener(double tolerance=0.05);
+	~Ipe_Flattener(void);
+	void settolerance(double tolerance);
+	double gettolerance();
+	void clear();//,ռ
+	int flatten(Ipe_Bazeir* bazeir);//չһ߼׷ӵ,ڽе±
+	int flattenpage(class Ipe_PdfPage* page);//ҳ˳չҳ,ͼе߼,߼
+	int flattenview(class Ipe_PageView* view);//չͼе߼,߼
+	int getcount();
+	struct flatcell* get(int index);
+	Ipe_Geometry* getoutput();//x,y
+	Ipe_Lines* tolines(int index,Ipe_Geometry* store);//ѵindexΪstoreϵֱ߼
+	static int segments(const double* x,const double* y,double tolerance);//,Ƶյȷ,Ҹ߲tolerance
+	static void evaluate(const double* x,const double* y,int n,double* outx,double* outy);//t=1/n..1n,յ㾫ȷx[3],y[3]
+};
@@ -0,0 +1,133 @@
+#include "Ipe_Geometry.h"
+#include <stdlib.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#define IPE_GEOMETRY_AVX
+#elif defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#include <emmintrin.h>
+#define IPE_GEOMETRY_SSE2
+#endif
+
+Ipe_Geometry::Ipe_Geometry(void)
+{
+	this->x=NULL;
+	this->y=NULL;
+	this->state=NULL;
+	this->count=0;
+	this->capacity=0;
+}
+
+Ipe_Geometry::~Ipe_Geometry(void)
+{
+	free(this->x);
+	free(this->y);
+	free(this->state);
+}
+
+void Ipe_Geometry::reserve(int capacity)
+{
+	if(capacity<=this->capacity)
+		return;
+	this->x=(double*)realloc(this->x,capacity*sizeof(double));
+	this->y=(double*)realloc(this->y,capacity*sizeof(double));
+	this->state=(int*)realloc(this->state,capacity*sizeof(int));
+	this->capacity=capacity;
+}
+
+int Ipe_Geometry::append(double x,double y,int state)
+{
+	if(this->count==this->capacity)//,̯ÿֻƳ
+	{
+		reserve(this->capacity<64?64:this->capacity*2);
+	}
+	this->x[this->count]=x;
+	this->y[this->count]=y;
+	this->state[this->count]=state;
+	return this->count++;
+}
+
+int Ipe_Geometry::extend(int count)
+{
+	if(this->count+count>this->capacity)
+	{
+		int capacity=this->capacity<64?64:this->capacity*2;
+		if(capacity<this->count+count)
+			capacity=this->count+count;
+		reserve(capacity);
+	}
+	int begin=this->count;
+	this->count+=count;
+	return begin;
+}
+
+void Ipe_Geometry::clear()
+{
+	this->count=0;
+}
+
+int Ipe_Geometry::getcount()
+{
+	return this->count;
+}
+
+int Ipe_Geometry::getcapacity()
+{
+	return this->capacity;
+}
+
+double* Ipe_Geometry::getx()
+{
+	return this->x;
+}
+
+double* Ipe_Geometry::gety()
+{
+	return this->y;
+}
+
+int* Ipe_Geometry::getstate()
+{
+	return this->state;
+}
+
+size_t Ipe_Geometry::getmemsize()
+{
+	return sizeof(Ipe_Geometry)+(size_t)this->capacity*(2*sizeof(double)+sizeof(int));
+}
+
+void Ipe_Geometry::transform(int begin,int count,const fz_matrix& matrix)
+{
+	//x'=a*x+c*y+e y'=b*x+d*y+f,ȶԭx,yͬʱд
+	double a=matrix.a,b=matrix.b,c=matrix.c,d=matrix.d,e=matrix.e,f=matrix.f;
+	double* px=this->x+begin;
+	double* py=this->y+begin;
+	int i=0;
+#if defined(IPE_GEOMETRY_AVX)
+	__m256d va=_mm256_set1_pd(a),vb=_mm256_set1_pd(b),vc=_mm256_set1_pd(c);
+	__m256d vd=_mm256_set1_pd(d),ve=_mm256_set1_pd(e),vf=_mm256_set1_pd(f);
+	for(;i+4<=count;i+=4)//һδĸ
+	{
+		__m256d vx=_mm256_loadu_pd(px+i);
+		__m256d vy=_mm256_loadu_pd(py+i);
+		_mm256_storeu_pd(px+i,_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(va,vx),_mm256_mul_pd(vc,vy)),ve));
+		_mm256_storeu_pd(py+i,_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vb,vx),_mm256_mul_pd(vd,vy)),vf));
+	}
+#elif defined(IPE_GEOMETRY_SSE2)
+	__m128d va=_mm_set1_pd(a),vb=_mm_set1_pd(b),vc=_mm_set1_pd(c);
+	__m128d vd=_mm_set1_pd(d),ve=_mm_set1_pd(e),vf=_mm_set1_pd(f);
+	for(;i+2<=count;i+=2)//һδ
+	{
+		__m128d vx=_mm_loadu_pd(px+i);
+		__m128d vy=_mm_loadu_pd(py+i);
+		_mm_storeu_pd(px+i,_mm_add_pd(_mm_add_pd(_mm_mul_pd(va,vx),_mm_mul_pd(vc,vy)),ve));
+		_mm_storeu_pd(py+i,_mm_add_pd(_mm_add_pd(_mm_mul_pd(vb,vx),_mm_mul_pd(vd,vy)),vf));
+	}
+#endif
+	for(;i<count;i++)//ʣĵԼ֧SIMDʱ
+	{
+		double ox=px[i];
+		double oy=py[i];
+		px[i]=a*ox+c*oy+e;
+		py[i]=b*ox+d*oy+f;
+	}
+}
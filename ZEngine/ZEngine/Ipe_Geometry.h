@@ -0,0 +1,27 @@
+#pragma once
+#include "MuInclude.h"
+//ҳ漸δ洢:һҳ·,x,ystateֱΪ(SoA)
+//state 0-m 1-l 2-h 3-c -1-߼ռλ
+//ֱ߼,߼ֻ¼Լеʼλ,ٸԳе
+class EX_PORT Ipe_Geometry
+{
+	double* x;
+	double* y;
+	int* state;
+	int count;//Ѵŵĵ
+	int capacity;//
+public:
+	Ipe_Geometry(void);
+	~Ipe_Geometry(void);
+	int append(double x,double y,int state);//ĩβһ,±
+	int extend(int count);//ĩβcountδʼĵ,صһ±,ɵֱд
+	void reserve(int capacity);//Ԥռ,֮ӵ㲻·
+	void clear();//յ,ռ
+	int getcount();//
+	int getcapacity();
+	double* getx();//x,Ϊgetcount()
+	double* gety();//y
+	int* getstate();//
+	size_t getmemsize();//ռõڴ
+	void transform(int begin,int count,const fz_matrix& matrix);//[begin,begin+count)ĵ任
+};
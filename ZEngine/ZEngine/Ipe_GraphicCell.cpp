@@ -1,14 +1,45 @@
 #include "Ipe_GraphicCell.h"
 #include <string>
+#include <math.h>
 
 
 Ipe_GraphicCell::Ipe_GraphicCell(void)
 {
+	init(0,NULL);
 }
 
+Ipe_GraphicCell::Ipe_GraphicCell(Ipe_Geometry* store)
+{
+	init(0,store);
+}
+
+Ipe_GraphicCell::Ipe_GraphicCell(int type,Ipe_Geometry* store)
+{
+	init(type,store);
+}
+
+void Ipe_GraphicCell::init(int type,Ipe_Geometry* store)
+{
+	this->type=type;
+	if(store==NULL)//δĴ洢ʱԼһ
+	{
+		this->store=new Ipe_Geometry();
+		this->ownstore=true;
+	}
+	else
+	{
+		this->store=store;
+		this->ownstore=false;
+	}
+	this->offset=0;
+	this->count=0;
+	this->boundvalid=false;
+}
 
 Ipe_GraphicCell::~Ipe_GraphicCell(void)
 {
+	if(this->ownstore)
+		delete this->store;
 }
 
 /*void Ipe_GraphicCell:: printPoint()
@@ -16,3 +47,216 @@ Ipe_GraphicCell::~Ipe_GraphicCell(void)
 	printf("");
 }
 */
+
+void Ipe_GraphicCell::appendpoint(double x,double y,int state)
+{
+	if(this->count==0)
+	{
+		this->offset=store->append(x,y,state);
+		this->count=1;
+		this->boundvalid=false;
+		return;
+	}
+	if(this->offset+this->count!=store->getcount())//ͼڴ洢ĩβӹ,ȰѱͼĵᵽĩβԱ
+	{
+		int i,start;
+		store->reserve(store->getcount()+this->count+1);
+		start=store->getcount();
+		for(i=0;i<this->count;i++)
+		{
+			store->append(store->getx()[this->offset+i],store->gety()[this->offset+i],store->getstate()[this->offset+i]);
+		}
+		this->offset=start;
+	}
+	store->append(x,y,state);
+	this->count++;
+	this->boundvalid=false;
+}
+
+int Ipe_GraphicCell::GetPointCount()
+{
+	return this->count;
+}
+
+Ipe_Geometry* Ipe_GraphicCell::getstore()
+{
+	return this->store;
+}
+
+int Ipe_GraphicCell::getoffset()
+{
+	return this->offset;
+}
+
+Ipe_Point2D Ipe_GraphicCell::getpoint(int i)
+{
+	return Ipe_Point2D(store->getx()[offset+i],store->gety()[offset+i],store->getstate()[offset+i]);
+}
+
+double Ipe_GraphicCell::getx(int i)
+{
+	return store->getx()[offset+i];
+}
+
+double Ipe_GraphicCell::gety(int i)
+{
+	return store->gety()[offset+i];
+}
+
+int Ipe_GraphicCell::getstate(int i)
+{
+	return store->getstate()[offset+i];
+}
+
+void Ipe_GraphicCell::setpoint(int i,double x,double y)
+{
+	store->getx()[offset+i]=x;
+	store->gety()[offset+i]=y;
+	this->boundvalid=false;
+}
+
+void Ipe_GraphicCell::setstate(int i,int state)
+{
+	store->getstate()[offset+i]=state;
+	this->boundvalid=false;
+}
+
+void Ipe_GraphicCell::transform(const fz_matrix& matrix)
+{
+	this->boundvalid=false;
+	if(this->type==2)//߼,ÿƶ(Ͽ)ֻ任һ,߶α任
+	{
+		int* state=store->getstate()+this->offset;
+		int run=-1;//ǰ߶εĿʼ±
+		for(int i=0;i<this->count;i+=3)
+		{
+			if(state[i]==0)
+			{
+				if(run>=0)
+				{
+					store->transform(this->offset+run,i-run,matrix);
+					run=-1;
+				}
+				store->transform(this->offset+i,1,matrix);
+			}
+			else if(run<0)
+			{
+				run=i;
+			}
+		}
+		if(run>=0)
+			store->transform(this->offset+run,this->count-run,matrix);
+	}
+	else if(this->count>0)
+	{
+		store->transform(this->offset,this->count,matrix);
+	}
+}
+
+static void extendbound(double* box,double x,double y)
+{
+	if(x<box[0])
+		box[0]=x;
+	if(x>box[2])
+		box[2]=x;
+	if(y<box[1])
+		box[1]=y;
+	if(y>box[3])
+		box[3]=y;
+}
+
+static int curveextrema(double p0,double p1,double p2,double p3,double* t)//һϵΪ0(0,1)ڵĲ,ظ
+{
+	//B'(t)/3=a*t^2+b*t+c
+	double a=-p0+3*p1-3*p2+p3;
+	double b=2*(p0-2*p1+p2);
+	double c=p1-p0;
+	int n=0;
+	if(fabs(a)<1e-12)
+	{
+		if(fabs(b)>1e-12)
+			t[n++]=-c/b;
+	}
+	else
+	{
+		double d=b*b-4*a*c;
+		if(d>=0)
+		{
+			d=sqrt(d);
+			t[n++]=(-b+d)/(2*a);
+			t[n++]=(-b-d)/(2*a);
+		}
+	}
+	int m=0;
+	for(int i=0;i<n;i++)
+	{
+		if(t[i]>0&&t[i]<1)
+			t[m++]=t[i];
+	}
+	return m;
+}
+
+static double curvevalue(double p0,double p1,double p2,double p3,double t)
+{
+	double u=1-t;
+	return u*u*u*p0+3*u*u*t*p1+3*u*t*t*p2+t*t*t*p3;
+}
+
+bool Ipe_GraphicCell::computebound()
+{
+	double* x=store->getx()+this->offset;
+	double* y=store->gety()+this->offset;
+	int* state=store->getstate()+this->offset;
+	if(this->count==0)
+		return false;
+	this->bound[0]=this->bound[2]=x[0];
+	this->bound[1]=this->bound[3]=y[0];
+	if(this->type!=2)//ֱ߼ȡе
+	{
+		for(int i=1;i<this->count;i++)
+			extendbound(this->bound,x[i],y[i]);
+		return true;
+	}
+	//߼:ƶպϿֻеһЧ,߶ȡ˵뵼Ϊ㴦ĵ,Ƶ㱾һ
+	double cx=x[0],cy=y[0],bx=cx,by=cy;//ǰ·
+	double t[2];
+	for(int i=0;i+2<this->count;i+=3)
+	{
+		if(state[i]==0)
+		{
+			cx=bx=x[i];
+			cy=by=y[i];
+			extendbound(this->bound,cx,cy);
+			continue;
+		}
+		if(state[i]==2)//պ,ص·
+		{
+			cx=bx;
+			cy=by;
+			continue;
+		}
+		extendbound(this->bound,x[i+2],y[i+2]);
+		int n=curveextrema(cx,x[i],x[i+1],x[i+2],t);
+		for(int j=0;j<n;j++)
+			extendbound(this->bound,curvevalue(cx,x[i],x[i+1],x[i+2],t[j]),this->bound[1]);
+		n=curveextrema(cy,y[i],y[i+1],y[i+2],t);
+		for(int j=0;j<n;j++)
+			extendbound(this->bound,this->bound[0],curvevalue(cy,y[i],y[i+1],y[i+2],t[j]));
+		cx=x[i+2];
+		cy=y[i+2];
+	}
+	return true;
+}
+
+bool Ipe_GraphicCell::getbound(double* box)
+{
+	if(!this->boundvalid)
+	{
+		if(!computebound())
+			return false;
+		this->boundvalid=true;
+	}
+	for(int i=0;i<4;i++)
+		box[i]=this->bound[i];
+	return true;
+}
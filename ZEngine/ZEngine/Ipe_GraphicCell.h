@@ -1,16 +1,38 @@
 #pragma once
 #include<string>
-class Ipe_GraphicCell
+#include "MuInclude.h"
+#include "Ipe_Geometry.h"
+#include "Ipe_Point2D.h"
+//ֱ߼߼ĸ,ҳ漸δ洢һͼ
+class EX_PORT Ipe_GraphicCell
 {
-	int type;
+	int type;//ͱ
+	Ipe_Geometry* store;//ڵĴ洢,ҳڹ
+	bool ownstore;//δָ洢ʱԼ½һ,ʱͷ
+	int offset;//һڴ洢е±
+	int count;//
+	double bound[4];//İΧx0,y0,x1,y1,ıʱʧЧ
+	bool boundvalid;
+	bool computebound();
 public:
 	Ipe_GraphicCell(void);
-	~Ipe_GraphicCell(void);
-	virtual int gettype(){return 0;};//0- 1-ֱ߼ 2-߼
-	int GetPointCount();
+	Ipe_GraphicCell(Ipe_Geometry* store);//Ϊstoreϵͼ,storeΪNULLʱԼ
+	virtual ~Ipe_GraphicCell(void);
+	int gettype(){return type;};//0- 1-ֱ߼ 2-߼,๹ʱ,ɾݴֱstatic_cast
+	int GetPointCount();//ͼеĵ
 	virtual void printPoint(){printf("");};
-	//SPo_DPoint2D *GetPoint();
-private:
-	//vector<SPo_DPoint2D> m_pointarr;
+	Ipe_Geometry* getstore();
+	int getoffset();//ͼڴ洢е±,getstore()->getx()ֱӶȡ
+	Ipe_Point2D getpoint(int i);//i(0ʼ)
+	double getx(int i);
+	double gety(int i);
+	int getstate(int i);
+	void setpoint(int i,double x,double y);
+	void setstate(int i,int state);
+	void transform(const fz_matrix& matrix);//ͼеĵ任,߼ƶռλ㲻
+	bool getbound(double* box);//Χx0,y0,x1,y1,ȡֵǿƵ;һεʱ㲢,ûеʱfalse
+protected:
+	Ipe_GraphicCell(int type,Ipe_Geometry* store);//ʹ,ͱ
+	void init(int type,Ipe_Geometry* store);
+	void appendpoint(double x,double y,int state);//ͼĩβӵ
 };
-
@@ -1,23 +1,24 @@
 #include "Ipe_Lines.h"
 #include<stdio.h>
 
-Ipe_Lines::Ipe_Lines(void)
+Ipe_Lines::Ipe_Lines(void):Ipe_GraphicCell(1,NULL)
+{
+	num=0;
+}
+
+Ipe_Lines::Ipe_Lines(Ipe_Geometry* store):Ipe_GraphicCell(1,store)
 {
 	num=0;
-	list=new Ipe_LinkList<Ipe_Point2D>;
 }
 
 
 Ipe_Lines::~Ipe_Lines(void)
 {
-	delete list;
-	//printf("Ipe_Linesͷ\n");
 }
 
 int Ipe_Lines::addpoint(double x,double y,int state)
 {
-	Ipe_Point2D* point=new Ipe_Point2D(x,y,state);
-	list->add(point);
+	appendpoint(x,y,state);
 	num++;
 	//printf("%d:%f %f\n",num,x,y);
 	return 0;
@@ -25,7 +26,7 @@ int Ipe_Lines::addpoint(double x,double y,int state)
 
 int Ipe_Lines::addpoint(Ipe_Point2D* point)
 {
-	list->add(point);
+	appendpoint(point->getx(),point->gety(),point->getstate());
 	num++;
 	//printf("%d:%f %f\n",num,point->getx(),point->gety());
 	return 0;
@@ -35,13 +36,10 @@ void Ipe_Lines::printPoint()
 {
 	int i=0;
 	printf("ֱߵ㼯\n");
-	Ipe_node<Ipe_Point2D>* p=list->headler;
-	while(p->next!=NULL)
+	for(i=0;i<GetPointCount();i++)
 	{
-		i++;
-		printf("%d\n",i);
-		printf("%f %f\n",p->next->t->getx(),p->next->t->gety());
-		p=p->next;
+		printf("%d\n",i+1);
+		printf("%f %f\n",getx(i),gety(i));
 	}
 	//printf("ֱߵ㼯\n");
 }
@@ -56,7 +54,3 @@ void Ipe_Lines::setnum(int num)
 	this->num=num;
 }
 
-Ipe_LinkList<class Ipe_Point2D>* Ipe_Lines::getlist()
-{
-	return list;
-}
@@ -1,23 +1,20 @@
 #pragma once
 #include "ipe_graphiccell.h"
 #include "Ipe_Point2D.h"
-#include "Ipe_LinkList.h"
 #include "MuInclude.h"
-//ȫֱɵ·
+//ȫֱɵ·,ҳ漸δ洢
 class EX_PORT Ipe_Lines :
 	public Ipe_GraphicCell
 {
 	int num;//ֱ߼·
-	Ipe_LinkList<class Ipe_Point2D>* list;
 public:
 	Ipe_Lines(void);
+	Ipe_Lines(Ipe_Geometry* store);//ӵĴ洢
 	~Ipe_Lines(void);
 	int addpoint(double x,double y,int state);//ӵ,ʹò
-	int addpoint(Ipe_Point2D* point);//ӵ
+	int addpoint(Ipe_Point2D* point);//ӵ,ֻ״̬,point
 	virtual void printPoint();//ӡ
 	int getnum();//ֱߵ·
 	void setnum(int num);//ֱߵ·
-	Ipe_LinkList<class Ipe_Point2D>* getlist();//شֱߵϢָ
-	virtual int gettype(){return 1;};//0- 1-ֱ߼ 2-߼
 };
 
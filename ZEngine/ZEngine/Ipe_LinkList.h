@@ -25,6 +25,7 @@ public:
 	~Ipe_LinkList(void);
 	int add(T* t);//ṹ
 	void remove(int count);
+	void deleteall();//ͷдŵĶ,ڵ㱣
     int get(int pos, T &t);  
     double getLen(void);  
 };
@@ -88,6 +89,18 @@ void Ipe_LinkList<T>::remove(int count)
 	}
 }
 
+template <class T>
+void Ipe_LinkList<T>::deleteall()
+{
+	Ipe_node<T> *tmp=headler;
+	while(tmp->next!=NULL)
+	{
+		tmp=tmp->next;
+		delete tmp->t;
+		tmp->t=NULL;
+	}
+}
+
 template <class T>
 double Ipe_LinkList<T>::getLen(void)
 {
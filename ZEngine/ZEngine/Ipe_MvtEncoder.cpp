@@ -0,0 +1,220 @@
+#include "Ipe_MvtEncoder.h"
+#include <string.h>
+
+//protobuf߸ʽ:ֶͷΪ(ֶκ<<3)|,0Ϊvarint,1Ϊ64λ,2Ϊǰ׺
+static void writevarint(std::string& out,unsigned long long v)
+{
+	while(v>=0x80)
+	{
+		out+=(char)((v&0x7f)|0x80);
+		v>>=7;
+	}
+	out+=(char)v;
+}
+
+static void writekey(std::string& out,int field,int type)
+{
+	writevarint(out,(unsigned long long)((field<<3)|type));
+}
+
+static void writebytes(std::string& out,int field,const std::string& data)
+{
+	writekey(out,field,2);
+	writevarint(out,data.size());
+	out+=data;
+}
+
+static void writepacked(std::string& out,int field,const std::vector<unsigned int>& v)
+{
+	if(v.empty())
+		return;
+	std::string packed;
+	for(size_t i=0;i<v.size();i++)
+		writevarint(packed,v[i]);
+	writebytes(out,field,packed);
+}
+
+static unsigned int zigzag(int v)
+{
+	return (unsigned int)((v<<1)^(v>>31));
+}
+
+static unsigned int command(int id,int count)//MoveTo 1 LineTo 2 ClosePath 7
+{
+	return (unsigned int)((id&0x7)|(count<<3));
+}
+
+Ipe_MvtEncoder::Ipe_MvtEncoder(void)
+{
+	this->extent=4096;
+	this->featuretype=0;
+	this->featureid=0;
+	this->cursorx=0;
+	this->cursory=0;
+	this->featurecount=0;
+}
+
+Ipe_MvtEncoder::~Ipe_MvtEncoder(void)
+{
+}
+
+void Ipe_MvtEncoder::beginlayer(const char* name,int extent)
+{
+	this->layer.clear();
+	this->layername=name;
+	this->extent=extent;
+	this->keys.clear();
+	this->values.clear();
+	this->keyindex.clear();
+	this->valueindex.clear();
+	this->featurecount=0;
+}
+
+void Ipe_MvtEncoder::beginfeature(int type,unsigned long long id)
+{
+	this->featuretype=type;
+	this->featureid=id;
+	this->tags.clear();
+	this->geometry.clear();
+	this->cursorx=0;
+	this->cursory=0;
+}
+
+int Ipe_MvtEncoder::internkey(const char* key)
+{
+	std::map<std::string,int>::iterator it=this->keyindex.find(key);
+	if(it!=this->keyindex.end())
+		return it->second;
+	int index=(int)this->keys.size();
+	this->keys.push_back(key);
+	this->keyindex[key]=index;
+	return index;
+}
+
+int Ipe_MvtEncoder::internvalue(const std::string& value)
+{
+	std::map<std::string,int>::iterator it=this->valueindex.find(value);
+	if(it!=this->valueindex.end())
+		return it->second;
+	int index=(int)this->values.size();
+	this->values.push_back(value);
+	this->valueindex[value]=index;
+	return index;
+}
+
+void Ipe_MvtEncoder::addtag(const char* key,const char* value)
+{
+	std::string v;
+	writekey(v,1,2);//string_value
+	writevarint(v,strlen(value));
+	v+=value;
+	this->tags.push_back(internkey(key));
+	this->tags.push_back(internvalue(v));
+}
+
+void Ipe_MvtEncoder::addtag(const char* key,double value)
+{
+	std::string v;
+	unsigned long long bits;
+	memcpy(&bits,&value,sizeof(bits));
+	writekey(v,3,1);//double_value,С
+	for(int i=0;i<8;i++)
+		v+=(char)((bits>>(i*8))&0xff);
+	this->tags.push_back(internkey(key));
+	this->tags.push_back(internvalue(v));
+}
+
+void Ipe_MvtEncoder::addtag(const char* key,long long value)
+{
+	std::string v;
+	writekey(v,6,0);//sint_value
+	writevarint(v,(unsigned long long)((value<<1)^(value>>63)));
+	this->tags.push_back(internkey(key));
+	this->tags.push_back(internvalue(v));
+}
+
+void Ipe_MvtEncoder::addpath(const int* x,const int* y,int count,bool close)
+{
+	if(count<=0)
+		return;
+	this->geometry.push_back(command(1,1));
+	this->geometry.push_back(zigzag(x[0]-this->cursorx));
+	this->geometry.push_back(zigzag(y[0]-this->cursory));
+	this->cursorx=x[0];
+	this->cursory=y[0];
+	if(count>1)
+	{
+		this->geometry.push_back(command(2,count-1));
+		for(int i=1;i<count;i++)
+		{
+			this->geometry.push_back(zigzag(x[i]-this->cursorx));
+			this->geometry.push_back(zigzag(y[i]-this->cursory));
+			this->cursorx=x[i];
+			this->cursory=y[i];
+		}
+	}
+	if(close)
+		this->geometry.push_back(command(7,1));
+}
+
+bool Ipe_MvtEncoder::endfeature()
+{
+	if(this->geometry.empty())
+		return false;
+	std::string f;
+	if(this->featureid!=0)
+	{
+		writekey(f,1,0);
+		writevarint(f,this->featureid);
+	}
+	writepacked(f,2,this->tags);
+	writekey(f,3,0);
+	writevarint(f,this->featuretype);
+	writepacked(f,4,this->geometry);
+	writebytes(this->layer,2,f);
+	this->featurecount++;
+	return true;
+}
+
+void Ipe_MvtEncoder::endlayer()
+{
+	if(this->featurecount==0)
+		return;
+	std::string l;
+	writekey(l,15,0);//version
+	writevarint(l,2);
+	writekey(l,1,2);//name
+	writevarint(l,this->layername.size());
+	l+=this->layername;
+	l+=this->layer;
+	for(size_t i=0;i<this->keys.size();i++)
+	{
+		writekey(l,3,2);
+		writevarint(l,this->keys[i].size());
+		l+=this->keys[i];
+	}
+	for(size_t i=0;i<this->values.size();i++)
+		writebytes(l,4,this->values[i]);
+	writekey(l,5,0);//extent
+	writevarint(l,this->extent);
+	writebytes(this->tile,3,l);
+	this->layer.clear();
+	this->featurecount=0;
+}
+
+int Ipe_MvtEncoder::getfeaturecount()
+{
+	return this->featurecount;
+}
+
+const std::string& Ipe_MvtEncoder::getdata()
+{
+	return this->tile;
+}
+
+void Ipe_MvtEncoder::clear()
+{
+	this->tile.clear();
+	this->layer.clear();
+	this->featurecount=0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "MuInclude.h"
+//Mapbox Vector Tile 2.1protobuf,protobuf
+//÷:beginlayer,ȻÿҪbeginfeature,addtag,addpath,endfeature,endlayer;getdataȡƬ
+#define IPE_MVT_POINT 1
+#define IPE_MVT_LINESTRING 2
+#define IPE_MVT_POLYGON 3
+class EX_PORT Ipe_MvtEncoder
+{
+	std::string tile;//ɵͼ
+	std::string layer;//ǰͼɵҪ
+	std::string layername;
+	int extent;
+	std::vector<std::string> keys;
+	std::vector<std::string> values;//ѱValueϢ
+	std::map<std::string,int> keyindex;//ֵȥ
+	std::map<std::string,int> valueindex;
+	int featuretype;
+	unsigned long long featureid;
+	std::vector<unsigned int> tags;
+	std::vector<unsigned int> geometry;//
+	int cursorx;//ĲһĲֵ,һҪ
+	int cursory;
+	int featurecount;
+	int internkey(const char* key);
+	int internvalue(const std::string& value);
+public:
+	Ipe_MvtEncoder(void);
+	~Ipe_MvtEncoder(void);
+	void beginlayer(const char* name,int extent=4096);
+	void beginfeature(int type,unsigned long long id=0);//typeΪIPE_MVT_*,idΪ0ʱ
+	void addtag(const char* key,const char* value);
+	void addtag(const char* key,double value);
+	void addtag(const char* key,long long value);
+	void addpath(const int* x,const int* y,int count,bool close);//һ·,ΪƬڵ,closeʱClosePath(Ļ)
+	bool endfeature();//ûмεҪر,Ƿд
+	void endlayer();//ûҪصͼ㲻
+	int getfeaturecount();//ǰͼдҪ
+	const std::string& getdata();
+	void clear();
+};
@@ -0,0 +1,135 @@
+#include "Ipe_PageCache.h"
+
+
+Ipe_PageCache::Ipe_PageCache(size_t memlimit,int pagelimit)
+{
+	this->memlimit=memlimit;
+	this->pagelimit=pagelimit;
+	this->memused=0;
+}
+
+
+Ipe_PageCache::~Ipe_PageCache(void)
+{
+	clear();
+}
+
+Ipe_PdfPage* Ipe_PageCache::find(int number)
+{
+	std::list<entry>::iterator it;
+	for(it=lru.begin();it!=lru.end();++it)
+	{
+		if(it->number==number)
+		{
+			if(it!=lru.begin())
+				lru.splice(lru.begin(),lru,it);//Ƶͷ
+			return it->page;
+		}
+	}
+	return NULL;
+}
+
+void Ipe_PageCache::insert(int number,Ipe_PdfPage* page)
+{
+	entry e;
+	e.number=number;
+	e.page=page;
+	e.size=page->getmemsize();
+	e.pins=0;
+	lru.push_front(e);
+	memused+=e.size;
+	evict();
+}
+
+void Ipe_PageCache::evict()
+{
+	std::list<entry>::iterator it=lru.end();
+	while(lru.size()>1)//ӱβǰ̭,ͷΪշȡõҳ,ʼձ
+	{
+		bool overmem=memlimit!=0&&memused>memlimit;
+		bool overcount=pagelimit>0&&(int)lru.size()>pagelimit;
+		if(!overmem&&!overcount)
+			break;
+		--it;
+		if(it==lru.begin())//ҳ
+			break;
+		if(it->pins>0)
+			continue;
+		memused-=it->size;
+		delete it->page;
+		it=lru.erase(it);
+	}
+}
+
+bool Ipe_PageCache::pin(int number)
+{
+	std::list<entry>::iterator it;
+	for(it=lru.begin();it!=lru.end();++it)
+	{
+		if(it->number==number)
+		{
+			it->pins++;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Ipe_PageCache::unpin(int number)
+{
+	std::list<entry>::iterator it;
+	for(it=lru.begin();it!=lru.end();++it)
+	{
+		if(it->number==number)
+		{
+			if(it->pins>0)
+				it->pins--;
+			break;
+		}
+	}
+	evict();
+}
+
+Ipe_PdfPage* Ipe_PageCache::take(int number)
+{
+	std::list<entry>::iterator it;
+	for(it=lru.begin();it!=lru.end();++it)
+	{
+		if(it->number==number)
+		{
+			Ipe_PdfPage* page=it->page;
+			memused-=it->size;
+			lru.erase(it);
+			return page;
+		}
+	}
+	return NULL;
+}
+
+void Ipe_PageCache::setlimit(size_t memlimit,int pagelimit)
+{
+	this->memlimit=memlimit;
+	this->pagelimit=pagelimit;
+	evict();
+}
+
+void Ipe_PageCache::clear()
+{
+	std::list<entry>::iterator it;
+	for(it=lru.begin();it!=lru.end();++it)
+	{
+		delete it->page;
+	}
+	lru.clear();
+	memused=0;
+}
+
+size_t Ipe_PageCache::getmemused()
+{
+	return memused;
+}
+
+int Ipe_PageCache::getcount()
+{
+	return (int)lru.size();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <list>
+#include "Ipe_PdfPage.h"
+//ʹ̭ҳ滺,ͬʱڴҳ
+//ҳ,̭ҳᱻͷ;һȡõҳͱҳ治ᱻ̭
+class Ipe_PageCache
+{
+	struct entry
+	{
+		int number;//ҳ
+		Ipe_PdfPage* page;
+		size_t size;//ڴС
+		int pins;//,0ʱ̭
+	};
+	std::list<entry> lru;//ͷΪʹõҳ
+	size_t memlimit;//ڴ,0ʾ
+	int pagelimit;//ҳ,0ʾ
+	size_t memused;
+	void evict();//̭βҳ
+public:
+	Ipe_PageCache(size_t memlimit,int pagelimit);
+	~Ipe_PageCache(void);
+	Ipe_PdfPage* find(int number);//ʱƵͷ,δзNULL
+	void insert(int number,Ipe_PdfPage* page);//ͷ̭
+	bool pin(int number);//еҳ,ҳ治ڻʱfalse
+	void unpin(int number);//һ,漴̭
+	Ipe_PdfPage* take(int number);//ӻƳҳ浫ͷ,Ȩ,ڻзNULL
+	void setlimit(size_t memlimit,int pagelimit);
+	void clear();
+	size_t getmemused();
+	int getcount();
+};
@@ -0,0 +1,390 @@
+#include "Ipe_PageIndex.h"
+#include "Ipe_PdfPage.h"
+#include "Ipe_PdfStack.h"
+#include "Ipe_PdfPath.h"
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <queue>
+
+#define IPE_INDEX_CURVESTEPS 16//ʱÿϸֵĶ
+
+struct centerless//Χĵxy
+{
+	struct indexitem* items;
+	int axis;
+	bool operator()(int a,int b) const
+	{
+		return items[a].box[axis]+items[a].box[axis+2]<items[b].box[axis]+items[b].box[axis+2];
+	}
+};
+
+struct nearentry//ڲѯȶ,levelΪ-1ʱnodeΪ±,dΪʵʾ
+{
+	double d;
+	int level;
+	int node;
+	bool operator<(const nearentry& other) const
+	{
+		return d>other.d;//priority_queueΪ󶥶,ȡõСڶ
+	}
+};
+
+Ipe_PageIndex::Ipe_PageIndex(Ipe_PdfPage* page)
+{
+	this->items=NULL;
+	this->count=0;
+	this->capacity=0;
+	this->order=NULL;
+	this->boxes=NULL;
+	this->levels=NULL;
+	this->levelcount=0;
+	double box[4];
+	Ipe_node<Ipe_PdfElement>* current=page->getelement()->headler;
+	while(current->next!=NULL)//ջ
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		if(stack->getxobject()!=0)//ʵķΧΪݵİΧоʵ任,ձ
+		{
+			if(page->getinstancebound(stack,box))
+				add(stack,NULL,NULL,NULL,box);
+		}
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)//ջ·
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)//ͼҪ
+			{
+				cplane=cplane->next;
+				Ipe_Plane* plane=cplane->t;
+				if(plane->getisplane())
+				{
+					if(plane->getbound(box))
+						add(stack,pathlist->t,plane,NULL,box);
+					continue;
+				}
+				Ipe_node<Ipe_GraphicCell>* cgc=plane->getlist()->headler;
+				while(cgc->next!=NULL)//ֱ߼߼
+				{
+					cgc=cgc->next;
+					if(cgc->t->getbound(box))
+						add(stack,pathlist->t,plane,cgc->t,box);
+				}
+			}
+		}
+	}
+	build();
+}
+
+Ipe_PageIndex::~Ipe_PageIndex(void)
+{
+	free(this->items);
+	free(this->order);
+	free(this->boxes);
+	free(this->levels);
+}
+
+void Ipe_PageIndex::add(Ipe_PdfStack* stack,Ipe_PdfPath* path,Ipe_Plane* plane,Ipe_GraphicCell* cell,const double* box)
+{
+	if(this->count==this->capacity)
+	{
+		this->capacity=this->capacity==0?256:this->capacity*2;
+		this->items=(struct indexitem*)realloc(this->items,this->capacity*sizeof(struct indexitem));
+	}
+	struct indexitem* e=&this->items[this->count++];
+	for(int i=0;i<4;i++)
+		e->box[i]=box[i];
+	e->stack=stack;
+	e->path=path;
+	e->plane=plane;
+	e->cell=cell;
+}
+
+void Ipe_PageIndex::build()
+{
+	int n=this->count,i,k;
+	if(n==0)
+		return;
+	this->order=(int*)malloc(n*sizeof(int));
+	for(i=0;i<n;i++)
+		this->order[i]=i;
+	//STR:ȰxΪS,ÿٰy,IPE_INDEX_NODESIZEΪһҶӽڵ
+	int leaves=(n+IPE_INDEX_NODESIZE-1)/IPE_INDEX_NODESIZE;
+	int slices=(int)ceil(sqrt((double)leaves));
+	int slicesize=slices*IPE_INDEX_NODESIZE;
+	centerless less;
+	less.items=this->items;
+	less.axis=0;
+	std::sort(this->order,this->order+n,less);
+	less.axis=1;
+	for(i=0;i<n;i+=slicesize)
+		std::sort(this->order+i,this->order+(i+slicesize<n?i+slicesize:n),less);
+	//ڵ,ҶӲ㼴n
+	int total=0;
+	this->levelcount=0;
+	for(k=n;;k=(k+IPE_INDEX_NODESIZE-1)/IPE_INDEX_NODESIZE)
+	{
+		total+=k;
+		this->levelcount++;
+		if(k==1)
+			break;
+	}
+	this->levels=(int*)malloc((this->levelcount+1)*sizeof(int));
+	this->boxes=(double*)malloc(total*4*sizeof(double));
+	this->levels[0]=0;
+	for(i=0;i<n;i++)
+	{
+		for(k=0;k<4;k++)
+			this->boxes[i*4+k]=this->items[this->order[i]].box[k];
+	}
+	int size=n;
+	for(int level=1;level<this->levelcount;level++)//ϲ㰴˳²ڵ
+	{
+		int begin=this->levels[level-1];
+		int parent=begin+size;
+		this->levels[level]=parent;
+		for(i=0;i<size;i++)
+		{
+			double* child=this->boxes+(begin+i)*4;
+			double* box=this->boxes+(parent+i/IPE_INDEX_NODESIZE)*4;
+			if(i%IPE_INDEX_NODESIZE==0)
+			{
+				for(k=0;k<4;k++)
+					box[k]=child[k];
+				continue;
+			}
+			if(child[0]<box[0])
+				box[0]=child[0];
+			if(child[1]<box[1])
+				box[1]=child[1];
+			if(child[2]>box[2])
+				box[2]=child[2];
+			if(child[3]>box[3])
+				box[3]=child[3];
+		}
+		size=(size+IPE_INDEX_NODESIZE-1)/IPE_INDEX_NODESIZE;
+	}
+	this->levels[this->levelcount]=total;
+}
+
+int Ipe_PageIndex::getcount()
+{
+	return this->count;
+}
+
+struct indexitem* Ipe_PageIndex::get(int index)
+{
+	return &this->items[index];
+}
+
+void Ipe_PageIndex::search(double x0,double y0,double x1,double y1,std::vector<int>& result)
+{
+	result.clear();
+	if(this->count==0)
+		return;
+	std::vector<int> stack;//ʵĽڵ,ÿΪڵboxesе±
+	stack.push_back(this->levelcount-1);
+	stack.push_back(this->levels[this->levelcount-1]);
+	while(!stack.empty())
+	{
+		int node=stack.back();
+		stack.pop_back();
+		int level=stack.back();
+		stack.pop_back();
+		double* box=this->boxes+node*4;
+		if(box[0]>x1||box[2]<x0||box[1]>y1||box[3]<y0)
+			continue;
+		if(level==0)
+		{
+			result.push_back(this->order[node]);
+			continue;
+		}
+		int first=(node-this->levels[level])*IPE_INDEX_NODESIZE;
+		int size=this->levels[level]-this->levels[level-1];
+		int last=first+IPE_INDEX_NODESIZE<size?first+IPE_INDEX_NODESIZE:size;
+		for(int c=first;c<last;c++)
+		{
+			stack.push_back(level-1);
+			stack.push_back(this->levels[level-1]+c);
+		}
+	}
+	std::sort(result.begin(),result.end());//ָҳ˳
+}
+
+void Ipe_PageIndex::searchpoint(double x,double y,double tolerance,std::vector<int>& result)
+{
+	search(x-tolerance,y-tolerance,x+tolerance,y+tolerance,result);
+}
+
+static double boxdistance(const double* box,double x,double y)
+{
+	double dx=x<box[0]?box[0]-x:(x>box[2]?x-box[2]:0);
+	double dy=y<box[1]?box[1]-y:(y>box[3]?y-box[3]:0);
+	return sqrt(dx*dx+dy*dy);
+}
+
+static double segmentdistance(double x,double y,double x0,double y0,double x1,double y1)
+{
+	double dx=x1-x0,dy=y1-y0;
+	double len=dx*dx+dy*dy;
+	double t=len>0?((x-x0)*dx+(y-y0)*dy)/len:0;
+	if(t<0)
+		t=0;
+	else if(t>1)
+		t=1;
+	dx=x0+t*dx-x;
+	dy=y0+t*dy-y;
+	return sqrt(dx*dx+dy*dy);
+}
+
+static double celldistance(Ipe_GraphicCell* cell,double x,double y)//㵽ֱ߼߼ľ,ĽSVGʱͬ
+{
+	double best=DBL_MAX,d;
+	double cx=0,cy=0,bx=0,by=0;//ǰ·
+	int count=cell->GetPointCount();
+	if(cell->gettype()==1)
+	{
+		for(int i=0;i<count;i++)
+		{
+			double px=cell->getx(i),py=cell->gety(i);
+			int state=cell->getstate(i);
+			if(state==2)//պ,ص
+			{
+				px=bx;
+				py=by;
+			}
+			if(i==0||state==0)
+			{
+				bx=px;
+				by=py;
+				d=sqrt((px-x)*(px-x)+(py-y)*(py-y));
+			}
+			else
+			{
+				d=segmentdistance(x,y,cx,cy,px,py);
+			}
+			if(d<best)
+				best=d;
+			cx=px;
+			cy=py;
+		}
+		return best;
+	}
+	for(int i=0;i+2<count;i+=3)
+	{
+		int state=cell->getstate(i);
+		if(i==0||state==0)//ƶ
+		{
+			cx=bx=cell->getx(i);
+			cy=by=cell->gety(i);
+			d=sqrt((cx-x)*(cx-x)+(cy-y)*(cy-y));
+		}
+		else if(state==2)//պϿ
+		{
+			d=segmentdistance(x,y,cx,cy,bx,by);
+			cx=bx;
+			cy=by;
+		}
+		else//߶ΰȷΪ
+		{
+			double x0=cx,y0=cy;
+			double x1=cell->getx(i),y1=cell->gety(i);
+			double x2=cell->getx(i+1),y2=cell->gety(i+1);
+			double x3=cell->getx(i+2),y3=cell->gety(i+2);
+			d=DBL_MAX;
+			for(int s=1;s<=IPE_INDEX_CURVESTEPS;s++)
+			{
+				double t=(double)s/IPE_INDEX_CURVESTEPS,u=1-t;
+				double px=u*u*u*x0+3*u*u*t*x1+3*u*t*t*x2+t*t*t*x3;
+				double py=u*u*u*y0+3*u*u*t*y1+3*u*t*t*y2+t*t*t*y3;
+				double sd=segmentdistance(x,y,cx,cy,px,py);
+				if(sd<d)
+					d=sd;
+				cx=px;
+				cy=py;
+			}
+		}
+		if(d<best)
+			best=d;
+	}
+	return best;
+}
+
+double Ipe_PageIndex::distance(int index,double x,double y)
+{
+	struct indexitem* e=&this->items[index];
+	if(e->plane==NULL)
+		return DBL_MAX;
+	if(e->cell!=NULL)
+		return celldistance(e->cell,x,y);
+	double best=DBL_MAX;
+	Ipe_node<Ipe_GraphicCell>* cgc=e->plane->getlist()->headler;
+	while(cgc->next!=NULL)
+	{
+		cgc=cgc->next;
+		double d=celldistance(cgc->t,x,y);
+		if(d<best)
+			best=d;
+	}
+	return best;
+}
+
+int Ipe_PageIndex::nearest(double x,double y,double* distance)
+{
+	if(this->count==0)
+		return -1;
+	std::priority_queue<nearentry> queue;//½Сչ,ȳӵʵʾ뼴Ϊ
+	nearentry e;
+	e.level=this->levelcount-1;
+	e.node=this->levels[e.level];
+	e.d=boxdistance(this->boxes+e.node*4,x,y);
+	queue.push(e);
+	while(!queue.empty())
+	{
+		nearentry top=queue.top();
+		queue.pop();
+		if(top.level<0)
+		{
+			if(top.d==DBL_MAX)
+				break;
+			if(distance!=NULL)
+				*distance=top.d;
+			return top.node;
+		}
+		if(top.level==0)
+		{
+			int item=this->order[top.node];
+			if(this->items[item].plane==NULL)//ʵû·
+				continue;
+			e.level=-1;
+			e.node=item;
+			e.d=this->distance(item,x,y);
+			queue.push(e);
+			continue;
+		}
+		int first=(top.node-this->levels[top.level])*IPE_INDEX_NODESIZE;
+		int size=this->levels[top.level]-this->levels[top.level-1];
+		int last=first+IPE_INDEX_NODESIZE<size?first+IPE_INDEX_NODESIZE:size;
+		for(int c=first;c<last;c++)
+		{
+			e.level=top.level-1;
+			e.node=this->levels[e.level]+c;
+			e.d=boxdistance(this->boxes+e.node*4,x,y);
+			queue.push(e);
+		}
+	}
+	return -1;
+}
+
+size_t Ipe_PageIndex::getmemsize()
+{
+	size_t size=sizeof(Ipe_PageIndex)+this->capacity*sizeof(struct indexitem)+this->count*sizeof(int)+(this->levelcount+1)*sizeof(int);
+	if(this->levelcount>0)
+		size+=this->levels[this->levelcount]*4*sizeof(double);
+	return size;
+}
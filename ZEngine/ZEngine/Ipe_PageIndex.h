@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include "MuInclude.h"
+#include "Ipe_GraphicCell.h"
+#include "Ipe_Plane.h"
+#include "clipfunction.h"
+#define IPE_INDEX_NODESIZE 16//ÿڵӽڵ
+//ҳҪصĴR:STR(Sort-Tile-Recursive)ҶӺԵ,úֻ,Զ߳ͬʱѯ
+//ǷҪصÿֱ߼߼Ϊһ,յΪһ(ڴڲʱҲҪ)
+//ѯΪ±,ҳ˳,ͬһҪص
+struct indexitem
+{
+	double box[4];//x0,y0,x1,y1
+	class Ipe_PdfStack* stack;
+	class Ipe_PdfPath* path;
+	Ipe_Plane* plane;
+	Ipe_GraphicCell* cell;//ǷҪصһֱ߼߼,յΪNULL
+};
+
+class EX_PORT Ipe_PageIndex
+{
+	struct indexitem* items;//ҳ˳
+	int count;
+	int capacity;
+	int* order;//ҶӲiλöӦ
+	double* boxes;//нڵİΧ,ÿ4ֵ,ҶӲǰ,֮,һΪ
+	int* levels;//ÿһڵboxesе±,levels[levelcount]Ϊڵ
+	int levelcount;
+	void add(class Ipe_PdfStack* stack,class Ipe_PdfPath* path,Ipe_Plane* plane,Ipe_GraphicCell* cell,const double* box);
+	void build();
+public:
+	Ipe_PageIndex(class Ipe_PdfPage* page);//ҳȡÿİΧв
+	~Ipe_PageIndex(void);
+	int getcount();
+	struct indexitem* get(int index);
+	void search(double x0,double y0,double x1,double y1,std::vector<int>& result);//ڲѯ,ΪΧ봰ཻ
+	void searchpoint(double x,double y,double tolerance,std::vector<int>& result);//ѯ,ΪΧеľ벻tolerance
+	int nearest(double x,double y,double* distance=NULL);//ڲѯ,·ʵʾ(ȡϸֺ),ûʱ-1
+	double distance(int index,double x,double y);//㵽һ·ľ,Ϊ߽ľ
+	size_t getmemsize();
+};
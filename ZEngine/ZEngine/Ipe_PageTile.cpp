@@ -0,0 +1,46 @@
+#include "Ipe_PageTile.h"
+#include "Ipe_PdfStack.h"
+#include "Ipe_PdfPath.h"
+#include <stdlib.h>
+
+Ipe_PageTile::Ipe_PageTile(Ipe_PdfPage* page,cliprect* rect)
+	:Ipe_PageView(page,NULL)
+{
+	this->haswindow=true;
+	this->window=*rect;
+	this->inside=NULL;
+	this->insidecapacity=0;
+	this->clipped=false;
+}
+
+Ipe_PageTile::~Ipe_PageTile(void)
+{
+	free(this->inside);
+}
+
+void Ipe_PageTile::add(Ipe_PdfStack* stack,Ipe_PdfPath* path,Ipe_Plane* plane,bool inside)
+{
+	if(this->count==this->insidecapacity)
+	{
+		this->insidecapacity=this->insidecapacity==0?16:this->insidecapacity*2;
+		this->inside=(bool*)realloc(this->inside,this->insidecapacity*sizeof(bool));
+	}
+	this->inside[this->count]=plane==NULL||inside;
+	Ipe_PageView::add(stack,path,plane,plane!=NULL?plane->getlist():NULL,false);//ҳ,Ҫü滻
+}
+
+void Ipe_PageTile::cliprouted(clipbuffer* buffer)
+{
+	if(this->clipped)
+		return;
+	this->clipped=true;
+	clipplanes(&this->window,this->inside,buffer);
+	free(this->inside);
+	this->inside=NULL;
+	this->insidecapacity=0;
+}
+
+cliprect Ipe_PageTile::getrect()
+{
+	return this->window;
+}
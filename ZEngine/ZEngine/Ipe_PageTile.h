@@ -0,0 +1,17 @@
+#pragma once
+#include "Ipe_PageView.h"
+//һüһڵͼ:ҳʱѰΧ봰ཻĵͼҪ·ɽ,֮ڶü
+class EX_PORT Ipe_PageTile :
+	public Ipe_PageView
+{
+	bool* inside;//ҪضӦ,Χȫڴ,زü
+	int insidecapacity;
+	bool clipped;
+protected:
+	~Ipe_PageTile(void);
+public:
+	Ipe_PageTile(class Ipe_PdfPage* page,cliprect* rect);
+	void add(class Ipe_PdfStack* stack,class Ipe_PdfPath* path,Ipe_Plane* plane,bool inside);//·ɽ׶μһҪ,planeΪNULLʱʵ
+	void cliprouted(clipbuffer* buffer);//ü·ɽҪ,bufferΪ̵߳ü,ֻ֮ҳ
+	cliprect getrect();
+};
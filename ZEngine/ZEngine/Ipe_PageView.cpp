@@ -0,0 +1,559 @@
+#include "Ipe_PageView.h"
+#include "Ipe_PdfPage.h"
+#include "Ipe_PdfStack.h"
+#include "Ipe_PdfPath.h"
+#include "Ipe_PdfXobject.h"
+#include "Ipe_Thread.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+Ipe_PageView::Ipe_PageView(Ipe_PdfPage* page)
+{
+	this->refs=1;
+	this->page=page;
+	this->parent=NULL;
+	this->geometry=new Ipe_Geometry();
+	this->planes=NULL;
+	this->count=0;
+	this->capacity=0;
+	this->haswindow=false;
+	Ipe_node<Ipe_PdfElement>* current=page->getelement()->headler;
+	while(current->next!=NULL)//ջ
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		if(stack->getxobject()!=0)//ʵûԼĵ
+			add(stack,NULL,NULL,NULL,false);
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)//ջ·
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)//ͼҪ
+			{
+				cplane=cplane->next;
+				add(stack,pathlist->t,cplane->t,cplane->t->getlist(),false);
+			}
+		}
+	}
+}
+
+Ipe_PageView::Ipe_PageView(Ipe_PdfPage* page,Ipe_PageView* parent)
+{
+	this->refs=1;
+	this->page=page;
+	this->parent=parent;
+	if(parent!=NULL)
+		parent->retain();
+	this->geometry=new Ipe_Geometry();
+	this->planes=NULL;
+	this->count=0;
+	this->capacity=0;
+	this->haswindow=false;
+}
+
+Ipe_PageView::~Ipe_PageView(void)
+{
+	for(int i=0;i<this->count;i++)
+	{
+		if(this->planes[i].owncells)
+		{
+			this->planes[i].cells->deleteall();
+			delete this->planes[i].cells;
+		}
+	}
+	free(this->planes);
+	delete this->geometry;//ͼȫͷ
+	if(this->parent!=NULL)
+		this->parent->release();
+}
+
+void Ipe_PageView::retain()
+{
+	this->refs++;
+}
+
+void Ipe_PageView::release()
+{
+	if(--this->refs==0)
+		delete this;
+}
+
+void Ipe_PageView::add(Ipe_PdfStack* stack,Ipe_PdfPath* path,Ipe_Plane* plane,Ipe_LinkList<Ipe_GraphicCell>* cells,bool owncells,int order)
+{
+	if(this->count==this->capacity)
+	{
+		this->capacity=this->capacity==0?16:this->capacity*2;
+		this->planes=(struct viewplane*)realloc(this->planes,this->capacity*sizeof(struct viewplane));
+	}
+	struct viewplane* e=&this->planes[this->count++];
+	e->stack=stack;
+	e->path=path;
+	e->plane=plane;
+	e->owncells=owncells;
+	e->cells=cells;
+	e->order=order;
+}
+
+static Ipe_LinkList<Ipe_GraphicCell>* clipcells(Ipe_LinkList<Ipe_GraphicCell>* list,cliprect* rect,Ipe_Geometry* store)//ǷҪüֱ߼߼,ȥȫڴ
+{
+	Ipe_LinkList<Ipe_GraphicCell>* result=new Ipe_LinkList<Ipe_GraphicCell>();
+	Ipe_node<Ipe_GraphicCell>* cgc=list->headler;
+	while(cgc->next!=NULL)
+	{
+		cgc=cgc->next;
+		if(cgc->t->gettype()==1)//1-ֱ߼
+		{
+			Ipe_Lines* lines=cliplines(static_cast<Ipe_Lines*>(cgc->t),rect,store);
+			if(lines->getnum()>0)
+				result->add(lines);
+			else
+				delete lines;
+		}
+		else if(cgc->t->gettype()==2)//2-߼
+		{
+			Ipe_Bazeir* bazeir=clipbazeir(static_cast<Ipe_Bazeir*>(cgc->t),rect,store);
+			if(bazeir->getnum()>0)
+				result->add(bazeir);
+			else
+				delete bazeir;
+		}
+	}
+	return result;
+}
+
+void Ipe_PageView::clipplanes(cliprect* rect,const bool* inside,clipbuffer* buffer)
+{
+	int n=0;
+	for(int i=0;i<this->count;i++)
+	{
+		struct viewplane e=this->planes[i];
+		if(e.plane!=NULL&&!inside[i])
+		{
+			Ipe_LinkList<Ipe_GraphicCell>* cells;
+			if(e.plane->getisplane())
+				cells=clipplane(e.cells,rect,this->geometry,buffer);
+			else
+				cells=clipcells(e.cells,rect,this->geometry);
+			if(e.owncells)
+			{
+				e.cells->deleteall();
+				delete e.cells;
+			}
+			e.cells=cells;
+			e.owncells=true;
+			if(cells->headler->next==NULL)//봰ֻǰΧཻ
+			{
+				delete cells;
+				continue;
+			}
+		}
+		this->planes[n++]=e;
+	}
+	this->count=n;
+}
+
+Ipe_PageView* Ipe_PageView::clip(cliprect* rect,clipbuffer* buffer)
+{
+	if(rect->x0>rect->x1||rect->y0<rect->y1)
+	{
+		printf("βϱ׼");
+		return NULL;
+	}
+	Ipe_PageView* view=new Ipe_PageView(this->page,this);
+	view->haswindow=true;
+	view->window=*rect;
+	if(this->haswindow)//βüĴȡ
+	{
+		cliprect* w=&view->window;
+		if(this->window.x0>w->x0)
+			w->x0=this->window.x0;
+		if(this->window.x1<w->x1)
+			w->x1=this->window.x1;
+		if(this->window.y0<w->y0)
+			w->y0=this->window.y0;
+		if(this->window.y1>w->y1)
+			w->y1=this->window.y1;
+	}
+	bool* inside=(bool*)malloc((this->count>0?this->count:1)*sizeof(bool));
+	for(int i=0;i<this->count;i++)
+	{
+		struct viewplane* e=&this->planes[i];
+		double box[4];
+		if(e->plane==NULL)//ʵ任İΧɸѡ,ʱviewBoxȡ
+		{
+			if(!this->page->getinstancebound(e->stack,box)||!boxoverlap(box,rect))
+				continue;
+			inside[view->count]=true;
+			view->add(e->stack,NULL,NULL,NULL,false);
+			continue;
+		}
+		bool bounded=e->owncells?cellsbound(e->cells,box):e->plane->getbound(box);//δıҪֱȡҳ滺İΧ
+		if(!bounded||!boxoverlap(box,rect))
+			continue;
+		inside[view->count]=boxinside(box,rect);
+		view->add(e->stack,e->path,e->plane,e->cells,false,e->order);//һ,Ҫü滻
+	}
+	clipbuffer local;
+	if(buffer==NULL)
+	{
+		initclipbuffer(&local);
+		buffer=&local;
+	}
+	view->clipplanes(rect,inside,buffer);
+	if(buffer==&local)
+		freeclipbuffer(&local);
+	free(inside);
+	return view;
+}
+
+Ipe_PageView* Ipe_PageView::transform(const fz_matrix& matrix)
+{
+	Ipe_PageView* view=new Ipe_PageView(this->page,this);//ڲ
+	std::vector<int> chain;
+	for(int i=0;i<this->count;i++)
+	{
+		struct viewplane* e=&this->planes[i];
+		if(e->plane==NULL)//<use>ֻʵ,ʵչ,ʵ֮پͼľ
+		{
+			int order=0;
+			view->expandform(e->stack,e->stack->getxobject(),fz_concat(e->stack->getmatrix(),matrix),chain,order);
+			continue;
+		}
+		Ipe_LinkList<Ipe_GraphicCell>* cells=new Ipe_LinkList<Ipe_GraphicCell>();
+		Ipe_node<Ipe_GraphicCell>* cgc=e->cells->headler;
+		while(cgc->next!=NULL)
+		{
+			cgc=cgc->next;
+			Ipe_GraphicCell* cell=copycell(cgc->t,view->geometry);
+			cell->transform(matrix);
+			cells->add(cell);
+		}
+		view->add(e->stack,e->path,e->plane,cells,true,e->order);
+	}
+	return view;
+}
+
+void Ipe_PageView::expandform(Ipe_PdfStack* instance,int num,const fz_matrix& matrix,std::vector<int>& chain,int& order)
+{
+	Ipe_PdfXobject* xobject=this->page->findxobject(num);
+	if(xobject==NULL||std::find(chain.begin(),chain.end(),num)!=chain.end())
+		return;
+	chain.push_back(num);
+	Ipe_node<Ipe_PdfElement>* current=xobject->getelement()->headler;
+	while(current->next!=NULL)
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		if(stack->getxobject()!=0)//Ƕʵľ,پʵľ
+			expandform(instance,stack->getxobject(),fz_concat(stack->getmatrix(),matrix),chain,order);
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)
+			{
+				cplane=cplane->next;
+				Ipe_LinkList<Ipe_GraphicCell>* cells=new Ipe_LinkList<Ipe_GraphicCell>();
+				Ipe_node<Ipe_GraphicCell>* cgc=cplane->t->getlist()->headler;
+				while(cgc->next!=NULL)
+				{
+					cgc=cgc->next;
+					Ipe_GraphicCell* cell=copycell(cgc->t,this->geometry);
+					cell->transform(matrix);
+					cells->add(cell);
+				}
+				add(instance,pathlist->t,cplane->t,cells,true,order++);//ʽȡе·
+			}
+		}
+	}
+	chain.pop_back();
+}
+
+Ipe_PageView* Ipe_PageView::expand()
+{
+	Ipe_PageView* view=new Ipe_PageView(this->page,this);//չҪڴĲʱviewBoxȡ
+	view->haswindow=this->haswindow;
+	view->window=this->window;
+	std::vector<int> chain;
+	for(int i=0;i<this->count;i++)
+	{
+		struct viewplane* e=&this->planes[i];
+		if(e->plane!=NULL)
+		{
+			view->add(e->stack,e->path,e->plane,e->cells,false,e->order);
+			continue;
+		}
+		int order=0;
+		view->expandform(e->stack,e->stack->getxobject(),e->stack->getmatrix(),chain,order);
+	}
+	return view;
+}
+
+struct simplifycell//뻯һֱ߼,ڱƽеλ
+{
+	int plane;//ͼҪص±
+	Ipe_Lines* lines;
+	int offset;
+};
+
+struct Ipe_SimplifyJob
+{
+	std::vector<struct simplifycell>* cells;
+	std::vector<int>* groups;//ÿջһֱ߼±,һΪֱ߼
+	struct sharetable* table;//ֻ
+	struct sharetable* ends;//·β,ֻ
+	double tolerance;
+	int method;
+	char* keep;//ֱ߼ı,offsetֶ,֮߳䲻ص
+	int nextgroup;
+	Ipe_Mutex mutex;
+};
+
+static void simplifylines(Ipe_Lines* lines,struct sharetable* table,struct sharetable* ends,int method,double tolerance,char* keep)//·һֱ߼
+{
+	int n=lines->getnum();
+	Ipe_Geometry* store=lines->getstore();
+	double* x=store->getx()+lines->getoffset();
+	double* y=store->gety()+lines->getoffset();
+	int* state=store->getstate()+lines->getoffset();
+	std::vector<int> shared(n);
+	std::vector<char> fixed(n);
+	int k;
+	for(k=0;k<n;k++)
+		shared[k]=sharecount(table,x[k],y[k]);
+	int first=0;
+	for(int last=0;last<n;last++)
+	{
+		if(last+1<n&&state[last+1]!=0)
+			continue;
+		for(k=first;k<=last;k++)//·β,պϵ,ı֮(ߵ),ԼڴֹĹΪ̶
+		{
+			fixed[k-first]=k==first||k==last||state[k]==2||
+				(shared[k]>1&&(shared[k-1]!=shared[k]||shared[k+1]!=shared[k]||sharecount(ends,x[k],y[k])>0));
+		}
+		simplifychain(x+first,y+first,last-first+1,&fixed[0],method,tolerance,keep+first);
+		if(x[first]==x[last]&&y[first]==y[last])//պϵĻٱͬĵ,ԭ
+		{
+			int kept=0;
+			for(k=first;k<last;k++)
+				kept+=keep[k];
+			if(kept<3)
+				memset(keep+first,1,last-first+1);
+		}
+		first=last+1;
+	}
+}
+
+static IPE_THREAD_RETURN simplifyworker(void* arg)
+{
+	Ipe_SimplifyJob* job=(Ipe_SimplifyJob*)arg;
+	int g;
+	while(true)
+	{
+		Ipe_MutexLock(&job->mutex);
+		g=job->nextgroup++;
+		Ipe_MutexUnlock(&job->mutex);
+		if(g>=(int)job->groups->size()-1)
+			break;
+		for(int i=(*job->groups)[g];i<(*job->groups)[g+1];i++)
+		{
+			struct simplifycell* c=&(*job->cells)[i];
+			simplifylines(c->lines,job->table,job->ends,job->method,job->tolerance,job->keep+c->offset);
+		}
+	}
+	return 0;
+}
+
+Ipe_PageView* Ipe_PageView::simplify(double tolerance,int method,int threadcount)
+{
+	std::vector<struct simplifycell> cells;
+	std::vector<int> groups;
+	int i,total=0;
+	Ipe_PdfStack* last=NULL;
+	for(i=0;i<this->count;i++)//ռֱ߼,ͬһջҪ,Ϊһ
+	{
+		struct viewplane* e=&this->planes[i];
+		if(e->plane==NULL)
+			continue;
+		if(e->stack!=last||groups.empty())
+		{
+			groups.push_back((int)cells.size());
+			last=e->stack;
+		}
+		Ipe_node<Ipe_GraphicCell>* cgc=e->cells->headler;
+		while(cgc->next!=NULL)
+		{
+			cgc=cgc->next;
+			if(cgc->t->gettype()!=1)
+				continue;
+			struct simplifycell c;
+			c.plane=i;
+			c.lines=static_cast<Ipe_Lines*>(cgc->t);
+			c.offset=total;
+			total+=c.lines->getnum();
+			cells.push_back(c);
+		}
+	}
+	groups.push_back((int)cells.size());
+	struct sharetable table;//ͳÿڼֱ߼,ֻ֮߳
+	struct sharetable ends;//ڱǹ̶,߾ʱҲҪڴ˶Ͽ
+	initsharetable(&table,total);
+	initsharetable(&ends,(int)cells.size()*2);
+	for(i=0;i<(int)cells.size();i++)
+	{
+		Ipe_Lines* lines=cells[i].lines;
+		int n=lines->getnum();
+		for(int k=0;k<n;k++)
+		{
+			shareadd(&table,lines->getx(k),lines->gety(k),i);
+			if(k==0||lines->getstate(k)==0||k==n-1||lines->getstate(k+1)==0)
+				shareadd(&ends,lines->getx(k),lines->gety(k),i);
+		}
+	}
+	char* keep=(char*)malloc(total>0?total:1);
+	Ipe_SimplifyJob job;
+	job.cells=&cells;
+	job.groups=&groups;
+	job.table=&table;
+	job.ends=&ends;
+	job.tolerance=tolerance;
+	job.method=method;
+	job.keep=keep;
+	job.nextgroup=0;
+	Ipe_MutexInit(&job.mutex);
+	if(threadcount<=0)
+		threadcount=Ipe_CpuCount();
+	if(threadcount>(int)groups.size()-1)
+		threadcount=(int)groups.size()-1;
+	if(threadcount>1)
+	{
+		Ipe_Thread* threads=new Ipe_Thread[threadcount];
+		bool* started=new bool[threadcount];
+		for(i=0;i<threadcount;i++)
+			started[i]=Ipe_ThreadStart(&threads[i],simplifyworker,&job);
+		for(i=0;i<threadcount;i++)
+		{
+			if(started[i])
+				Ipe_ThreadJoin(threads[i]);
+		}
+		delete[] started;
+		delete[] threads;
+	}
+	if(job.nextgroup<(int)groups.size()-1)//̻߳ûܹ߳,ڵǰ߳
+		simplifyworker(&job);
+	Ipe_MutexDestroy(&job.mutex);
+	freesharetable(&table);
+	freesharetable(&ends);
+	Ipe_PageView* view=new Ipe_PageView(this->page,this);//ֻ,Ȼ
+	view->haswindow=this->haswindow;
+	view->window=this->window;
+	int c=0;
+	for(i=0;i<this->count;i++)
+	{
+		struct viewplane* e=&this->planes[i];
+		if(e->plane==NULL)
+		{
+			view->add(e->stack,NULL,NULL,NULL,false);
+			continue;
+		}
+		bool changed=false;//ûȥҪֱһ
+		for(int j=c;j<(int)cells.size()&&cells[j].plane==i&&!changed;j++)
+		{
+			for(int k=0;k<cells[j].lines->getnum();k++)
+			{
+				if(!keep[cells[j].offset+k])
+				{
+					changed=true;
+					break;
+				}
+			}
+		}
+		if(!changed)
+		{
+			while(c<(int)cells.size()&&cells[c].plane==i)
+				c++;
+			view->add(e->stack,e->path,e->plane,e->cells,false,e->order);
+			continue;
+		}
+		Ipe_LinkList<Ipe_GraphicCell>* list=new Ipe_LinkList<Ipe_GraphicCell>();
+		Ipe_node<Ipe_GraphicCell>* cgc=e->cells->headler;
+		while(cgc->next!=NULL)
+		{
+			cgc=cgc->next;
+			if(cgc->t->gettype()!=1)
+			{
+				list->add(copycell(cgc->t,view->geometry));
+				continue;
+			}
+			Ipe_Lines* lines=static_cast<Ipe_Lines*>(cgc->t);
+			Ipe_Lines* result=new Ipe_Lines(view->geometry);
+			char* k=keep+cells[c++].offset;
+			for(int n=0;n<lines->getnum();n++)
+			{
+				if(k[n])
+					result->addpoint(lines->getx(n),lines->gety(n),lines->getstate(n));
+			}
+			list->add(result);
+		}
+		view->add(e->stack,e->path,e->plane,list,true,e->order);
+	}
+	free(keep);
+	return view;
+}
+
+Ipe_PdfPage* Ipe_PageView::getpage()
+{
+	return this->page;
+}
+
+Ipe_PageView* Ipe_PageView::getparent()
+{
+	return this->parent;
+}
+
+int Ipe_PageView::getcount()
+{
+	return this->count;
+}
+
+struct viewplane* Ipe_PageView::get(int index)
+{
+	return &this->planes[index];
+}
+
+Ipe_Geometry* Ipe_PageView::getgeometry()
+{
+	return this->geometry;
+}
+
+bool Ipe_PageView::getwindow(cliprect* rect)
+{
+	if(this->haswindow)
+		*rect=this->window;
+	return this->haswindow;
+}
+
+size_t Ipe_PageView::getmemsize()
+{
+	size_t size=sizeof(Ipe_PageView)+this->capacity*sizeof(struct viewplane)+this->geometry->getmemsize();
+	for(int i=0;i<this->count;i++)
+	{
+		if(!this->planes[i].owncells)
+			continue;
+		Ipe_node<Ipe_GraphicCell>* cgc=this->planes[i].cells->headler;
+		while(cgc->next!=NULL)
+		{
+			cgc=cgc->next;
+			size+=sizeof(Ipe_Bazeir)+sizeof(Ipe_node<Ipe_GraphicCell>);
+		}
+	}
+	return size;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include "MuInclude.h"
+#include "Ipe_LinkList.h"
+#include "Ipe_Geometry.h"
+#include "Ipe_GraphicCell.h"
+#include "Ipe_Plane.h"
+#include "clipfunction.h"
+#include "simplifyfunction.h"
+//ȡҳ֮ϵͼ:ü,任Ȳ޸ҳ,µͼ
+//ͼҳ˳¼ͼҪ,ûиıҪֱһֱ߼߼(дʱ),ıĲͼԼĴ洢µ
+//ͼü,ͼһ,releaseͷ;ҳͼͷ֮ͷ
+struct viewplane
+{
+	class Ipe_PdfStack* stack;//ڵջ
+	class Ipe_PdfPath* path;//ڵ·,ṩʽ
+	Ipe_Plane* plane;//ҳеĵͼҪ,NULLʾʵջ
+	bool owncells;//cellsǷɱͼ
+	Ipe_LinkList<Ipe_GraphicCell>* cells;//ͼеֱ߼߼
+	int order;//ɱʵչҪڸʵе,stackΪҳеʵջ;ҳԼҪΪ-1
+};
+
+class EX_PORT Ipe_PageView
+{
+	int refs;
+protected:
+	class Ipe_PdfPage* page;
+	Ipe_PageView* parent;//Եͼ,NULLʾֱҳ
+	Ipe_Geometry* geometry;//ͼɵĵ
+	struct viewplane* planes;//ҳ˳,ͬһջҪ
+	int count;
+	int capacity;
+	bool haswindow;//Ƿ񾭹ڲü
+	cliprect window;
+	Ipe_PageView(class Ipe_PdfPage* page,Ipe_PageView* parent);//յͼ
+	virtual ~Ipe_PageView(void);
+	void add(class Ipe_PdfStack* stack,class Ipe_PdfPath* path,Ipe_Plane* plane,Ipe_LinkList<Ipe_GraphicCell>* cells,bool owncells,int order=-1);
+	void expandform(class Ipe_PdfStack* instance,int num,const fz_matrix& matrix,std::vector<int>& chain,int& order);//ѱҪؾmatrix任뱾ͼ,chainΪչı
+	void clipplanes(cliprect* rect,const bool* inside,clipbuffer* buffer);//õҪػΪü,insideǵҪȫڴڲزü;üΪյҪرȥ
+public:
+	Ipe_PageView(class Ipe_PdfPage* page);//ҳ汾ͼ,ҳȫҪ
+	void retain();
+	void release();//üΪ0ʱͷ,ͷŶһ
+	Ipe_PageView* clip(cliprect* rect,clipbuffer* buffer=NULL);//ڲü,ͼ;ȫڴڵҪع,bufferΪNULLʱʱ
+	Ipe_PageView* transform(const fz_matrix& matrix);//任,ͼ;е㸴ƵͼĴ洢任,ʵչٱ任
+	Ipe_PageView* expand();//չʵ,ͼ;ʵΪñҪ,㸴ƵͼĴ洢ʵ任,Ƕʵľκϲ,ʵչ;ڱ,չҪδü,Ҫʱٲü
+	Ipe_PageView* simplify(double tolerance,int method=IPE_SIMPLIFY_DOUGLAS,int threadcount=0);//ֱ߼,ͼ,߼;ݲΪҳ浥λ,ֱ߼еĵڹ˶Ͽ,໯һ;ջ߳,threadcount<=0ʱȡCPU
+	class Ipe_PdfPage* getpage();
+	Ipe_PageView* getparent();
+	int getcount();
+	struct viewplane* get(int index);
+	Ipe_Geometry* getgeometry();
+	bool getwindow(cliprect* rect);//ڲüʱȡôڲtrue
+	size_t getmemsize();//ͼԼռõڴ,Ĳ
+};
@@ -1,6 +1,9 @@
 #include "Ipe_PdfDocument.h"
 #include "Extract.h"
 #include "FreeImage.h"
+#include "Ipe_Thread.h"
+#include "Ipe_PageCache.h"
+#include "Ipe_SvgDevice.h"
 
 #include <sstream>
 using namespace std;
@@ -13,73 +16,302 @@ string itstr(int num)
 	return s1;
 }
 
+static Ipe_PdfPage* extractpage(fz_context* ctx,fz_document* doc,int number,struct zblrouteset* getline,struct zimages* images)//ȡһҳ,ҳģ,ͼƬ׷ӵimagesĩβ,imagesΪNULLʱͼƬ豸ͷ
+{
+	fz_page *page=NULL;
+	fz_rect rect;
+	fz_device* dev=NULL;
+	Ipe_PdfPage* pdfpage=NULL;
+
+	fz_var(page);
+	fz_var(dev);
+	fz_try(ctx)
+	{
+		page=fz_load_page(doc,number);//ҳ
+		rect=fz_bound_page(doc,page);//ȡҳrectangle
+		dev=fz_new_capture_device(ctx,0);//ֻȡ,ٹդpixmap
+		fz_run_page(doc,page,dev,fz_identity,0);//ҳ,ȡڽ
+		//ȡʸ ֱƽ,ٸ
+		fz_return_line(dev,getline);
+		if(images!=NULL)
+			fz_return_images(dev,images);
+	}
+	fz_always(ctx)
+	{
+		fz_free_device(dev);//ʧʱδȡߵĽ豸ͷ
+		if(page!=NULL)
+			fz_free_page(doc,page);
+	}
+	fz_catch(ctx)
+	{
+		fz_rethrow(ctx);
+	}
+	pdfpage=new Ipe_PdfPage(getline);
+	fz_free_line(getline);//ҳģѽ,ȡڴһͷ
+	pdfpage->setrect(rect);
+	return pdfpage;
+}
+
+static void appendimages(struct zimages* to,struct zimages* from)//fromͼƬڵӵtoĩβ,fromֻʣͷڵ
+{
+	if(from->head==NULL||from->count==0)
+		return;
+	to->currentimage->next=from->head->next;
+	to->currentimage=from->currentimage;
+	to->count+=from->count;
+	from->head->next=NULL;
+	from->currentimage=from->head;
+	from->count=0;
+}
+
+//߳ȡ ÿ̳߳п¡context͸Դ򿪵document,ӹȡҳ
+struct Ipe_ExtractJob
+{
+	const char* path;
+	int pagecount;
+	int nextpage;//һȡҳ
+	Ipe_Mutex mutex;
+	Ipe_PdfPage** pages;//ҳŴŽ
+	struct zimages* images;//ҳŴŸҳͼƬ,װʱҳ˳ϲ
+};
+
+struct Ipe_ExtractWorker
+{
+	Ipe_ExtractJob* job;
+	fz_context* ctx;//¡context
+};
+
+static void lockmutex(void* user,int lock)
+{
+	Ipe_MutexLock(&((Ipe_Mutex*)user)[lock]);
+}
+
+static void unlockmutex(void* user,int lock)
+{
+	Ipe_MutexUnlock(&((Ipe_Mutex*)user)[lock]);
+}
+
+static IPE_THREAD_RETURN extractworker(void* arg)
+{
+	Ipe_ExtractWorker* worker=(Ipe_ExtractWorker*)arg;
+	Ipe_ExtractJob* job=worker->job;
+	fz_context* ctx=worker->ctx;
+	fz_document* doc=NULL;
+	struct zblrouteset getline;
+	int i;
+
+	fz_var(doc);
+	fz_try(ctx)
+	{
+		doc=fz_open_document(ctx,(char*)job->path);//document̹ܿ߳,ÿ̸߳Դ
+	}
+	fz_catch(ctx)
+	{
+		printf("̴߳ļʧ\n");
+		return 0;
+	}
+	while(true)
+	{
+		Ipe_MutexLock(&job->mutex);
+		i=job->nextpage++;
+		Ipe_MutexUnlock(&job->mutex);
+		if(i>=job->pagecount)
+			break;
+		fz_try(ctx)
+		{
+			job->pages[i]=extractpage(ctx,doc,i,&getline,&job->images[i]);
+		}
+		fz_catch(ctx)
+		{
+			printf("%dҳȡʧ\n",i);
+		}
+	}
+	fz_close_document(doc);
+	return 0;
+}
+
+#define IPE_CACHE_MEMLIMIT (256*1024*1024)//ҳ滺Ĭϵڴ
+
 Ipe_PdfDocument::Ipe_PdfDocument(void)
 {
+	this->PageCount=0;
+	this->list=new Ipe_LinkList<Ipe_PdfPage>();
+	this->getimages=NULL;
+	this->imagesdone=NULL;
+	this->rect=fz_empty_rect;
+	this->ctx=NULL;
+	this->doc=NULL;
+	this->getline=NULL;
+	this->cache=NULL;
+	this->listbuilt=true;
 }
-Ipe_PdfDocument::Ipe_PdfDocument(const char* path)//ʼļ
+Ipe_PdfDocument::Ipe_PdfDocument(const char* path)//ʼļ,ֻȡxref,ҳʹʱȡ
 {
 	this->PageCount=0;
 	this->list=new Ipe_LinkList<Ipe_PdfPage>();
-	float zoom,rotate;
-	int page_number=0,page_count;
-	fz_context *ctx;
-	fz_document *doc;
-	fz_pixmap *pix;
-	fz_page *page;
-	fz_matrix ctm;
-	fz_rect rect;
-	fz_device* dev;
-	int x,y,j;
+	this->rect=fz_empty_rect;
+	this->listbuilt=false;
+	this->cache=new Ipe_PageCache(IPE_CACHE_MEMLIMIT,0);
 	
-	struct zblrouteset *getline=(struct zblrouteset *)malloc(sizeof(struct zblrouteset));
+	getline=(struct zblrouteset *)malloc(sizeof(struct zblrouteset));
 	getimages=(struct zimages*)malloc(sizeof(zimages));
+	fz_init_images(getimages);
 	ctx=fz_new_context(NULL,NULL,FZ_STORE_UNLIMITED);//ʼcontext
 
 
 	doc= fz_open_document(ctx,(char*)path);//ȡPDFļȡϢfz_documentĽṹ
 
-	page_number=fz_count_pages(doc);
+	this->PageCount=fz_count_pages(doc);
+	this->imagesdone=(char*)calloc(this->PageCount>0?this->PageCount:1,1);
 
-	cout<<"page_number:"<<page_number<<endl;
-	
-	for (int i=0;i<page_number;i++)
+	cout<<"page_number:"<<this->PageCount<<endl;
+}
+
+Ipe_PdfPage* Ipe_PdfDocument::loadpage(int num)//ڵǰ߳ȡһҳ
+{
+	Ipe_PdfPage* pdfpage=NULL;
+	struct zimages* images=imagesdone[num]?NULL:getimages;//̭ȡҳ,ͼƬgetimages
+
+	fz_var(pdfpage);
+	fz_try(ctx)
 	{
-		printf("///////////pagecount:%d\n",this->PageCount);
-		page=fz_load_page(doc,i);//ҳ
-		rect=fz_bound_page(doc,page);//ȡҳrectangle
-		this->rect=rect;
-		ctm.a=1;
-		ctm.b=0;
-		ctm.c=0;
-		ctm.d=1;
-		ctm.e=0;
-		ctm.f=0;
-		pix=fz_new_pixmap(ctx,fz_find_device_colorspace(ctx,"DeviceRGB"),rect.x1-rect.x0,rect.y1-rect.y0);
-		fz_clear_pixmap_with_value(ctx,pix,0xFF);//Ϊɫ
-		//fz_clear_pixmap(ctx,pix);
-		dev=fz_new_draw_device(ctx,pix);//ͼ豸
-		fz_run_page(doc,page,dev,ctm,0);//ҳƵpixmapɵĻͼ豸
-		//ȡʸ
-		fz_return_line(getline);
-		//ȡimages
-		fz_return_images(getimages);
-		Ipe_PdfPage* pdfpage=new Ipe_PdfPage(getline);
-		pdfpage->setrect(rect);
-		this->list->add(pdfpage);
-		this->PageCount++;	
+		pdfpage=extractpage(ctx,doc,num,getline,images);//ͬʱȡimages
+		imagesdone[num]=1;
+	}
+	fz_catch(ctx)
+	{
+		printf("%dҳȡʧ\n",num);
+	}
+	if(pdfpage!=NULL)
+		this->rect=pdfpage->getrect();
+	return pdfpage;
+}
+
+Ipe_PdfDocument::Ipe_PdfDocument(const char* path,int threadcount)//߳ȡ,threadcount<=0ʱʹô
+{
+	this->PageCount=0;
+	this->list=new Ipe_LinkList<Ipe_PdfPage>();
+	this->getimages=(struct zimages*)malloc(sizeof(zimages));
+	fz_init_images(this->getimages);
+	this->imagesdone=NULL;
+	this->rect=fz_empty_rect;
+	this->ctx=NULL;//ȫҳlist,ٱdocument
+	this->doc=NULL;
+	this->getline=NULL;
+	this->cache=NULL;
+	this->listbuilt=true;
+	Ipe_Mutex locks[FZ_LOCK_MAX];
+	fz_locks_context lockctx;
+	fz_context *ctx;
+	fz_document *doc;
+	Ipe_ExtractJob job;
+	int i;
+
+	if(threadcount<=0)
+		threadcount=Ipe_CpuCount();
+	for(i=0;i<FZ_LOCK_MAX;i++)
+		Ipe_MutexInit(&locks[i]);
+	lockctx.user=locks;
+	lockctx.lock=lockmutex;
+	lockctx.unlock=unlockmutex;
+	ctx=fz_new_context(NULL,&lockctx,FZ_STORE_UNLIMITED);//context,Ա¡
+
+	job.path=path;
+	job.pagecount=0;
+	job.nextpage=0;
+	job.pages=NULL;
+	job.images=NULL;
+	fz_try(ctx)
+	{
+		doc=fz_open_document(ctx,(char*)path);
+		job.pagecount=fz_count_pages(doc);
+		fz_close_document(doc);
 	}
+	fz_catch(ctx)
+	{
+		printf("ļʧ:%s\n",path);
+	}
+	cout<<"page_number:"<<job.pagecount<<" threads:"<<threadcount<<endl;
+
+	if(job.pagecount>0)
+	{
+		if(threadcount>job.pagecount)
+			threadcount=job.pagecount;
+		job.pages=new Ipe_PdfPage*[job.pagecount];
+		job.images=new struct zimages[job.pagecount];
+		for(i=0;i<job.pagecount;i++)
+		{
+			job.pages[i]=NULL;
+			fz_init_images(&job.images[i]);
+		}
+		Ipe_MutexInit(&job.mutex);
+
+		Ipe_ExtractWorker* workers=new Ipe_ExtractWorker[threadcount];
+		Ipe_Thread* threads=new Ipe_Thread[threadcount];
+		bool* started=new bool[threadcount];
+		for(i=0;i<threadcount;i++)
+		{
+			workers[i].job=&job;
+			workers[i].ctx=fz_clone_context(ctx);//¡߳
+			started[i]=workers[i].ctx!=NULL&&Ipe_ThreadStart(&threads[i],extractworker,&workers[i]);
+		}
+		for(i=0;i<threadcount;i++)
+		{
+			if(started[i])
+				Ipe_ThreadJoin(threads[i]);
+			if(workers[i].ctx)
+				fz_free_context(workers[i].ctx);
+		}
+		if(job.nextpage<job.pagecount)//ûܹ߳,ڵǰ߳
+		{
+			workers[0].ctx=ctx;
+			extractworker(&workers[0]);
+		}
+		//ҳ˳װ
+		for(i=0;i<job.pagecount;i++)
+		{
+			appendimages(this->getimages,&job.images[i]);
+			fz_free_images(&job.images[i]);
+			if(job.pages[i]==NULL)
+				continue;
+			this->rect=job.pages[i]->getrect();
+			this->list->add(job.pages[i]);
+			this->PageCount++;
+		}
+		delete[] started;
+		delete[] threads;
+		delete[] workers;
+		delete[] job.pages;
+		delete[] job.images;
+		Ipe_MutexDestroy(&job.mutex);
+	}
+	fz_free_context(ctx);
+	for(i=0;i<FZ_LOCK_MAX;i++)
+		Ipe_MutexDestroy(&locks[i]);
 }
 
 Ipe_PdfDocument::~Ipe_PdfDocument(void)
 {
+	delete cache;
+	list->deleteall();
 	delete list;
-	printf("Documentͷ");
+	if(doc!=NULL)
+		fz_close_document(doc);
+	if(ctx!=NULL)
+		fz_free_context(ctx);
+	if(getimages!=NULL)
+	{
+		fz_free_images(getimages);
+		free(getimages);
+	}
+	free(getline);//ÿҳȡfz_free_line,ֻʣṹ屾
+	free(imagesdone);
 }
 void Ipe_PdfDocument::printfdocument()
 {
 	int count=0;
 	printf("document\n");
-	Ipe_node<Ipe_PdfPage>* p=list->headler;
+	Ipe_node<Ipe_PdfPage>* p=getlist()->headler;
 	while(p->next!=NULL)
 	{
 		printf("%dҳ___________________\n",count);
@@ -94,11 +326,94 @@ void Ipe_PdfDocument::writeSVG(char* path)
 {
 }
 
-Ipe_LinkList<Ipe_PdfPage>* Ipe_PdfDocument::getlist()
+Ipe_LinkList<Ipe_PdfPage>* Ipe_PdfDocument::getlist()//ȡȫҳ,ȡģʽµһεʱȡҳ
 {
+	if(!listbuilt)
+	{
+		for(int i=0;i<PageCount;i++)//ѻҳlist,ظȡ;֮getPagelistȡ,ÿҳֻһ
+		{
+			Ipe_PdfPage* pdfpage=cache->take(i);
+			if(pdfpage==NULL)
+				pdfpage=loadpage(i);
+			if(pdfpage!=NULL)
+				list->add(pdfpage);
+		}
+		listbuilt=true;
+	}
 	return list;
 }
 
+int Ipe_PdfDocument::getPageCount()
+{
+	return PageCount;
+}
+
+Ipe_PdfPage* Ipe_PdfDocument::getPage(int num)
+{
+	if(num<0||num>=PageCount)
+		return NULL;
+	if(listbuilt)//ҳȫȡ,listȡ
+	{
+		Ipe_node<Ipe_PdfPage>* p=list->headler;
+		for(int i=0;i<=num&&p!=NULL;i++)
+			p=p->next;
+		return p!=NULL?p->t:NULL;
+	}
+	Ipe_PdfPage* pdfpage=cache->find(num);
+	if(pdfpage==NULL)
+	{
+		pdfpage=loadpage(num);
+		if(pdfpage!=NULL)
+			cache->insert(num,pdfpage);
+	}
+	return pdfpage;
+}
+
+Ipe_PdfPage* Ipe_PdfDocument::pinPage(int num)
+{
+	Ipe_PdfPage* pdfpage=getPage(num);
+	if(pdfpage!=NULL&&!listbuilt)
+		cache->pin(num);
+	return pdfpage;
+}
+
+void Ipe_PdfDocument::unpinPage(int num)
+{
+	if(!listbuilt)//ȫҳlistʱĵ,Ҫ
+		cache->unpin(num);
+}
+
+void Ipe_PdfDocument::setcachelimit(size_t memlimit,int pagelimit)
+{
+	if(cache!=NULL)
+		cache->setlimit(memlimit,pagelimit);
+}
+
+void Ipe_PdfDocument::pagetoSVG(int num,char* path,int decimals)//ҳͬʱд·,ڴֻһ·й
+{
+	fz_page* page=NULL;
+	if(doc==NULL)
+	{
+		printf("ĵѹر,޷ʽ\n");
+		return;
+	}
+	Ipe_SvgDevice svg(ctx,decimals);
+	fz_var(page);
+	fz_try(ctx)
+	{
+		page=fz_load_page(doc,num);
+		if(svg.open(path,fz_bound_page(doc,page)))
+			fz_run_page(doc,page,svg.getdevice(),fz_identity,0);
+	}
+	fz_catch(ctx)
+	{
+		printf("%dҳʧ\n",num);
+	}
+	svg.close();
+	if(page!=NULL)
+		fz_free_page(doc,page);
+}
+
 fz_rect Ipe_PdfDocument::getrect()
 {
 	return rect;
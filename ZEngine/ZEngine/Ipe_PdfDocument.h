@@ -4,15 +4,26 @@
 #include "Ipe_PdfPage.h"
 //#include "FreeImage.h"
 
+class Ipe_PageCache;
+
 class EX_PORT Ipe_PdfDocument
 {
 	fz_rect rect;
 	int PageCount;
 	Ipe_LinkList<Ipe_PdfPage>* list;
 	struct zimages* getimages;//ͼƬݽṹָ
+	char* imagesdone;//ȡʱҳͼƬǷѼgetimages,̭ҳȡʱظ
+	//ȡҳʱcontextdocument,߳ȡɺΪNULL
+	fz_context* ctx;
+	fz_document* doc;
+	struct zblrouteset* getline;
+	Ipe_PageCache* cache;//getPageʹõҳ滺
+	bool listbuilt;//listǷѾȫҳ
+	Ipe_PdfPage* loadpage(int num);
 public:
 	Ipe_PdfDocument(void);
 	Ipe_PdfDocument(const char* path);//ļ·ʼ
+	Ipe_PdfDocument(const char* path,int threadcount);//߳ȡ,threadcount<=0ʱ
 	~Ipe_PdfDocument(void);
 	void printfdocument();
 	void writeSVG(char* path);
@@ -21,8 +32,12 @@ public:
 	void generatepictures(char* path);
 	void testfreeimage();
 	//void release();
-	//int getPageCount();
-	//Ipe_PdfPage* getPage(int num);
+	int getPageCount();
+	Ipe_PdfPage* getPage(int num);//ȡҳ,ҳɻ,̭ǰЧ(֮ȡҳͿܱ̭)
+	Ipe_PdfPage* pinPage(int num);//ȡҳ沢,unpinPage֮ǰᱻ̭
+	void unpinPage(int num);//pinPageɶԵ
+	void pagetoSVG(int num,char* path,int decimals=3);//ʽһҳΪsvg,ҳģ,ȡģʽ
+	void setcachelimit(size_t memlimit,int pagelimit);//ҳ滺ڴ(ֽ)ҳ,0ʾ
 	//void writeSVG(char* path);
 };
 
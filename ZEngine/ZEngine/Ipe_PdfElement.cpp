@@ -3,6 +3,12 @@
 
 Ipe_PdfElement::Ipe_PdfElement(void)
 {
+	this->elementtype=0;
+}
+
+Ipe_PdfElement::Ipe_PdfElement(int elementtype)
+{
+	this->elementtype=elementtype;
 }
 
 
@@ -3,11 +3,13 @@
 #include "MuInclude.h"
 class EX_PORT Ipe_PdfElement
 {
+	int elementtype;//Ԫ,๹ʱ,ʱݴֱstatic_cast
 public:
 	Ipe_PdfElement(void);
-	~Ipe_PdfElement(void);
+	Ipe_PdfElement(int elementtype);
+	virtual ~Ipe_PdfElement(void);
 	virtual void printfPath(){printf("");};
-	virtual int getelementtype(){return 0;};//ж 0- 1-Ipe_PdfStack 2-? 3-? 
+	int getelementtype(){return elementtype;};//ж 0- 1-Ipe_PdfStack 2-? 3-? 
 
 };
 
@@ -1,15 +1,20 @@
 #include "Ipe_PdfPage.h"
 #include "Ipe_PdfStack.h"
-#include <fstream>
 #include <string>
-#include <sstream>
-#include"calculate.h"
 #include "recursion.h"
-
-cliprect crect;
+#include "Ipe_SvgWriter.h"
+#include "Ipe_Thread.h"
+#include <math.h>
 
 Ipe_PdfPage::Ipe_PdfPage(void)
 {
+	this->list=new Ipe_LinkList<Ipe_PdfElement>();
+	this->geometry=new Ipe_Geometry();
+	this->styles=new Ipe_StyleTable();
+	this->clips=new Ipe_ClipTable();
+	this->xobjects=new Ipe_LinkList<Ipe_PdfXobject>();
+	this->patterns=new Ipe_LinkList<Ipe_PdfPattern>();
+	this->index=NULL;
 }
 
 Ipe_PdfPage::Ipe_PdfPage(zblrouteset* routeset)//ʼÿҳ
@@ -17,126 +22,71 @@ Ipe_PdfPage::Ipe_PdfPage(zblrouteset* routeset)//
 	int i=0;
 	this->graphiccellcount=routeset->count;
 	this->list=new Ipe_LinkList<Ipe_PdfElement>();
-	routeset->currentstack=routeset->stackheadler;
-	while(routeset->currentstack->nextstack!=NULL)
+	this->geometry=new Ipe_Geometry();
+	this->styles=new Ipe_StyleTable();
+	this->clips=new Ipe_ClipTable();
+	this->xobjects=new Ipe_LinkList<Ipe_PdfXobject>();
+	this->patterns=new Ipe_LinkList<Ipe_PdfPattern>();
+	this->index=NULL;
+	recursion(this->list,this->geometry,this->styles,this->clips,routeset->stackheadler);//ջ,ϲǶջתþü·
+	struct zblxobject* x=routeset->xobjectheadler;
+	while(x!=NULL)//ÿֻȡһ,ҳеĵֻöŵʵջ
+	{
+		char prefix[32];
+		sprintf(prefix,"x%d-c",x->num);//ڵĲüڱϵ,idҳķֿ
+		Ipe_LinkList<Ipe_PdfElement>* elements=new Ipe_LinkList<Ipe_PdfElement>();
+		Ipe_ClipTable* xclips=new Ipe_ClipTable(prefix);
+		recursion(elements,this->geometry,this->styles,xclips,x->stackheadler);
+		this->xobjects->add(new Ipe_PdfXobject(x->num,elements,xclips));
+		x=x->nextxobject;
+	}
+	struct zblpattern* p=routeset->patternheadler;
+	while(p!=NULL)//ÿͼֻȡһͼԪ,·ʽֻñ
 	{
-		routeset->currentstack=routeset->currentstack->nextstack;//ջ
-		recursion(this->list,routeset->currentstack,NULL,NULL,0);//Ƕ׵
+		char prefix[32];
+		sprintf(prefix,"p%d-c",p->id);
+		Ipe_LinkList<Ipe_PdfElement>* elements=new Ipe_LinkList<Ipe_PdfElement>();
+		Ipe_ClipTable* pclips=new Ipe_ClipTable(prefix);
+		recursion(elements,this->geometry,this->styles,pclips,p->stackheadler);
+		this->patterns->add(new Ipe_PdfPattern(p,elements,pclips));
+		p=p->nextpattern;
 	}
 	//ҳе,תþ
 	this->maketransform();
+	this->makebounds();//,һΧ,̲֮߳üֻ
 }
 
-void Ipe_PdfPage::maketransform()//оתþĵ,ת
+static void transformelements(Ipe_LinkList<Ipe_PdfElement>* list)//оתþջ,еĵת
 {
 	Ipe_node<Ipe_PdfElement>* current;
-	current=this->list->headler;
-	crect.x0=0;
-	crect.x1=0;
-	crect.y0=0;
-	crect.y1=0;
+	current=list->headler;
 	while(current->next!=NULL)//ջ
 	{
 		current=current->next;
 		if(current->t->getelementtype()==1)//Ϊ1,Ϊͼβ
 		{
 			Ipe_PdfStack* stack;
-			stack=dynamic_cast<Ipe_PdfStack*>(current->t);//̬ת
+			stack=static_cast<Ipe_PdfStack*>(current->t);//ɱȷ
+			if(stack->getexistcm()!=1)//תþ
+				continue;
+			fz_matrix matrix=stack->getmatrix();//ÿջֻȡһѺϲľ
+			stack->setexistcm(0);
 			Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;//ȡPath
-			int existcm=stack->getexistcm();
-			if(existcm==1)//תþ
+			while(pathlist->next!=NULL)//ջ·
 			{
-				float cm[6];
-				stack->setexistcm(0);
-				while(pathlist->next!=NULL)//ջ·
+				pathlist=pathlist->next;
+				Ipe_node <Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;//ȡõͼҪͷ
+				while(cplane->next!=NULL)//ͼҪ,,
 				{
-					pathlist=pathlist->next;
-					Ipe_node <Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;//ȡõͼҪͷ
-					while(cplane->next!=NULL)//ͼҪ,,
+					cplane=cplane->next;
+					Ipe_node<class Ipe_GraphicCell>* cgc=cplane->t->getlist()->headler;
+					while(cgc->next!=NULL)//·еֱ߼߼,εһα任
 					{
-						cplane=cplane->next;
-						Ipe_Plane *plane=cplane->t;
-						if(plane->getisplane())//жϵͼҪ,Ƿ·
-						{
-							//·һֱ/߼
-							bool firsttime=true;
-							double beginx,beginy;
-							Ipe_node<class Ipe_GraphicCell>*graphiccell=plane->getlist()->headler;
-							for (int j=0;j<plane->getgraphicellcount();j++)
-							{
-								graphiccell=graphiccell->next;
-								if (graphiccell->t->gettype()==1)//0- 1-ֱ߼ 2-߼
-								{
-									Ipe_Lines * lines=dynamic_cast<Ipe_Lines*>(graphiccell->t);//תΪlinesֱ߼
-									//ֱ߼ı
-									Ipe_node<Ipe_Point2D>* points=lines->getlist()->headler;
-									while (points->next!=NULL)
-									{
-										points=points->next;
-										points->t->setx(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4]));
-										points->t->sety(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5]));
-									}
-								}
-								else if(graphiccell->t->gettype()==2)
-								{
-									Ipe_Bazeir* bazeir=dynamic_cast<Ipe_Bazeir*>(graphiccell->t);//תΪ߼
-									//߼ı
-									Ipe_node<Ipe_Point2D>* points=bazeir->getlist()->headler;
-									while (points->next!=NULL)
-									{
-										points=points->next;
-										points->t->setx(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4]));
-										points->t->sety(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5]));
-									}
-								}
-								else
-								{
-									printf(",ʼ\n");
-								}
-							}
-						}
-						else//·
-						{
-							Ipe_node<class Ipe_GraphicCell>* cgc=plane->getlist()->headler;
-							while(cgc->next!=NULL)//·еֱ߼߼
-							{
-								cgc=cgc->next;
-								Ipe_GraphicCell* graphiccell=cgc->t;
-								if(graphiccell->gettype()==1)//1-ֱ߼ 
-								{
-									Ipe_Lines * lines=dynamic_cast<Ipe_Lines*>(graphiccell);//תΪlinesֱ߼
-									//ֱ߼ı
-									Ipe_node<Ipe_Point2D>* points=lines->getlist()->headler;
-									while (points->next!=NULL)
-									{
-										points=points->next;
-										points->t->setx(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4]));
-										points->t->sety(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5]));
-									}
-								}
-								else if(graphiccell->gettype()==2)//2-߼
-								{
-									Ipe_Bazeir* bazeir=dynamic_cast<Ipe_Bazeir*>(graphiccell);//תΪ߼
-									//߼ı
-									Ipe_node<Ipe_Point2D>* points=bazeir->getlist()->headler;
-									points=points->next;
-									points->t->setx(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4]));
-									points->t->sety(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5]));
-									points=points->next;
-									points=points->next;
-									while (points->next!=NULL)
-									{
-										points=points->next;
-										points->t->setx(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4]));
-										points->t->sety(transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5]));
-									}
-								}
-								else//0-
-								{
-									printf("δʼGraphicCell\n");
-								}
-							}
-						}
+						cgc=cgc->next;
+						if(cgc->t->gettype()==0)//0-
+							printf("δʼGraphicCell\n");
+						else
+							cgc->t->transform(matrix);
 					}
 				}
 			}
@@ -144,10 +94,253 @@ void Ipe_PdfPage::maketransform()//
 	}
 }
 
+void Ipe_PdfPage::maketransform()
+{
+	transformelements(this->list);
+	this->clips->maketransform();//ü·ܱջ,ʱľֻ任һ
+	Ipe_node<Ipe_PdfXobject>* x=this->xobjects->headler;
+	while(x->next!=NULL)//ڲľֻڱԼĵ,ʵľʱ
+	{
+		x=x->next;
+		transformelements(x->t->getelement());
+		x->t->getclips()->maketransform();
+	}
+	Ipe_node<Ipe_PdfPattern>* p=this->patterns->headler;
+	while(p->next!=NULL)//ͼԪڲľֻͼԪĵ,ͼʱ
+	{
+		p=p->next;
+		transformelements(p->t->getelement());
+		p->t->getclips()->maketransform();
+	}
+}
+
+static void boundelements(Ipe_LinkList<Ipe_PdfElement>* list)//㲢ÿ·,ͼҪ,ֱ߼߼İΧ
+{
+	double box[4];
+	Ipe_node<Ipe_PdfElement>* current=list->headler;
+	while(current->next!=NULL)//ջ
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_node<Ipe_PdfPath>* pathlist=static_cast<Ipe_PdfStack*>(current->t)->getpathlist()->headler;
+		while(pathlist->next!=NULL)//·ϲͼҪصİΧ,ͼҪغϲֱ߼߼
+		{
+			pathlist=pathlist->next;
+			pathlist->t->getbound(box);
+		}
+	}
+}
+
+static void unionbox(double* box,const double* b,bool& valid)
+{
+	if(!valid)
+	{
+		for(int i=0;i<4;i++)
+			box[i]=b[i];
+		valid=true;
+		return;
+	}
+	if(b[0]<box[0])
+		box[0]=b[0];
+	if(b[1]<box[1])
+		box[1]=b[1];
+	if(b[2]>box[2])
+		box[2]=b[2];
+	if(b[3]>box[3])
+		box[3]=b[3];
+}
+
+static void transformbox(fz_matrix m,const double* in,double* out)//ΧеĸǾ任İΧ
+{
+	double xs[2]={in[0],in[2]};
+	double ys[2]={in[1],in[3]};
+	for(int i=0;i<4;i++)
+	{
+		double x=xs[i&1]*m.a+ys[i>>1]*m.c+m.e;
+		double y=xs[i&1]*m.b+ys[i>>1]*m.d+m.f;
+		if(i==0||x<out[0])
+			out[0]=x;
+		if(i==0||y<out[1])
+			out[1]=y;
+		if(i==0||x>out[2])
+			out[2]=x;
+		if(i==0||y>out[3])
+			out[3]=y;
+	}
+}
+
+bool Ipe_PdfPage::getinstancebound(Ipe_PdfStack* stack,double* box)
+{
+	double form[4];
+	Ipe_PdfXobject* x=findxobject(stack->getxobject());
+	if(x==NULL||!x->getbound(form))
+		return false;
+	transformbox(stack->getmatrix(),form,box);
+	return true;
+}
+
+Ipe_PdfXobject* Ipe_PdfPage::findxobject(int num)
+{
+	Ipe_node<Ipe_PdfXobject>* x=this->xobjects->headler;
+	while(x->next!=NULL)
+	{
+		x=x->next;
+		if(x->t->getnum()==num)
+			return x->t;
+	}
+	return NULL;
+}
+
+void Ipe_PdfPage::boundxobject(Ipe_PdfXobject* xobject)//ݵİΧ,Ƕ׵ʵȼõı
+{
+	double box[4],b[4];
+	bool valid=false;
+	if(xobject->getboundstate()!=0)
+		return;
+	xobject->setbound(3,NULL);//ʵ
+	Ipe_node<Ipe_PdfElement>* current=xobject->getelement()->headler;
+	while(current->next!=NULL)
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		if(stack->getxobject()!=0)
+		{
+			Ipe_PdfXobject* nested=findxobject(stack->getxobject());
+			if(nested!=NULL)
+				boundxobject(nested);
+			if(getinstancebound(stack,b))
+				unionbox(box,b,valid);
+			continue;
+		}
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)
+		{
+			pathlist=pathlist->next;
+			if(pathlist->t->getbound(b))
+				unionbox(box,b,valid);
+		}
+	}
+	xobject->setbound(valid?1:2,box);
+}
+
+void Ipe_PdfPage::makebounds()
+{
+	boundelements(this->list);
+	Ipe_node<Ipe_PdfXobject>* x=this->xobjects->headler;
+	while(x->next!=NULL)
+	{
+		x=x->next;
+		boundelements(x->t->getelement());
+	}
+	x=this->xobjects->headler;
+	while(x->next!=NULL)//·İΧ,ķΧ,ʵİΧɴ˱任õ
+	{
+		x=x->next;
+		boundxobject(x->t);
+	}
+	Ipe_node<Ipe_PdfPattern>* p=this->patterns->headler;
+	while(p->next!=NULL)
+	{
+		p=p->next;
+		boundelements(p->t->getelement());
+	}
+}
+
 Ipe_PdfPage::~Ipe_PdfPage(void)
 {
+	list->deleteall();
 	delete list;
-	printf("Ipe_PdfPageͷ\n");
+	xobjects->deleteall();
+	delete xobjects;
+	patterns->deleteall();
+	delete patterns;
+	delete index;
+	delete geometry;//ͼȫͷ,ͷŵĴ洢
+	delete styles;
+	delete clips;//ջͷȫ
+}
+
+static size_t elementsmemsize(Ipe_LinkList<Ipe_PdfElement>* list)//ջ,·ֱ߼߼ĴС,㲻
+{
+	size_t size=0;
+	Ipe_node<Ipe_PdfElement>* current=list->headler;
+	while(current->next!=NULL)//ջ
+	{
+		current=current->next;
+		size+=sizeof(Ipe_node<Ipe_PdfElement>);
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		size+=sizeof(Ipe_PdfStack);
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)//ջ·
+		{
+			pathlist=pathlist->next;
+			size+=sizeof(Ipe_PdfPath)+sizeof(Ipe_node<Ipe_PdfPath>);
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)//ͼҪ
+			{
+				cplane=cplane->next;
+				size+=sizeof(Ipe_Plane)+sizeof(Ipe_node<Ipe_Plane>);
+				Ipe_node<Ipe_GraphicCell>* cgc=cplane->t->getlist()->headler;
+				while(cgc->next!=NULL)//ֱ߼߼
+				{
+					cgc=cgc->next;
+					size+=sizeof(Ipe_Bazeir)+sizeof(Ipe_node<Ipe_GraphicCell>);
+				}
+			}
+		}
+	}
+	return size;
+}
+
+size_t Ipe_PdfPage::getmemsize()
+{
+	size_t size=sizeof(Ipe_PdfPage)+geometry->getmemsize()+styles->getmemsize()+clips->getmemsize();//ȫڼδ洢,ʽü·ڸԵı
+	size+=elementsmemsize(this->list);
+	if(this->index!=NULL)
+		size+=this->index->getmemsize();
+	Ipe_node<Ipe_PdfXobject>* x=this->xobjects->headler;
+	while(x->next!=NULL)
+	{
+		x=x->next;
+		size+=sizeof(Ipe_PdfXobject)+sizeof(Ipe_node<Ipe_PdfXobject>)+x->t->getclips()->getmemsize()+elementsmemsize(x->t->getelement());
+	}
+	Ipe_node<Ipe_PdfPattern>* p=this->patterns->headler;
+	while(p->next!=NULL)
+	{
+		p=p->next;
+		size+=sizeof(Ipe_PdfPattern)+sizeof(Ipe_node<Ipe_PdfPattern>)+p->t->getclips()->getmemsize()+elementsmemsize(p->t->getelement());
+	}
+	return size;
+}
+
+Ipe_Geometry* Ipe_PdfPage::getgeometry()
+{
+	return this->geometry;
+}
+
+Ipe_StyleTable* Ipe_PdfPage::getstyles()
+{
+	return this->styles;
+}
+
+Ipe_ClipTable* Ipe_PdfPage::getclips()
+{
+	return this->clips;
+}
+
+Ipe_LinkList<Ipe_PdfXobject>* Ipe_PdfPage::getxobjects()
+{
+	return this->xobjects;
+}
+
+Ipe_LinkList<Ipe_PdfPattern>* Ipe_PdfPage::getpatterns()
+{
+	return this->patterns;
 }
 
 Ipe_LinkList<Ipe_PdfElement>* Ipe_PdfPage::getelement()
@@ -165,8 +358,11 @@ void Ipe_PdfPage::printpage()
 	{
 		//p->next->t->printfPath();//ת
 		printf("ҳ%dͼ״̬ջ:+++++++++++++++++++++\n",count);
-		Ipe_PdfStack* stack=dynamic_cast<Ipe_PdfStack*>(p->next->t);
-		printf(":%d\n",stack->getgrade());
+		if(p->next->t->getelementtype()==1)//ͼ״̬ջ
+		{
+			Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(p->next->t);
+			printf(":%d\n",stack->getgrade());
+		}
 		p=p->next;
 		count++;
 	}
@@ -182,596 +378,369 @@ fz_rect Ipe_PdfPage::getrect()
 	return rect;
 }
 
-void Ipe_PdfPage::pagetoSVG(char* path)//һҳΪsvg
+static void writepoint(Ipe_SvgWriter& w,const char* order,double x,double y)//һ·,orderΪ
 {
-	int i=0,j=0,k=0,l=0,m=0,n=0,o=0,p=0,shadowid=0;
-	Ipe_node<Ipe_PdfElement>* pointer=this->list->headler;//PDFԪصͷָ
-	Ipe_PdfElement* element;
-	Ipe_PdfStack* stack;
-	Ipe_PdfPath* pdfpath;
-	Ipe_node<class Ipe_PdfPath>* currentpdfpath;
+	w.write(order);
+	w.writenumber(x);
+	w.write(' ');
+	w.writenumber(y);
+	w.write(' ');
+}
+
+void Ipe_PdfPage::writestack(Ipe_SvgWriter& fout,Ipe_PdfStack* stack,Ipe_ClipTable* clips,double height,bool use)
+{
+	if(stack->getexistclip()!=0)//òü·,<defs>
+	{
+		fout.write("<g style=\"clip-path: url(#");
+		fout.write(clips->getprefix());
+		fout.writeint(stack->getclip()+1);
+		fout.write(");\">\n");
+	}
+	if(stack->getxobject()!=0&&use)//ʵ,<symbol>
+	{
+		//еĵΪ(x,-y),Ȼԭy,ʵ,ٻΪSVG
+		fz_matrix flip={1,0,0,-1,0,0};
+		fz_matrix svg={1,0,0,-1,0,(float)height};
+		fz_matrix m=fz_concat(fz_concat(flip,stack->getmatrix()),svg);
+		fout.write("<use xlink:href=\"#x");
+		fout.writeint(stack->getxobject());
+		fout.write("\" transform=\"matrix(");
+		fout.writenumber(m.a);
+		fout.write(' ');
+		fout.writenumber(m.b);
+		fout.write(' ');
+		fout.writenumber(m.c);
+		fout.write(' ');
+		fout.writenumber(m.d);
+		fout.write(' ');
+		fout.writenumber(m.e);
+		fout.write(' ');
+		fout.writenumber(m.f);
+		fout.write(")\"/>\n");
+	}
+}
+
+void Ipe_PdfPage::writeplane(Ipe_SvgWriter& fout,Ipe_LinkList<Ipe_GraphicCell>* cells,bool isplane,Ipe_PdfStack* stack,double height,string& attribute)
+{
+	int k=0,n=0;
 	Ipe_node<class Ipe_GraphicCell>* graphiccell;
-	Ipe_node<class Ipe_GraphicCell>* clipgraphiccell;
-	Ipe_node<class Ipe_Plane>* plane;
 	Ipe_Lines* lines;
 	Ipe_Bazeir* bazeir;
-	ofstream fout;//fout1;
-	fout.open(path);
-	//fout1.open("C:\\Users\\Բ\\Desktop\\Ա.txt");
-	//дļͷ
-	fout<<"<?xml version=\"1.0\" standalone=\"no\"?>\n\n<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \n\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n <svg width=\"100%\" height=\"100%\" version=\"1.1\" viewBox=\" "<<this->rect.x0<<" "<<this->rect.y0<<" "<<this->rect.x1<<" "<<this->rect.y1<<"\"";
-	fout<<" xmlns=\"http://www.w3.org/2000/svg\">"<<endl;
-	//for (i=0;i<this->graphiccellcount;i++)//ÿPDFջ
-	while(pointer->next!=NULL)
+	if(isplane==false)//Ϊպϵ,Ϊһϵ·
 	{
-		pointer=pointer->next;//pointerָstackͷ
-		stack=dynamic_cast<Ipe_PdfStack*>(pointer->t);//̬ǿת
-		if(pointer->t->getelementtype()==1)//pdfҳԪصΪpath PS:жͼƬ
+		graphiccell=cells->headler;
+		while(graphiccell->next!=NULL)
 		{
-			//printf("һβü·״̬:%d\n",stack->getexistclip());
-			if(stack->getexistclip()>0)//ڲü·
+			graphiccell=graphiccell->next;
+			if (graphiccell->t->gettype()==1)//0- 1-ֱ߼ 2-߼
 			{
-				//Ӳü·
-				string clippath="<defs>";
-				o++;
-				clippath=clippath+"<clipPath id=\"c-star"+toString(o)+"\">"+"\n";
-				clippath=clippath+"<path d=\"";
-				clipgraphiccell=stack->getcliplist()->headler;
-				while(clipgraphiccell->next!=NULL)//ֱ߼
+				lines=static_cast <Ipe_Lines*>(graphiccell->t);//תͳΪֱ߼
+				fout.write("<path d=\"");//һ·
+				const char* order="M";
+				for(k=0;k<lines->getnum();k++)
 				{
-					clipgraphiccell=clipgraphiccell->next;
-					if(clipgraphiccell->t->gettype()==1)//ֱ߼
+					switch (lines->getstate(k))//m,l,h,c״̬(ֱӦ0123
 					{
-						lines=dynamic_cast <Ipe_Lines*>(clipgraphiccell->t);//תͳΪֱ߼
-						Ipe_node<Ipe_Point2D>* points=lines->getlist()->headler;
-						//clippath=clippath+"<clipPath id=\"c-star0"+"\">"+"\n";
-						//clippath=clippath+"<polygon points=\"";
-						for(n=0;n<lines->getnum();n++)//
-						{
-							points=points->next;
-							if(points->t->getstate()==0)//m,l,h,c״̬(ֱӦ0123
-							{
-								clippath=clippath+"M"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+" ";//ҪдSVGļҳϽΪԭģҪyᷴ
-							}
-							else if(points->t->getstate()==1)
-							{
-								clippath=clippath+"L"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+" ";
-							}
-							else if(points->t->getstate()==2)
-							{
-								clippath=clippath+"L"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+" Z ";
-							}
-							
-						}
-						//clippath=clippath+"\"/>"+"\n";
-						//clippath=clippath+"</clipPath>";
-					}
-					else //߼
-					{
-						bazeir=dynamic_cast<Ipe_Bazeir*>(clipgraphiccell->t);//תͳΪ߼
-						Ipe_node<Ipe_Point2D>* points=bazeir->getlist()->headler;
-						//clippath=clippath+"<clipPath id=\"c-star"+toString(m)+"\">"+"\n";
-						points=points->next;
-						clippath=clippath+"M"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+" ";//
-						//fout<<"M"<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";
-						points=points->next;
-						points=points->next;
-						points=points->next;
-						for(k=0;k<bazeir->getnum()-1;k++)
-						{
-							clippath=clippath+"C"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+" ";
-							//fout<<"C"<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";
-							points=points->next;
-							clippath=clippath+"C"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+" ";
-							points=points->next;
-							clippath=clippath+"C"+toString(points->t->getx())+" "+toString((this->getrect().y1-this->getrect().y0)-points->t->gety())+"\n";
-							points=points->next;
-						}
-						clippath=clippath+"\"/>"+"\n";
-						
+						case 0:
+							order="M";
+							break;
+						case 1:
+							order="L";
+							break;
 					}
-						
+					writepoint(fout,order,lines->getx(k),height-lines->gety(k));
 				}
-				clippath=clippath+"\"/>"+"\n";
-				clippath=clippath+"</clipPath>";
-				clippath=clippath+"</defs>";
-				fout<<clippath<<endl;
+				fout.write(attribute.c_str(),(int)attribute.size());
 			}
-			/*
-			if(stack->getshadowtype()!=0)//Ӱ,ɫ øջSVGɫ
+			else//߼ ڸ
 			{
-				if(stack->getshadowtype()==1)
+				bazeir=static_cast<Ipe_Bazeir*>(graphiccell->t);//תͳΪ߼
+				int pt=0;//ͼе±
+				fout.write("<path d=\"");
+				if(bazeir->getnum()!=0)
 				{
-
-					shadowid++;
-					fout<<"<defs>\n<linearGradient id=\""<<shadowid<<"\" x1=\""<<x1<<"%\" x2=\""<<x2<<"%\" y1=\""<<y1<<"%\" y2=\""<<y2<<"%\">"<<endl;
-					fout<<"<stop offset=\"0%\" style=\"stop-color:rgb("<<stack->getbcolor()[0]<<","<<stack->getbcolor()[1]<<","<<stack->getbcolor()[2]<<");"<<endl;
-					fout<<"stop-opacity:1\"/>"<<endl;
-					fout<<"<stop offset=\"100%\" style=\"stop-color:rgb("<<stack->getecolor()[0]<<","<<stack->getecolor()[1]<<","<<stack->getecolor()[2]<<");"<<endl;
-					fout<<"stop-opacity:1\"/>"<<endl;
-					fout<<"</linearGradient>"<<endl<<"</defs>"<<endl;
-					//ԽĶ
-					//еǰ
-
+					writepoint(fout,"M",bazeir->getx(pt),height-bazeir->gety(pt));//
+					pt+=3;
 				}
-			}
-			*/
-			if(stack->getexistclip()!=0)//ָü·
-			{
-				fout<<"<g style=\"clip-path: url(#c-star"<<toString(o)<<+");\">\n";
-				//printf("+++++++++++++++++++++++++++++++++++++++++++++ǰ·ڲü·\n");
-			}
-			currentpdfpath=stack->getpathlist()->headler;//ȡջpathϵͷ
-#ifdef debug
-			printf("ջ%d·\n",stack->getcountpath());
-#endif
-			//printf("ջ·:%d\n",stack->getcountpath());
-			for(l=0;l<stack->getcountpath();l++)//ջ·
-			{
-				currentpdfpath=currentpdfpath->next;
-				pdfpath=currentpdfpath->t;//ȫת
-				//ȡÿpathɫ,߿Ϣ,Ϊÿ߼SVG,ÿpathÿSVGԪضһԽβ
-				string attribute="\" style=\"";
-				//ɫ
-				Ipe_Color color=pdfpath->getcolor();
-				if(pdfpath->getdrawingmethord()<5)//ߵ
+				for(k=0;k<bazeir->getnum()-1;k++)
 				{
-					if(pdfpath->getdrawingmethord()==1||pdfpath->getdrawingmethord()==-1||pdfpath->getdrawingmethord()==4)//ͿĨ·  Ʒ 1-S 2-f* 3-f/F 4-s 5-B 6-B* 7-b 8-b*
+					if(bazeir->getstate(pt)==0)//ڴ˶Ͽ
 					{
-						attribute=attribute+"fill:none;stroke:";
-						if(pdfpath->getcolorspace()==3||pdfpath->getcolorspace()==4)//ΪRGBռ
-						{
-							attribute=attribute+"rgb(";
-							attribute=attribute+toString(color.getr())+","+toString(color.getg())+","+toString(color.getb())+"); stroke-width:";
-							attribute=attribute+toString(pdfpath->getlinewidth());//߿
-						}
-						else//Ҷȿռ
-						{
-							if(color.getG()==0)//0Ǻɫ 1ǰɫ
-							{
-								attribute=attribute+"black;";
-							}
-							else
-							{
-								attribute=attribute+"white;";
-							}
-							attribute=attribute+" stroke-width:";
-						}
+						writepoint(fout,"M",bazeir->getx(pt),height-bazeir->gety(pt));
+						pt+=3;
+						continue;
 					}
-					else//
+					writepoint(fout,"C",bazeir->getx(pt),height-bazeir->gety(pt));
+					pt++;
+					writepoint(fout,"",bazeir->getx(pt),height-bazeir->gety(pt));
+					pt++;
+					fout.writenumber(bazeir->getx(pt));
+					fout.write(' ');
+					fout.writenumber(height-bazeir->gety(pt));
+					fout.write('\n');
+					pt++;
+				}
+				fout.write(attribute.c_str(),(int)attribute.size());
+			}
+		}
+	}
+	else//һպϵ,ʱSVGʱҪһеһ·γһյ
+	{
+		fout.write("<path d=\"");
+		graphiccell=cells->headler;
+		bool firsttime=true;
+		double beginx=0,beginy=0;
+		double penx=0,peny=0;//ǰ,δ任
+		while(graphiccell->next!=NULL)
+		{
+			graphiccell=graphiccell->next;
+			if (graphiccell->t->gettype()==1)//0- 1-ֱ߼ 2-߼
+			{
+				lines=static_cast <Ipe_Lines*>(graphiccell->t);//תͳΪֱ߼
+				for(k=0;k<lines->getnum();k++)
+				{
+					const char* order;
+					if(k==0&&lines->getstate(k)==0&&!firsttime&&lines->getx(k)==penx&&lines->gety(k)==peny)//߼ֱ֮߼ڽظ,µ·
+						continue;
+					if(lines->getstate(k)==0)
 					{
-						attribute=attribute+"fill:";
-						if(pdfpath->getcolorspace()==3||pdfpath->getcolorspace()==4)//ΪRGBռ
-						{
-							attribute=attribute+"rgb(";
-							attribute=attribute+toString(color.getr())+","+toString(color.getg())+","+toString(color.getb())+"); ";
-						}
-						else//Ϊڰ
-						{
-							if(color.getG()==0)//0Ǻɫ 1ǰɫ
-							{
-								attribute=attribute+"black;";
-							}
-							else
-							{
-								attribute=attribute+"white;";
-							}
-						}
+						order="M";
+						beginx=lines->getx(k);
+						beginy=lines->gety(k);
 					}
-					/*
-					if(pdfpath->getcolorspace()==3||pdfpath->getcolorspace()==4)//ΪRGBռ
+					else //m,l,h,c״̬(ֱӦ0123
 					{
-						attribute=attribute+"rgb(";
-						attribute=attribute+toString(color.getr())+","+toString(color.getg())+","+toString(color.getb())+"); stroke-width:";
+						order="L";
 					}
-					else//Ҷȿռ
+					firsttime=false;//еǰ,֮߼Ӵ˽
+					penx=lines->getstate(k)==2?beginx:lines->getx(k);
+					peny=lines->getstate(k)==2?beginy:lines->gety(k);
+					if(stack->getexistcm()==0)
 					{
-						if(color.getG()==0)//0Ǻɫ 1ǰɫ
-						{
-							attribute=attribute+"black;";
-						}
+						if(lines->getstate(k)==2)//պָ,ص
+							writepoint(fout,order,beginx,height-beginy);
 						else
-						{
-							attribute=attribute+"white;";
-						}
-						attribute=attribute+" stroke-width:";
+							writepoint(fout,order,lines->getx(k),height-lines->gety(k));
 					}
-					*/
-					
 				}
-				else//Ϳɫʽ
+			}
+			else//߼ ڸ
+			{
+				bazeir=static_cast<Ipe_Bazeir*>(graphiccell->t);//תͳΪ߼
+				fz_matrix m=stack->getmatrix();
+				bool existcm=stack->getexistcm()!=0;
+				int pt=0;
+				if(firsttime==true)
+				{
+					firsttime=false;
+					if(!existcm)
+						writepoint(fout,"M",bazeir->getx(pt),height-bazeir->gety(pt));//
+					else
+						writepoint(fout,"M",transform(bazeir->getx(pt),bazeir->gety(pt),m.a,m.c,m.e),height-transform(bazeir->getx(pt),bazeir->gety(pt),m.b,m.d,m.f));
+					beginx=bazeir->getx(pt);
+					beginy=bazeir->gety(pt);
+					penx=beginx;
+					peny=beginy;
+				}
+				pt+=3;
+				for(k=0;k<bazeir->getnum()-1;k++)
 				{
-					Ipe_Color scolor=pdfpath->getscolor();//ȡstrokeɫ
-					attribute=attribute+"fill:";
-					if(pdfpath->getcolorspace()==3||pdfpath->getcolorspace()==4)//ΪRGBռ
+					if(bazeir->getstate(pt)==2)//պϿ,ص·
 					{
-						attribute=attribute+"rgb(";
-						attribute=attribute+toString(color.getr())+","+toString(color.getg())+","+toString(color.getb());
+						fout.write("Z ");
+						penx=beginx;
+						peny=beginy;
+						pt+=3;
+						continue;
 					}
-					else//Ϊڰ
+					if(bazeir->getstate(pt)==0)//ڴ˶Ͽ,µ·
 					{
-						if(color.getG()==0)//0Ǻɫ 1ǰɫ
-						{
-							attribute=attribute+"black;";
-						}
-						else
+						double x=bazeir->getx(pt),y=bazeir->gety(pt);
+						if(existcm)
 						{
-							attribute=attribute+"white;";
+							x=transform(bazeir->getx(pt),bazeir->gety(pt),m.a,m.c,m.e);
+							y=transform(bazeir->getx(pt),bazeir->gety(pt),m.b,m.d,m.f);
 						}
+						writepoint(fout,"M",x,height-y);
+						beginx=bazeir->getx(pt);
+						beginy=bazeir->gety(pt);
+						penx=beginx;
+						peny=beginy;
+						pt+=3;
+						continue;
 					}
-					attribute+="); stroke:";
-					if(pdfpath->getscolorspace()==3||pdfpath->getscolorspace()==4)//ΪRGBռ
-					{
-						attribute=attribute+"rgb(";
-						attribute=attribute+toString(scolor.getr())+","+toString(scolor.getg())+","+toString(scolor.getb())+");";
-					}
-					else//Ϊڰ
+					for(n=0;n<3;n++,pt++)//Ƶյ
 					{
-						if(scolor.getG()==0)//0Ǻɫ 1ǰɫ
+						double x=bazeir->getx(pt),y=bazeir->gety(pt);
+						if(existcm)
 						{
-							attribute=attribute+"black;";
-						}
-						else
-						{
-							attribute=attribute+"white;";
+							x=transform(bazeir->getx(pt),bazeir->gety(pt),m.a,m.c,m.e);
+							y=transform(bazeir->getx(pt),bazeir->gety(pt),m.b,m.d,m.f);
 						}
+						if(n==0)
+							fout.write('C');
+						fout.writenumber(x);
+						fout.write(' ');
+						fout.writenumber(height-y);
+						fout.write(n==2?'\n':' ');
 					}
-					attribute=attribute+" stroke-width:";
-					attribute=attribute+toString(pdfpath->getlinewidth());//߿
-				}
-				
-				if(stack->getca()!=1)//͸ȲΪ1,͸
-				{
-					attribute=attribute+";opacity:"+toString(stack->getca());
-				}
-				
-				attribute=attribute+"\"";
-				//жǷתþ
-				/*
-				if(stack->getexistcm()>0)
-				{
-					attribute=attribute+" transform=\"matrix("+toString(stack->getmatrix()[0])+" "+toString(stack->getmatrix()[1])+" "+toString(stack->getmatrix()[2])+" "+toString(stack->getmatrix()[3])+" " +toString(stack->getmatrix()[4])+" "+toString((this->getrect().y1-this->getrect().y0)-stack->getmatrix()[5])+")\"";//(this->getrect().y1-this->getrect().y0)-  //˴дȶ,任ԭ֮任
+					penx=bazeir->getx(pt-1);
+					peny=bazeir->gety(pt-1);
 				}
-				
-				if(stack->getexistclip()==2)//żü·
-				{
-					attribute=attribute+" fill-rule=\"evenodd\" clip-rule=\"evenodd\"";
-				}
-				*/
-				attribute=attribute+"/>\n";
-				//cout<<"Դ׺:"<<attribute<<endl;
-				//graphiccell=pdfpath->getGraphicCell()->headler;
-				
+			}
+		}
+		fout.write(attribute.c_str(),(int)attribute.size());
+	}
+}
+
+static void setattribute(Ipe_SvgWriter& fout,string& attribute,Ipe_PdfPath* pdfpath)
+{
+	//ɫ,߿ʽȡʱҳʽ,ÿSVGԪֻöӦcss
+	attribute="\" class=\"s";
+	fout.appendnumber(attribute,pdfpath->getstyle());
+	attribute+="\"/>\n\n";
+}
+
+void Ipe_PdfPage::writeelements(Ipe_SvgWriter& fout,Ipe_LinkList<Ipe_PdfElement>* list,Ipe_ClipTable* clips,double height,string& attribute)
+{
+	int l=0;
+	Ipe_node<Ipe_PdfElement>* pointer=list->headler;//PDFԪصͷָ
+	Ipe_PdfStack* stack;
+	Ipe_PdfPath* pdfpath;
+	Ipe_node<class Ipe_PdfPath>* currentpdfpath;
+	Ipe_node<class Ipe_Plane>* plane;
+	while(pointer->next!=NULL)
+	{
+		pointer=pointer->next;//pointerָstackͷ
+		if(pointer->t->getelementtype()==1)//pdfҳԪصΪpath PS:жͼƬ
+		{
+			stack=static_cast<Ipe_PdfStack*>(pointer->t);//ɱȷ
+			writestack(fout,stack,clips,height);
+			currentpdfpath=stack->getpathlist()->headler;//ȡջpathϵͷ
+#ifdef debug
+			printf("ջ%d·\n",stack->getcountpath());
+#endif
+			for(l=0;l<stack->getcountpath();l++)//ջ·
+			{
+				currentpdfpath=currentpdfpath->next;
+				pdfpath=currentpdfpath->t;//ȫת
+				setattribute(fout,attribute,pdfpath);
 				
 				//pathбжǷ·
 				plane=pdfpath->getPlane()->headler;
 				while(plane->next!=NULL)//еÿԪؽб
 				{
 					plane=plane->next;
-					//printf("Ԫ");
-					if(plane->t->getisplane()==false)//Ϊպϵ,Ϊһϵ·
-					{
-						graphiccell=plane->t->getlist()->headler;
-						//printf("planeڲGraphiccell:%d\n",plane->t->getgraphicellcount());
-						for (j=0;j<plane->t->getgraphicellcount();j++)
-						{
-							graphiccell=graphiccell->next;
-							if (graphiccell->t->gettype()==1)//0- 1-ֱ߼ 2-߼
-							{
-								lines=dynamic_cast <Ipe_Lines*>(graphiccell->t);//תͳΪֱ߼
-								Ipe_node<Ipe_Point2D>* points=lines->getlist()->headler;
-								fout<<"<path d=\"";//һ·
-								char order;
-								for(k=0;k<lines->getnum();k++)
-								{
-		//#ifdef debug
-									//printf("%f %f\n",this->getrect().y0,this->getrect().y1);
-		//#endif
-									points=points->next;
-									switch (points->t->getstate())//m,l,h,c״̬(ֱӦ0123
-									{
-										case 0:
-											order='M';
-											break;
-										case 1:
-											order='L';
-											break;
-									}
-									//if(stack->getexistcm()==0)
-									//{
-										fout<<order<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";//ҪдSVGļҳϽΪԭģҪyᷴ
-										//fout1<<points->t->getx()<<","<<points->t->gety()<<"------"<<points->t->getx()<<","<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" \n";
-									//}
-									/*
-									else //תþ
-									{
-										fout<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<","<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										//fout1<<points->t->getx()<<","<<points->t->gety()<<"------"<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<","<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" \n";
-									}
-									*/
-								}
-								fout<<attribute;
-								fout<<endl;
-							}
-							else//߼ ڸ
-							{
-								bazeir=dynamic_cast<Ipe_Bazeir*>(graphiccell->t);//תͳΪ߼
-								Ipe_node<Ipe_Point2D>* points=bazeir->getlist()->headler;
-								fout<<"<path d=\"";
-								//printf("ߵ:%d\n",bazeir->getnum());
-								//printf("%s\n",attribute);
-								if(bazeir->getnum()!=0)
-								{
-									points=points->next;
-									fout<<"M"<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";//
-									points=points->next;
-									points=points->next;
-									points=points->next;
-								}
-								for(k=0;k<bazeir->getnum()-1;k++)
-								{
-									//if(stack->getexistcm()==0)
-									//{
-										fout<<"C"<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";
-										points=points->next;
-										fout<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";
-										points=points->next;
-										fout<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<"\n";
-										points=points->next;
-									//}
-									/*
-									else
-									{
-										fout<<"C"<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										points=points->next;
-										fout<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										points=points->next;
-										fout<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<"\n";
-										points=points->next;
-									}
-									*/
-								}
-								fout<<attribute;
-								fout<<endl;
-							}
-						}
-					}
-					else//һպϵ,ʱSVGʱҪһеһ·γһյ
-					{
-						//printf("һպϵ\n");
-						fout<<"<path d=\"";
-						graphiccell=plane->t->getlist()->headler;
-						bool firsttime=true;
-						double beginx,beginy;
-						//for (j=0;j<plane->t->getgraphicellcount();j++)
-						while(graphiccell->next!=NULL)
-						{
-							graphiccell=graphiccell->next;
-							if (graphiccell->t->gettype()==1)//0- 1-ֱ߼ 2-߼
-							{
-								//printf("ֱ߼\n");
-								lines=dynamic_cast <Ipe_Lines*>(graphiccell->t);//תͳΪֱ߼
-								Ipe_node<Ipe_Point2D>* points=lines->getlist()->headler;
-								//printf("ֱ߼еĸ:%d\n",lines->getnum());
-								for(k=0;k<lines->getnum();k++)
-								{
-									string order;
-									points=points->next;
-									//printf("%f %f %d\n",points->t->getx(),points->t->gety(),points->t->getstate());
-									if(points->t->getstate()==0)
-									{
-										//printf("%d",firsttime);
-										/*if(firsttime==true)
-										{
-											order="M";
-											firsttime=false;
-											beginx=points->t->getx();
-											beginy=points->t->gety();
-											//printf("бע\n");
-										}
-										else
-										{
-											
-										}
-										*/
-										order="M";
-										beginx=points->t->getx();
-										beginy=points->t->gety();
-									}
-									else // if(points->t->getstate()==1)//m,l,h,c״̬(ֱӦ0123
-									{
-										order="L";
-									}
-									//printf("ջתþ״̬:%d\n",stack->getexistcm());
-									if(stack->getexistcm()==0)
-									{
-										//printf("תþ\n");
-										if(points->t->getstate()==2)
-										fout<<order<<beginx<<" "<<(this->getrect().y1-this->getrect().y0)-beginy<<" ";
-										else
-										{
-											fout<<order<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";//ҪдSVGļҳϽΪԭģҪyᷴ
-											//cout<<order<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<endl;
-										//fout1<<points->t->getx()<<","<<points->t->gety()<<"------"<<points->t->getx()<<","<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" \n";
-									
-										}
-									}
-									/*
-									else //תþ
-									{
-										if(points->t->getstate()==2)//պָ,ص
-										fout<<order<<transform(beginx,beginy,stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(beginx,beginy,stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										else
-										fout<<order<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										//fout1<<points->t->getx()<<","<<points->t->gety()<<"------"<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<","<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" \n";
-									}
-									*/
-								}
-								//fout<<attribute;
-								//fout<<endl;
-							}
-							else//߼ ڸ
-							{
-								bazeir=dynamic_cast<Ipe_Bazeir*>(graphiccell->t);//תͳΪ߼
-								Ipe_node<Ipe_Point2D>* points=bazeir->getlist()->headler;
-								points=points->next;
-								if(stack->getexistcm()==0)
-								{
-									if(firsttime==true)
-									{
-										firsttime=false;
-										fout<<"M"<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";//
-										beginx=points->t->getx();
-										beginy=points->t->gety();
-									}
-								}
-								else
-								{
-									if(firsttime==true)
-									{
-										firsttime=false;
-										fout<<"M"<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										beginx=points->t->getx();
-										beginy=points->t->gety();
-									}
-								}
-								points=points->next;
-								points=points->next;
-								points=points->next;
-								for(k=0;k<bazeir->getnum()-1;k++)
-								{
-									if(stack->getexistcm()==0)
-									{
-										fout<<"C"<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";
-										points=points->next;
-										fout<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<" ";
-										points=points->next;
-										fout<<points->t->getx()<<" "<<(this->getrect().y1-this->getrect().y0)-points->t->gety()<<"\n";
-										points=points->next;
-									}
-									else
-									{
-										fout<<"C"<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										points=points->next;
-										fout<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<" ";
-										points=points->next;
-										fout<<transform(points->t->getx(),points->t->gety(),stack->getmatrix()[0],stack->getmatrix()[2],stack->getmatrix()[4])<<" "<<(this->getrect().y1-this->getrect().y0)-transform(points->t->getx(),points->t->gety(),stack->getmatrix()[1],stack->getmatrix()[3],stack->getmatrix()[5])<<"\n";
-										points=points->next;
-									}
-								}
-								//fout<<attribute;
-								//fout<<endl;
-							}
-						}
-						fout<<attribute;
-						fout<<endl;
-					}
+					writeplane(fout,plane->t->getlist(),plane->t->getisplane(),stack,height,attribute);
 				}
-				
 			}
 			if(stack->getexistclip()>0)
 			{
-				fout<<"</g>";
+				fout.write("</g>");
 			}
 		}
-		
+	}
+}
 
+void Ipe_PdfPage::writedefs(Ipe_SvgWriter& fout,double height,string& attribute)
+{
+	this->styles->writecss(fout);//ҳʽֻһ
+	this->clips->writedefs(fout,height);//ÿͬĲü·ֻһ
+	Ipe_node<Ipe_PdfXobject>* x=this->xobjects->headler;
+	while(x->next!=NULL)//ÿֻһ,㰴ϵ,yȡ,ʵ<use>
+	{
+		x=x->next;
+		x->t->getclips()->writedefs(fout,0);
+		fout.write("<defs><symbol id=\"x");
+		fout.writeint(x->t->getnum());
+		fout.write("\" overflow=\"visible\">\n");
+		writeelements(fout,x->t->getelement(),x->t->getclips(),0,attribute);
+		fout.write("</symbol></defs>\n");
 	}
-	if((crect.x0!=0)||(crect.x1!=0)||(crect.y0!=0)||(crect.y1!=0))
+	Ipe_node<Ipe_PdfPattern>* p=this->patterns->headler;
+	while(p->next!=NULL)//ÿͼֻһͼԪ,<pattern>ƽ,ҳʹõͼҳ,ͼʹõԾֲϵ
 	{
-		fout<<"<rect x=\""<<crect.x0<<"\" y=\""<<this->rect.y1-crect.y0<<"\" width=\""<<crect.x1-crect.x0<<"\" height=\""<<crect.y0-crect.y1<<"\" style=\"fill:none; stroke:rgb(0,0,255);\"/>"<<endl;
-	
+		p=p->next;
+		double pheight=p->t->getnested()?0:height;
+		p->t->getclips()->writedefs(fout,0);
+		fout.write("<defs>");
+		p->t->writeopen(fout,pheight);
+		writeelements(fout,p->t->getelement(),p->t->getclips(),0,attribute);
+		fout.write("</pattern></defs>\n");
 	}
-	fout<<"</svg>";
+}
+
+void Ipe_PdfPage::pagetoSVG(char* path,int decimals)//һҳΪsvg
+{
+	double height=this->getrect().y1-this->getrect().y0;//SVGļҳϽΪԭ,Ҫyᷴ
+	string attribute;//ÿpath,ҳظʹͬһռ
+	attribute.reserve(256);
+	Ipe_SvgWriter fout;
+	fout.setdecimals(decimals);
+	if(!fout.open(path))
+	{
+		printf("޷SVGļ:%s\n",path);
+		return;
+	}
+	//дļͷ
+	fout.write("<?xml version=\"1.0\" standalone=\"no\"?>\n\n<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \n\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n <svg width=\"100%\" height=\"100%\" version=\"1.1\" viewBox=\" ");
+	fout.writenumber(this->rect.x0);
+	fout.write(' ');
+	fout.writenumber(this->rect.y0);
+	fout.write(' ');
+	fout.writenumber(this->rect.x1);
+	fout.write(' ');
+	fout.writenumber(this->rect.y1);
+	fout.write("\" xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n");
+	writedefs(fout,height,attribute);
+	writeelements(fout,this->list,this->clips,height,attribute);
+	fout.write("</svg>");
 	fout.close();
-	//fout1.close();
 }
 
-void Ipe_PdfPage::clipwithrect(cliprect *rect)//ü
+Ipe_PageView* Ipe_PdfPage::getview()
+{
+	return new Ipe_PageView(this);
+}
+
+Ipe_PageIndex* Ipe_PdfPage::getindex()
+{
+	if(this->index==NULL)
+		this->index=new Ipe_PageIndex(this);
+	return this->index;
+}
+
+Ipe_PageView* Ipe_PdfPage::clipwithrect(cliprect *rect)//ü,ҳ治,Ϊҳ֮ϵͼ
 {
 	if(rect->x0>rect->x1||rect->y0<rect->y1)
 	{
 		printf("βϱ׼");
-		return;
+		return NULL;
 	}
-	crect.x0=rect->x0;
-	crect.x1=rect->x1;
-	crect.y0=rect->y0;
-	crect.y1=rect->y1;
-	Ipe_node<Ipe_PdfElement>* current;
-	current=this->list->headler;
-	while(current->next!=NULL)//ջ
+	std::vector<int> hits;
+	getindex()->search(rect->x0,rect->y1,rect->x1,rect->y0,hits);//ֻȡðΧ봰ཻ,ҳ˳
+	Ipe_PageTile* tile=new Ipe_PageTile(this,rect);
+	Ipe_Plane* last=NULL;
+	for(size_t i=0;i<hits.size();i++)
 	{
-		current=current->next;
-		if(current->t->getelementtype()==1)//Ϊ1,Ϊͼβ
+		struct indexitem* e=this->index->get(hits[i]);
+		if(e->plane==NULL)//ʵ
 		{
-			Ipe_PdfStack* stack;
-			stack=dynamic_cast<Ipe_PdfStack*>(current->t);//̬ת
-			Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;//ȡPath
-			while(pathlist->next!=NULL)//ջ·
-			{
-				pathlist=pathlist->next;
-				Ipe_node <Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;//ȡõͼҪͷ
-				while(cplane->next!=NULL)//ͼҪ,,
-				{
-					cplane=cplane->next;
-					Ipe_Plane *plane=cplane->t;
-					if(plane->getisplane())//жϵͼҪ,Ƿ·
-					{
-						//printf("ü\n");
-						Ipe_node<class Ipe_GraphicCell>* cgc=plane->getlist()->headler;
-						//·һֱ/߼,вüԼ벿ֱߵӲ
-						Ipe_LinkList<Ipe_GraphicCell>* list=plane->getlist();
-						plane->setlist(clipplane(list,rect));//µֱ߼list
-						//
-						Ipe_node<class Ipe_GraphicCell> *p=plane->getlist()->headler->next;
-						Ipe_Lines *k=dynamic_cast<Ipe_Lines*>(p->t);
-						Ipe_node<Ipe_Point2D>*cp=k->getlist()->headler;
-						/*printf("ü:\n");
-						while(cp->next!=NULL)
-						{
-							cp=cp->next;
-							printf("%f %f %d\n",cp->t->getx(),cp->t->gety(),cp->t->getstate());
-						}	
-						*/
-					}
-					else//·
-					{
-						Ipe_node<class Ipe_GraphicCell>* cgc=plane->getlist()->headler;
-						while(cgc->next!=NULL)//·еֱ߼߼
-						{
-							cgc=cgc->next;
-							Ipe_GraphicCell* graphiccell=cgc->t;
-							if(graphiccell->gettype()==1)//1-ֱ߼ 
-							{
-								Ipe_Lines * lines=dynamic_cast<Ipe_Lines*>(graphiccell);//תΪlinesֱ߼
-								//ֱ߼ıü
-								Ipe_Lines* newlines=cliplines(lines,rect);//µĽڵָ
-								delete lines;
-								cgc->t=newlines;
-								//printf("ֱ߼е:%d\n",newlines->getnum());
-								//printf("%f %f\n",newlines->getlist()->headler->next->t->getx(),newlines->getlist()->headler->next->t->gety());
-							}
-							else if(graphiccell->gettype()==2)//2-߼
-							{
-								Ipe_Bazeir* bazeir=dynamic_cast<Ipe_Bazeir*>(graphiccell);//תΪ߼
-								//߼ıü
-								//printf("߲ü\n");
-								Ipe_Bazeir* newbazeir=clipbazeir(bazeir,rect);
-								delete bazeir;
-								cgc->t=newbazeir;
-								//printf("new bazeir size:%d",newbazeir->getnum());
-							}
-							else//0-
-							{
-								printf("δʼGraphicCell\n");
-							}
-						}
-					}
-				}
-			}
+			tile->add(e->stack,NULL,NULL,true);
+			continue;
 		}
+		if(e->plane==last)//ͬһҪصֱ߼߼
+			continue;
+		last=e->plane;
+		double box[4];
+		e->plane->getbound(box);
+		tile->add(e->stack,e->path,e->plane,boxinside(box,rect));
 	}
+	clipbuffer buffer;
+	initclipbuffer(&buffer);
+	tile->cliprouted(&buffer);
+	freeclipbuffer(&buffer);
+	return tile;
 	/*
 	1.ڵ,ǷֻǷ
 
@@ -797,3 +766,251 @@ void Ipe_PdfPage::clipwithrect(cliprect *rect)//
 	*/
 }
 
+
+struct tilegrid//,ڰȴϵ,Ҵ
+{
+	cliprect rect;
+	int columns;
+	int rows;
+	double width;//ڵĿ
+	double height;
+};
+
+static int gridindex(double v,double size,int n)//ڵл,Χȡϵ
+{
+	int i=(int)floor(v/size);
+	if(i<0)
+		return 0;
+	if(i>=n)
+		return n-1;
+	return i;
+}
+
+static void routebox(Ipe_PdfStack* stack,Ipe_PdfPath* path,Ipe_Plane* plane,const double* box,Ipe_PageTile** tiles,int count,struct tilegrid* grid)//ҪػʵΧཻ֮Ĵ
+{
+	if(grid==NULL)//ⴰб,Ƚ
+	{
+		for(int i=0;i<count;i++)
+		{
+			cliprect r=tiles[i]->getrect();
+			if(boxoverlap(box,&r))
+				tiles[i]->add(stack,path,plane,boxinside(box,&r));
+		}
+		return;
+	}
+	if(!boxoverlap(box,&grid->rect))//ֱǵзΧ
+		return;
+	int c0=gridindex(box[0]-grid->rect.x0,grid->width,grid->columns);
+	int c1=gridindex(box[2]-grid->rect.x0,grid->width,grid->columns);
+	int r0=gridindex(grid->rect.y0-box[3],grid->height,grid->rows);
+	int r1=gridindex(grid->rect.y0-box[1],grid->height,grid->rows);
+	for(int r=r0;r<=r1;r++)
+	{
+		for(int c=c0;c<=c1;c++)
+		{
+			Ipe_PageTile* tile=tiles[r*grid->columns+c];
+			cliprect rect=tile->getrect();
+			tile->add(stack,path,plane,boxinside(box,&rect));
+		}
+	}
+}
+
+static void routeelements(Ipe_PdfPage* page,Ipe_PageTile** tiles,int count,struct tilegrid* grid)//ҳһ,ΧаҪطַ
+{
+	Ipe_LinkList<Ipe_PdfElement>* list=page->getelement();
+	double box[4];
+	Ipe_node<Ipe_PdfElement>* current=list->headler;
+	while(current->next!=NULL)//ջ
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		if(stack->getxobject()!=0&&page->getinstancebound(stack,box))//ʵ任İΧзַ,ɴڵviewBoxȡ;ձַ
+			routebox(stack,NULL,NULL,box,tiles,count,grid);
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)//ջ·
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)//ͼҪ
+			{
+				cplane=cplane->next;
+				if(cplane->t->getbound(box))
+					routebox(stack,pathlist->t,cplane->t,box,tiles,count,grid);
+			}
+		}
+	}
+}
+
+struct Ipe_TileJob
+{
+	Ipe_PageTile** tiles;
+	int count;
+	int nexttile;//һȡĴ
+	Ipe_Mutex mutex;
+};
+
+static IPE_THREAD_RETURN tileworker(void* arg)
+{
+	Ipe_TileJob* job=(Ipe_TileJob*)arg;
+	clipbuffer buffer;//ÿ߳һü,֮ظʹ
+	int i;
+	initclipbuffer(&buffer);
+	while(true)
+	{
+		Ipe_MutexLock(&job->mutex);
+		i=job->nexttile++;
+		Ipe_MutexUnlock(&job->mutex);
+		if(i>=job->count)
+			break;
+		job->tiles[i]->cliprouted(&buffer);//ڸԼļδ洢,ԭҳֻ
+	}
+	freeclipbuffer(&buffer);
+	return 0;
+}
+
+static void cliptiles(Ipe_PageTile** tiles,int count,int threadcount)//̲߳üд
+{
+	Ipe_TileJob job;
+	int i;
+	if(threadcount<=0)
+		threadcount=Ipe_CpuCount();
+	if(threadcount>count)
+		threadcount=count;
+	job.tiles=tiles;
+	job.count=count;
+	job.nexttile=0;
+	Ipe_MutexInit(&job.mutex);
+	Ipe_Thread* threads=new Ipe_Thread[threadcount];
+	bool* started=new bool[threadcount];
+	for(i=0;i<threadcount;i++)
+		started[i]=Ipe_ThreadStart(&threads[i],tileworker,&job);
+	for(i=0;i<threadcount;i++)
+	{
+		if(started[i])
+			Ipe_ThreadJoin(threads[i]);
+	}
+	if(job.nexttile<job.count)//ûܹ߳,ڵǰ߳
+		tileworker(&job);
+	delete[] started;
+	delete[] threads;
+	Ipe_MutexDestroy(&job.mutex);
+}
+
+Ipe_PageTile** Ipe_PdfPage::clipwithrects(cliprect* rects,int count,int threadcount)
+{
+	int i;
+	if(count<=0)
+		return NULL;
+	for(i=0;i<count;i++)
+	{
+		if(rects[i].x0>rects[i].x1||rects[i].y0<rects[i].y1)
+		{
+			printf("βϱ׼");
+			return NULL;
+		}
+	}
+	Ipe_PageTile** tiles=new Ipe_PageTile*[count];
+	for(i=0;i<count;i++)
+		tiles[i]=new Ipe_PageTile(this,&rects[i]);
+	routeelements(this,tiles,count,NULL);
+	cliptiles(tiles,count,threadcount);
+	return tiles;
+}
+
+Ipe_PageTile** Ipe_PdfPage::clipwithgrid(cliprect* rect,int columns,int rows,int threadcount)
+{
+	if(rect->x0>rect->x1||rect->y0<rect->y1||columns<=0||rows<=0)
+	{
+		printf("βϱ׼");
+		return NULL;
+	}
+	struct tilegrid grid;
+	grid.rect=*rect;
+	grid.columns=columns;
+	grid.rows=rows;
+	grid.width=(rect->x1-rect->x0)/(double)columns;
+	grid.height=(rect->y0-rect->y1)/(double)rows;
+	int count=columns*rows;
+	Ipe_PageTile** tiles=new Ipe_PageTile*[count];
+	for(int r=0;r<rows;r++)
+	{
+		for(int c=0;c<columns;c++)
+		{
+			cliprect t;
+			t.x0=(float)(rect->x0+c*grid.width);
+			t.x1=c==columns-1?rect->x1:(float)(rect->x0+(c+1)*grid.width);//һһȡ߽,
+			t.y0=(float)(rect->y0-r*grid.height);
+			t.y1=r==rows-1?rect->y1:(float)(rect->y0-(r+1)*grid.height);
+			tiles[r*columns+c]=new Ipe_PageTile(this,&t);
+		}
+	}
+	routeelements(this,tiles,count,&grid);
+	cliptiles(tiles,count,threadcount);
+	return tiles;
+}
+
+void Ipe_PdfPage::viewtoSVG(Ipe_PageView* view,char* path,int decimals)
+{
+	double height=this->getrect().y1-this->getrect().y0;
+	cliprect r;
+	string attribute;
+	attribute.reserve(256);
+	Ipe_SvgWriter fout;
+	fout.setdecimals(decimals);
+	if(!fout.open(path))
+	{
+		printf("޷SVGļ:%s\n",path);
+		return;
+	}
+	fout.write("<?xml version=\"1.0\" standalone=\"no\"?>\n\n<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \n\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n <svg width=\"100%\" height=\"100%\" version=\"1.1\" viewBox=\" ");
+	if(view->getwindow(&r))//viewBoxȡڷΧ,ıʵͼص
+	{
+		fout.writenumber(r.x0);
+		fout.write(' ');
+		fout.writenumber(height-r.y0);
+		fout.write(' ');
+		fout.writenumber(r.x1-r.x0);
+		fout.write(' ');
+		fout.writenumber(r.y0-r.y1);
+	}
+	else
+	{
+		fout.writenumber(this->rect.x0);
+		fout.write(' ');
+		fout.writenumber(this->rect.y0);
+		fout.write(' ');
+		fout.writenumber(this->rect.x1);
+		fout.write(' ');
+		fout.writenumber(this->rect.y1);
+	}
+	fout.write("\" xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n");
+	writedefs(fout,height,attribute);
+	Ipe_PdfStack* stack=NULL;
+	Ipe_PdfPath* pdfpath=NULL;
+	for(int i=0;i<view->getcount();i++)//Ҫذҳ˳,ͬһջҪ
+	{
+		struct viewplane* e=view->get(i);
+		if(e->stack!=stack)
+		{
+			if(stack!=NULL&&stack->getexistclip()>0)
+				fout.write("</g>");
+			stack=e->stack;
+			pdfpath=NULL;
+			writestack(fout,stack,this->clips,height,e->plane==NULL);//չʵջԼҪ
+		}
+		if(e->plane==NULL)
+			continue;
+		if(e->path!=pdfpath)
+		{
+			pdfpath=e->path;
+			setattribute(fout,attribute,pdfpath);
+		}
+		writeplane(fout,e->cells,e->plane->getisplane(),stack,height,attribute);
+	}
+	if(stack!=NULL&&stack->getexistclip()>0)
+		fout.write("</g>");
+	fout.write("</svg>");
+	fout.close();
+}
@@ -4,11 +4,30 @@
 #include "Ipe_PdfPath.h"
 #include "MuInclude.h"
 #include "clipfunction.h"
+#include "Ipe_Geometry.h"
+#include "Ipe_StyleTable.h"
+#include "Ipe_ClipTable.h"
+#include "Ipe_PdfXobject.h"
+#include "Ipe_PdfPattern.h"
+#include "Ipe_SvgWriter.h"
+#include "Ipe_PageTile.h"
+#include "Ipe_PageIndex.h"
 class EX_PORT Ipe_PdfPage
 {
 	fz_rect rect;//ҳ淶Χ ˴ɴ޸
 	Ipe_LinkList<Ipe_PdfElement>* list;//ҳԪ ·xobject
 	int graphiccellcount;//¼ҳԪ
+	Ipe_Geometry* geometry;//ҳ·ü·ĵ,ֱ߼߼еͼ
+	Ipe_StyleTable* styles;//ҳ·ʽ,·ֻ¼±
+	Ipe_ClipTable* clips;//ҳĲü·,ջֻ¼±
+	Ipe_LinkList<Ipe_PdfXobject>* xobjects;//ҳõıXObject,ÿֻһ
+	Ipe_LinkList<Ipe_PdfPattern>* patterns;//ҳõƽͼ,ÿͼֻһͼԪ
+	Ipe_PageIndex* index;//ҪصĿռ,һβѯʱ
+	void writeelements(Ipe_SvgWriter& fout,Ipe_LinkList<Ipe_PdfElement>* list,Ipe_ClipTable* clips,double height,std::string& attribute);//һջ,yΪheight-y,<symbol>heightΪ0
+	void boundxobject(class Ipe_PdfXobject* xobject);
+	void writestack(Ipe_SvgWriter& fout,class Ipe_PdfStack* stack,Ipe_ClipTable* clips,double height,bool use=true);//ջĲü鿪ͷʵ,useΪfalseʱʵչΪҪ,<use>
+	void writeplane(Ipe_SvgWriter& fout,Ipe_LinkList<Ipe_GraphicCell>* cells,bool isplane,class Ipe_PdfStack* stack,double height,std::string& attribute);//һͼҪصֱ߼߼
+	void writedefs(Ipe_SvgWriter& fout,double height,std::string& attribute);//ʽ,ü·,ͼĶ
 public:
 	Ipe_PdfPage(void);
 	Ipe_PdfPage(zblrouteset* routeset);//ʼҳ
@@ -19,10 +38,24 @@ public:
 	inline float transform(float x,float y,float a,float b,float c){
 		//printf("\nתþ:x=%f y=%f a=%f b=%f c=%f\n",x,y,a,b,c);
 		return a*x+b*y+c;};//,ڽо
-	void pagetoSVG(char* path);//SVGĺ
+	void pagetoSVG(char* path,int decimals=3);//SVGĺ,decimalsΪ걣Сλ,С0ʱܾȷԭʽ
 	fz_rect getrect();
 	void setrect(fz_rect rect);
 	void maketransform(); //ҳڲ,תþ
-	void clipwithrect(cliprect *myrect);//ʹøСľζģͽвü
+	void makebounds();//㲢·,ͼҪ,ֱ߼߼İΧ,ȡʱڱ任֮
+	Ipe_PageView* getview();//ҳ汾ͼ,releaseͷ
+	Ipe_PageView* clipwithrect(cliprect *myrect);//ʹøСľβü,ҳ治,زüͼ,releaseͷ;ɿռֻȡཻҪ
+	Ipe_PageIndex* getindex();//ȡÿռ,ûʱ;,̲߳ѯǰһ߳еһ
+	Ipe_PageTile** clipwithrects(cliprect* rects,int count,int threadcount=0);//һαҳü,ҳ治;count,releasedelete[];threadcount<=0ʱȡCPU
+	Ipe_PageTile** clipwithgrid(cliprect* rect,int columns,int rows,int threadcount=0);//rectΪrowscolumnsеĴ,ȴϵ·,Χֱӻ,Ƚ
+	void viewtoSVG(Ipe_PageView* view,char* path,int decimals=3);//ҳһͼΪsvg,ʽ붨ȡԱҳ,ڲüԴΪviewBox
+	size_t getmemsize();//ҳģռõڴ,ҳ滺
+	Ipe_Geometry* getgeometry();//ȡҳ漸δ洢,ֱӶȡ
+	Ipe_StyleTable* getstyles();//ȡҳʽ
+	Ipe_ClipTable* getclips();//ȡҳü·
+	Ipe_LinkList<Ipe_PdfXobject>* getxobjects();//ȡñҳıXObject
+	Ipe_PdfXobject* findxobject(int num);//Ųұ,ûʱNULL
+	bool getinstancebound(class Ipe_PdfStack* stack,double* box);//ʵϵеİΧ:(Ƕʵ)İΧоʵ任;ûеʱfalse
+	Ipe_LinkList<Ipe_PdfPattern>* getpatterns();//ȡñҳƽͼ
 };
 
@@ -1,245 +1,68 @@
 #include "Ipe_PdfPath.h"
+#include "Ipe_CellBuilder.h"
 
 
 Ipe_PdfPath::Ipe_PdfPath(void)
 {
+	this->styles=NULL;
+	this->style=0;
+	this->boundvalid=false;
 }
 
-Ipe_PdfPath::Ipe_PdfPath(zblroute* route)//ʼPathzblrouteṹȡ
+Ipe_PdfPath::Ipe_PdfPath(zblroute* route,Ipe_Geometry* store,Ipe_StyleTable* styles,float ca)//ʼPathzblrouteṹȡ,ŵҳļδ洢store
 {
-	int i=0,state=0,first=0;//ǰ״̬
-	double currentx,currenty,originx,originy;
 	drawingmethord=route->drawingmethord;//Ʒ 1-S 2-f* 3-f/F 4-s 5-B 6-B* 7-b 8-b*
 	//printf("drawingmethord::%d\n",drawingmethord);
 	GraphicsCellCount=0;
 	pathtype=route->type;
-	linewidth=route->linewidth;
-	if(this->drawingmethord<5)//ͿĨ
-	{
-		colorspace=route->colorspace;
-		this->scolor=NULL;
-		this->scolorspace=0;
-		//printf("this->existcm=%d\n\n",route->existcm);
-		if(colorspace==1||colorspace==2)//Ҷȿռ
-		{
-			color.setColor(-1,-1,-1,-1,route->color[0]);
-		}
-		else if(colorspace==3||colorspace==4)//RGBɫռ
-		{
-			color.setColor(route->color[0],route->color[1],route->color[2],-1,-1);
-			//printf("ɫ:%d %d %d\n",color.getr(),color.getg(),color.getb());
-		}
-		else if(colorspace==5||colorspace==6)//cmykɫռ
-		{
-			colorspace=3;
-			color.setCmykColor(255*(100-route->color[0]*100)*(100-route->color[3]*100)/10000,255*(100-route->color[1]*100)*(100-route->color[3]*100)/10000,255*(100-route->color[2]*100)*(100-route->color[3]*100)/10000,-1,-1);
-			//printf("CMYK:%f %f %f %fתΪRGB:%d %d %d",route->color[0],route->color[1],route->color[2],route->color[3],color.getr(),color.getg(),color.getb());
-		}
-	}
-	else//ͿĨ,ɫ,ͿĨ
-	{
-		//printf("ɫ\n");
-		colorspace=route->colorspace;//
-		scolorspace=route->scolorspace;//
-		this->scolor=new Ipe_Color();
-		if(colorspace==1||colorspace==2)//Ҷȿռ
-		{
-			color.setColor(-1,-1,-1,-1,route->color[0]);
-		}
-		else if(colorspace==3||colorspace==4)//RGBɫռ
-		{
-			color.setColor(route->color[0],route->color[1],route->color[2],-1,-1);
-			//printf("ɫ:%d %d %d\n",color.getr(),color.getg(),color.getb());
-		}
-		else if(colorspace==5||colorspace==6)//cmykɫռ
-		{
-			colorspace=3;
-			color.setCmykColor(255*(100-route->color[0]*100)*(100-route->color[3]*100)/10000,255*(100-route->color[1]*100)*(100-route->color[3]*100)/10000,255*(100-route->color[2]*100)*(100-route->color[3]*100)/10000,-1,-1);
-			//printf("CMYK:%f %f %f %fתΪRGB:%d %d %d",route->color[0],route->color[1],route->color[2],route->color[3],color.getr(),color.getg(),color.getb());
-		}
-		//printf("scolorspace=%d\n",scolorspace);
-		if(scolorspace==1||scolorspace==2)//Ҷȿռ
-		{
-			scolor->setColor(-1,-1,-1,-1,route->color[0]);
-		}
-		else if(scolorspace==3||scolorspace==4)//RGBɫռ
-		{
-			scolor->setColor(route->scolor[0],route->scolor[1],route->scolor[2],-1,-1);
-			//printf("ɫ:%d %d %d\n",color.getr(),color.getg(),color.getb());
-		}
-		else if(scolorspace==5||scolorspace==6)//cmykɫռ
-		{
-			scolorspace=3;
-			scolor->setCmykColor(255*(100-route->scolor[0]*100)*(100-route->scolor[3]*100)/10000,255*(100-route->scolor[1]*100)*(100-route->scolor[3]*100)/10000,255*(100-route->scolor[2]*100)*(100-route->scolor[3]*100)/10000,-1,-1);
-			//printf("CMYK:%f %f %f %fתΪRGB:%d %d %d",route->color[0],route->color[1],route->color[2],route->color[3],color.getr(),color.getg(),color.getb());
-		}
-	}
+	//ɫ,߿״̬ҳʽ,ͬʽֻһ
+	this->styles=styles;
+	this->style=styles->intern(Ipe_PdfStyle(route,ca));
 	/*
 	zblrouteṹеֵתΪͼҪض󲢴洢list
 	*/
 	this->list=new Ipe_LinkList<Ipe_Plane>();
-	Ipe_Lines* lines=new Ipe_Lines();//ֱ߼
-	Ipe_Bazeir* bazeir=new Ipe_Bazeir();//߶
+	this->boundvalid=false;
+	Ipe_CellBuilder builder(store);//m,l,h,cΪֱ߼߼,ü·
+	Ipe_GraphicCell* cell;
 	route->currentpoint=route->pointheadler;
-	//Ipe_Point2D* origin=new Ipe_Point2D(0,0);//
-	Ipe_Plane* plane=new Ipe_Plane();//½ʵ
-	while(route->currentpoint->nextpoint!=NULL)//㿪ʼʼstate=0ʾȷֱ߼ϻǱ߼
+	Ipe_Plane* plane=new Ipe_Plane(store);//½ʵ
+	while(route->currentpoint->nextpoint!=NULL)
 	{
 		route->currentpoint=route->currentpoint->nextpoint;
-
-		if(state==0)//ʼ״̬Ϊ0
-		{
-			if(route->currentpoint->state==0)
-			{
-				originx=route->currentpoint->p0;
-				originy=route->currentpoint->p1;
-				currentx=route->currentpoint->p0;
-				currenty=route->currentpoint->p1;
-				continue;
-			}
-			else if(route->currentpoint->state==1)//m,l,h,c״̬(ֱӦ0123
-			{
-				
-				state=1;
-				lines->addpoint(originx,originy,0);//
-				//printf("\n·:%d,%d\n",originx,originy);
-				lines->addpoint(route->currentpoint->p0,route->currentpoint->p1,1);//ӵǰ
-
-				//printf("ȷһֱ߼״̬\n");
-				//printf("·һ\n");
-				//printf(":%f %f\nһ:%f %f ",originx,originy,route->currentpoint->p0,route->currentpoint->p1);
-
-				currentx=route->currentpoint->p0;
-				currenty=route->currentpoint->p1;
-				continue;
-			}
-			else if(route->currentpoint->state==3)//
-			{
-				//printf("ȷһ߼״̬\n");
-				state=2;
-				bazeir->addpoint(originx,originy,-1,-1,-1,-1,0);
-				bazeir->addpoint(route->currentpoint->p0,route->currentpoint->p1,route->currentpoint->p2,route->currentpoint->p3,route->currentpoint->p4,route->currentpoint->p5,3);
-				currentx=route->currentpoint->p0;
-				currenty=route->currentpoint->p1;
-				continue;
-			}
-		}
-
-		if(state==1)//ֱ߼
+		struct routepoint* p=route->currentpoint;
+		cell=builder.addpoint((int)p->state,p->p0,p->p1,p->p2,p->p3,p->p4,p->p5);
+		if(cell==NULL)
+			continue;
+		plane->getlist()->add(cell);
+		plane->addgraphiccellcount();
+		if(!builder.isclosed())//ֱ߽,ͬһ
 		{
-			if(route->currentpoint->state==1)//Ϊlint to
-			{
-				lines->addpoint(route->currentpoint->p0,route->currentpoint->p1,1);//ֱߵӽȥ
-
-				//printf("ֱ·%f %f\n",route->currentpoint->p0,route->currentpoint->p1);
-
-				currentx=route->currentpoint->p0;
-				currenty=route->currentpoint->p1;
-				continue;
-			}
-			else if(route->currentpoint->state==3)//Ϊc ʱ,ֱӽlist,ȻͷŲ·lines,Ϊ´׼
-			{
-				plane->getlist()->add(lines);
-				plane->addgraphiccellcount();
-				GraphicsCellCount++;
-				//delete lines;
-				lines=new Ipe_Lines();//·ֱ߼,Ϊ´׼
-				bazeir->addpoint(currentx,currenty,-1,-1,-1,-1,0);//߼
-				originx=currentx;
-				originy=currenty;
-				bazeir->addpoint(route->currentpoint->p0,route->currentpoint->p1,route->currentpoint->p2,route->currentpoint->p3,route->currentpoint->p4,route->currentpoint->p5,3);
-				//ӵǰ
-				state=2;//ı״̬Ϊߴ
-				continue;
-			}
-			else if(route->currentpoint->state==2)//Ϊh
-			{
-				lines->addpoint(originx,originy,2);//(·պ)
-#ifdef debug
-				printf("ֱh,յ%f  %f \n",originx,originy);
-#endif
-				plane->getlist()->add(lines);//һֱ·ϼ
-				plane->addgraphiccellcount();
-				plane->setplane();
-				lines=new Ipe_Lines();
-				if(route->currentpoint->nextpoint->state!=0)//hһ㲻
-				{
-					list->add(plane);
-					plane=new Ipe_Plane();
-					GraphicsCellCount++;
-				}
-				state=3;
-				continue;
-			}
+			GraphicsCellCount++;
+			continue;
 		}
-
-		if(state==2)//߼
-		{
-			if(route->currentpoint->state==1)//Ϊlint to
-			{
-				plane->getlist()->add(bazeir);
-				plane->addgraphiccellcount();
-				GraphicsCellCount++;
-				//delete bazeir;
-				bazeir=new Ipe_Bazeir();
-				lines->addpoint(currentx,currenty,0);
-				lines->addpoint(route->currentpoint->p0,route->currentpoint->p1,1);
-				originx=currentx;
-				originy=currenty;
-				state=1;
-				continue;
-			}
-			else if(route->currentpoint->state==3)//Ϊc
-			{
-				bazeir->addpoint(route->currentpoint->p0,route->currentpoint->p1,route->currentpoint->p2,route->currentpoint->p3,route->currentpoint->p4,route->currentpoint->p5,3);
-				currentx=route->currentpoint->p4;
-				currenty=route->currentpoint->p5;
-			}
-			else if(route->currentpoint->state==2)//Ϊh
-			{
-				bazeir->addpoint(originx,originy,-1,-1,-1,-1,2);
 #ifdef debug
-				printf("hָ,%f %f \n",originx,originy);
+		printf("h,պϵ\n");
 #endif
-				plane->getlist()->add(bazeir);
-				plane->addgraphiccellcount();
-				bazeir=new Ipe_Bazeir();
-				if(route->currentpoint->nextpoint->state!=0)
-				{
-					list->add(plane);
-					plane=new Ipe_Plane();
-					GraphicsCellCount++;
-				}
-				state=3;
-				continue;
-			}
-		}
-
-		if(state==3)//¿ʼ·
+		plane->setplane();//hպϵĻΪ,ȫΪߵĻ(Բ,)Ҳü
+		if(p->nextpoint==NULL||p->nextpoint->state!=0)//hһ㲻
 		{
-			originx=route->currentpoint->p0;
-			originy=route->currentpoint->p1;
-			state=0;
-			continue;
+			list->add(plane);
+			plane=new Ipe_Plane(store);
+			GraphicsCellCount++;
 		}
-		
 	}
-	if(state==1)
+	cell=builder.finish();
+	if(cell!=NULL)
 	{
-		plane->getlist()->add(lines);
+		plane->getlist()->add(cell);
 		plane->addgraphiccellcount();
-		list->add(plane);
 		GraphicsCellCount++;
 	}
-	if(state==2)
-	{
-		plane->getlist()->add(bazeir);
-		plane->addgraphiccellcount();
+	if(plane->getgraphicellcount()>0)
 		list->add(plane);
-		GraphicsCellCount++;
-	}
-
-	
+	else
+		delete plane;
 }
 /*
 		route->currentpoint=route->currentpoint->nextpoint;
@@ -343,8 +166,8 @@ Ipe_PdfPath::Ipe_PdfPath(zblroute* route)//
 	*/
 Ipe_PdfPath::~Ipe_PdfPath(void)
 {
+	list->deleteall();
 	delete list;
-	printf("Ipe_PdfPathͷ\n");
 }
 
 void Ipe_PdfPath::printfPath()
@@ -387,12 +210,12 @@ Ipe_LinkList<class Ipe_Plane>* Ipe_PdfPath::getPlane()
 
 int Ipe_PdfPath::getcolorspace()//ȡɫռ
 {
-	return this->colorspace;//¼һɫռ(չ) 1-G 2-g 3-RG 4-rg
+	return getpathstyle()->getcolorspace();//¼һɫռ(չ) 1-G 2-g 3-RG 4-rg
 }
 
 Ipe_Color Ipe_PdfPath::getcolor()//ȡɫ
 {
-	return this->color;
+	return getpathstyle()->getcolor();
 }
 
 int Ipe_PdfPath::getdrawingmethord()//ȡûƷ
@@ -403,7 +226,7 @@ int Ipe_PdfPath::getdrawingmethord()//ȡ
 
 float Ipe_PdfPath::getlinewidth()
 {
-	return this->linewidth;
+	return getpathstyle()->getlinewidth();
 }
 
 int Ipe_PdfPath::getpathtype()
@@ -413,9 +236,52 @@ int Ipe_PdfPath::getpathtype()
 
 Ipe_Color Ipe_PdfPath::getscolor()
 {
-	return *this->scolor;
+	return getpathstyle()->getscolor();
 }
 int Ipe_PdfPath::getscolorspace()
 {
-	return this->scolorspace;
-}
\ No newline at end of file
+	return getpathstyle()->getscolorspace();
+}
+
+int Ipe_PdfPath::getstyle()
+{
+	return this->style;
+}
+
+Ipe_PdfStyle* Ipe_PdfPath::getpathstyle()
+{
+	return this->styles->get(this->style);
+}
+
+bool Ipe_PdfPath::getbound(double* box)
+{
+	if(!this->boundvalid)
+	{
+		bool empty=true;
+		double b[4];
+		Ipe_node<Ipe_Plane>* p=list->headler;
+		while(p->next!=NULL)
+		{
+			p=p->next;
+			if(!p->t->getbound(b))
+				continue;
+			if(empty)
+			{
+				for(int i=0;i<4;i++)
+					this->bound[i]=b[i];
+				empty=false;
+				continue;
+			}
+			this->bound[0]=b[0]<this->bound[0]?b[0]:this->bound[0];
+			this->bound[1]=b[1]<this->bound[1]?b[1]:this->bound[1];
+			this->bound[2]=b[2]>this->bound[2]?b[2]:this->bound[2];
+			this->bound[3]=b[3]>this->bound[3]?b[3]:this->bound[3];
+		}
+		if(empty)
+			return false;
+		this->boundvalid=true;
+	}
+	for(int i=0;i<4;i++)
+		box[i]=this->bound[i];
+	return true;
+}
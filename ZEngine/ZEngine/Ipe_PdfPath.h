@@ -8,28 +8,25 @@
 #include "Ipe_Bazeir.h"
 #include "Ipe_PdfElement.h"
 #include "Ipe_Plane.h"
+#include "Ipe_StyleTable.h"
 //˲㴦һ··ԣ·Ϣֱ߼뱴߼л
 class EX_PORT Ipe_PdfPath
 {
 	int pathtype;//pathͣǷǼ· -3 ·-4
 
-	float linewidth;//¼߿
-	int colorspace;//¼һɫռ(չ) 1-G 2-g 3-RG 4-rg 5-cmyk(k) 6-cmyk(K)
-	Ipe_Color color;//¼ɫ
-
-	int scolorspace;//µɫռ
-	Ipe_Color *scolor;//һָ,ȴɫռ
-	//֮:һͨ,ֻһɫ
-	//һ,ҪҲҪɫ,ʱĬscolor,colorɫ
+	Ipe_StyleTable* styles;//ҳʽ
+	int style;//ɫ,߿,͸״̬ʽе±
 
 	int drawingmethord;//Ʒ 1-S 2-f* 3-f/F 4-s 5-B 6-B* 7-b 8-b*
 	int GraphicsCellCount;//¼ֱ߼߼
 	Ipe_LinkList<class Ipe_Plane>* list;//ŵͼҪص
+	double bound[4];//İΧ,ɸͼҪغϲ
+	bool boundvalid;
 
 
 public:
 	Ipe_PdfPath(void);
-	Ipe_PdfPath(zblroute* route);//ʼ·
+	Ipe_PdfPath(zblroute* route,Ipe_Geometry* store,Ipe_StyleTable* styles,float ca);//ʼ·,ŵstore,ʽstyles
 	~Ipe_PdfPath(void);
 	void printfPath();
 	int isclosedfeature();//бǷǱպ·
@@ -43,5 +40,8 @@ public:
 	int getpathtype();
 	Ipe_Color getscolor();//ȡõڶɫ
 	int getscolorspace();
+	int getstyle();//ʽ±,SVGʱӦcsss+±
+	Ipe_PdfStyle* getpathstyle();
+	bool getbound(double* box);//Χx0,y0,x1,y1,һεʱ㲢;ûеʱfalse
 };
 
@@ -0,0 +1,117 @@
+#include "Ipe_PdfPattern.h"
+#include <math.h>
+
+
+Ipe_PdfPattern::Ipe_PdfPattern(void)
+{
+	this->id=0;
+	this->nested=0;
+	this->xstep=0;
+	this->ystep=0;
+	this->matrix=fz_identity;
+	this->bbox=fz_empty_rect;
+	this->list=new Ipe_LinkList<Ipe_PdfElement>();
+	this->clips=new Ipe_ClipTable();
+}
+
+Ipe_PdfPattern::Ipe_PdfPattern(zblpattern* pattern,Ipe_LinkList<Ipe_PdfElement>* list,Ipe_ClipTable* clips)
+{
+	this->id=pattern->id;
+	this->nested=pattern->nested;
+	this->xstep=pattern->xstep;
+	this->ystep=pattern->ystep;
+	this->matrix.a=pattern->matrix[0];
+	this->matrix.b=pattern->matrix[1];
+	this->matrix.c=pattern->matrix[2];
+	this->matrix.d=pattern->matrix[3];
+	this->matrix.e=pattern->matrix[4];
+	this->matrix.f=pattern->matrix[5];
+	this->bbox.x0=pattern->bbox[0];
+	this->bbox.y0=pattern->bbox[1];
+	this->bbox.x1=pattern->bbox[2];
+	this->bbox.y1=pattern->bbox[3];
+	this->list=list;
+	this->clips=clips;
+}
+
+
+Ipe_PdfPattern::~Ipe_PdfPattern(void)
+{
+	this->list->deleteall();
+	delete this->list;
+	delete this->clips;//ջͷŶԲü
+}
+
+int Ipe_PdfPattern::getid()
+{
+	return this->id;
+}
+
+int Ipe_PdfPattern::getnested()
+{
+	return this->nested;
+}
+
+float Ipe_PdfPattern::getxstep()
+{
+	return this->xstep;
+}
+
+float Ipe_PdfPattern::getystep()
+{
+	return this->ystep;
+}
+
+fz_matrix Ipe_PdfPattern::getmatrix()
+{
+	return this->matrix;
+}
+
+fz_rect Ipe_PdfPattern::getbbox()
+{
+	return this->bbox;
+}
+
+Ipe_LinkList<Ipe_PdfElement>* Ipe_PdfPattern::getelement()
+{
+	return this->list;
+}
+
+Ipe_ClipTable* Ipe_PdfPattern::getclips()
+{
+	return this->clips;
+}
+
+void Ipe_PdfPattern::writeopen(Ipe_SvgWriter& w,double height)
+{
+	//ݵĵΪ(x,-y),Ȼԭy,ͼ,ٻΪôSVG,ʵ<use>ͬ
+	fz_matrix flip={1,0,0,-1,0,0};
+	fz_matrix svg={1,0,0,-1,0,(float)height};
+	fz_matrix m=fz_concat(fz_concat(flip,this->matrix),svg);
+	float xstep=fabsf(this->xstep);
+	float ystep=fabsf(this->ystep);
+	//ͼԪbbox½ǿʼƽ,תԪϱΪ-(y0+ystep)
+	w.write("<pattern id=\"p");
+	w.writeint(this->id);
+	w.write("\" patternUnits=\"userSpaceOnUse\" x=\"");
+	w.writenumber(this->bbox.x0);
+	w.write("\" y=\"");
+	w.writenumber(-(this->bbox.y0+ystep));
+	w.write("\" width=\"");
+	w.writenumber(xstep);
+	w.write("\" height=\"");
+	w.writenumber(ystep);
+	w.write("\" patternTransform=\"matrix(");
+	w.writenumber(m.a);
+	w.write(' ');
+	w.writenumber(m.b);
+	w.write(' ');
+	w.writenumber(m.c);
+	w.write(' ');
+	w.writenumber(m.d);
+	w.write(' ');
+	w.writenumber(m.e);
+	w.write(' ');
+	w.writenumber(m.f);
+	w.write(")\">\n");
+}
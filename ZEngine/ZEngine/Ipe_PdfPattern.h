@@ -0,0 +1,32 @@
+#pragma once
+#include "MuInclude.h"
+#include "Ipe_LinkList.h"
+#include "Ipe_PdfElement.h"
+#include "Ipe_ClipTable.h"
+#include "Ipe_SvgWriter.h"
+//ƽͼ:ÿͼֻȡһͼԪ,ͼռ,ҳ湲üδ洢ʽ
+//·ʽ¼ͼ,SVGʱͼΪ<pattern>,,ٰչ
+class EX_PORT Ipe_PdfPattern
+{
+	int id;//ҳڵı,SVGidΪpӱ
+	int nested;//Ƿڱͼʹ,ʱͼԾֲϵ
+	float xstep;//ƽ̲
+	float ystep;
+	fz_matrix matrix;//ͼռ䵽ʼϵľ
+	fz_rect bbox;//ͼԪΧ
+	Ipe_LinkList<Ipe_PdfElement>* list;//ͼԪݵջ
+	Ipe_ClipTable* clips;//ͼԪڲĲü·,ҳ治ͬ,ɱ
+public:
+	Ipe_PdfPattern(void);
+	Ipe_PdfPattern(zblpattern* pattern,Ipe_LinkList<Ipe_PdfElement>* list,Ipe_ClipTable* clips);//ȡͼ,ӹlistclips
+	~Ipe_PdfPattern(void);
+	int getid();
+	int getnested();
+	float getxstep();
+	float getystep();
+	fz_matrix getmatrix();
+	fz_rect getbbox();
+	Ipe_LinkList<Ipe_PdfElement>* getelement();
+	Ipe_ClipTable* getclips();
+	void writeopen(Ipe_SvgWriter& w,double height);//д<pattern>ʼǩ,ݵĵΪ(x,-y),heightΪôyᷭת߶,ھֲϵʹʱΪ0
+};
@@ -1,17 +1,19 @@
 #include "Ipe_PdfStack.h"
 #include "Ipe_PdfPath.h"
 
-Ipe_PdfStack::Ipe_PdfStack(void)
+Ipe_PdfStack::Ipe_PdfStack(void):Ipe_PdfElement(1)
 {
+	this->clips=NULL;
+	this->clip=-1;
+	this->xobject=0;
 }
 
-Ipe_PdfStack::Ipe_PdfStack(struct zblstack* stack)//ʼ
+Ipe_PdfStack::Ipe_PdfStack(struct zblstack* stack,Ipe_Geometry* store,Ipe_StyleTable* styles,Ipe_ClipTable* clips,int clip):Ipe_PdfElement(1)//ʼ,·ĵŵstore,·ʽstyles,clipΪջЧĲüclipsе±
 {
 	int i=0,j;
-	int state=0;
-	double originx=0,originy=0,currentx=0,currenty=0;
 	this->grade=0;//ĬջĲΪ
 	this->existstack=stack->existstack;
+	this->xobject=stack->xobject;
 	this->ca=stack->ca;
 	this->shadowtype=stack->shadowtype;
 	if(this->shadowtype==0)//Ӱ
@@ -40,161 +42,20 @@ Ipe_PdfStack::Ipe_PdfStack(struct zblstack* stack)//
 		this->countpath=stack->countroute;
 	}
 	this->existcm=stack->existcm;
-	this->clipcellcount=0;
+	this->matrix=fz_identity;
 	if(this->existcm>0)
 	{
-		
-		this->matrix=new float[6];
-		this->matrix[0]=stack->matrix[0];
-		this->matrix[1]=stack->matrix[1];
-		this->matrix[2]=stack->matrix[2];
-		this->matrix[3]=stack->matrix[3];
-		this->matrix[4]=stack->matrix[4];
-		this->matrix[5]=stack->matrix[5];
-	}
-	else
-	{
-		this->matrix=NULL;
-	}
-	this->existclip=stack->existclip;
-	this->countclip=stack->countclip;//¼ü·жٸ
-
-	this->cliplist=new Ipe_LinkList<Ipe_GraphicCell>();
-	Ipe_Lines* lines=new Ipe_Lines();//ֱ߼
-	Ipe_Bazeir* bazeir=new Ipe_Bazeir();//߶
-	stack->currentclip=stack->clipheadler;
-	//printf("ü·:%d\n",this->countclip);
-	for(i=0;i<this->countclip;i++)//ȡü·
-	{
-		stack->currentclip=stack->currentclip->nextpoint;
-		//printf("\nü·ֵ%f %f״̬:%d\n",stack->currentclip->p0,stack->currentclip->p1,stack->currentclip->state);
-		if(state==0)//ʼ״̬Ϊ0
-		{
-			if(stack->currentclip->state==0)
-			{
-				originx=stack->currentclip->p0;
-				originy=stack->currentclip->p1;
-				currentx=stack->currentclip->p0;
-				currenty=stack->currentclip->p1;
-				continue;
-			}
-			else if(stack->currentclip->state==1)//
-			{
-#ifdef debug
-				printf("ȷһֱ߼״̬\n");
-#endif
-				state=1;
-				lines->addpoint(originx,originy,0);//
-				lines->addpoint(stack->currentclip->p0,stack->currentclip->p1,1);//ӵǰ
-#ifdef debug
-				printf("·һ\n");
-				printf(":%f %f\nһ:%f %f ",originx,originy,stack->currentclip->p0,stack->currentclip->p1);
-#endif
-				currentx=stack->currentclip->p0;
-				currenty=stack->currentclip->p1;
-				continue;
-			}
-			else if(stack->currentclip->state==3)
-			{
-#ifdef debug
-				printf("ȷһ߼״̬\n");
-#endif
-				state=2;
-				bazeir->addpoint(originx,originy,-1,-1,-1,-1,0);
-				bazeir->addpoint(stack->currentclip->p0,stack->currentclip->p1,stack->currentclip->p2,stack->currentclip->p3,stack->currentclip->p4,stack->currentclip->p5,3);
-				currentx=stack->currentclip->p0;
-				currenty=stack->currentclip->p1;
-				continue;
-			}
-		}
-
-		if(state==1)//ֱ߼
-		{
-			if(stack->currentclip->state==1)//Ϊlint to
-			{
-				lines->addpoint(stack->currentclip->p0,stack->currentclip->p1,1);//ֱߵӽȥ
-#ifdef debug
-				printf("ֱ·%f %f\n",stack->currentclip->p0,stack->currentclip->p1);
-#endif
-				currentx=stack->currentclip->p0;
-				currenty=stack->currentclip->p1;
-				continue;
-			}
-			else if(stack->currentclip->state==3)//Ϊc ʱ,ֱӽlist,ȻͷŲ·lines,Ϊ´׼
-			{
-				this->cliplist->add(lines);
-				this->clipcellcount++;
-				//delete lines;
-				lines=new Ipe_Lines();//·ֱ߼,Ϊ´׼
-				bazeir->addpoint(currentx,currenty,-1,-1,-1,-1,0);//߼
-				originx=currentx;
-				originy=currenty;
-				bazeir->addpoint(stack->currentclip->p0,stack->currentclip->p1,stack->currentclip->p2,stack->currentclip->p3,stack->currentclip->p4,stack->currentclip->p5,3);
-				//ӵǰ
-				state=2;//ı״̬Ϊߴ
-				continue;
-			}
-			else if(stack->currentclip->state==2)//Ϊh  m,l,h,c״̬(ֱӦ0123
-			{
-				lines->addpoint(originx,originy,2);//(·պ)
-				this->cliplist->add(lines);//һֱ·ϼ
-				lines=new Ipe_Lines();
-				this->clipcellcount++;
-				state=3;
-				continue;
-			}
-		}
-
-		if(state==2)//߼
-		{
-			if(stack->currentclip->state==1)//Ϊlint to
-			{
-				this->cliplist->add(bazeir);
-				this->clipcellcount++;
-				//delete bazeir;
-				bazeir=new Ipe_Bazeir();
-				lines->addpoint(currentx,currenty,0);
-				lines->addpoint(stack->currentclip->p0,stack->currentclip->p1,1);
-				originx=currentx;
-				originy=currenty;
-				state=1;
-				continue;
-			}
-			else if(stack->currentclip->state==3)//Ϊ c
-			{
-				bazeir->addpoint(stack->currentclip->p0,stack->currentclip->p1,stack->currentclip->p2,stack->currentclip->p3,stack->currentclip->p4,stack->currentclip->p5,3);
-				currentx=stack->currentclip->p4;
-				currenty=stack->currentclip->p5;
-			}
-			else if(stack->currentclip->state==2)//Ϊh
-			{
-				bazeir->addpoint(originx,originy,-1,-1,-1,-1,2);
-				this->cliplist->add(bazeir);
-				bazeir=new Ipe_Bazeir();
-				this->clipcellcount++;
-				state=3;
-				continue;
-			}
-		}
-
-		if(state==3)//¿ʼ·
-		{
-			originx=stack->currentclip->p0;
-			originy=stack->currentclip->p1;
-			state=0;
-			continue;
-		}
-	}
-	if(state==1)
-	{
-		this->cliplist->add(lines);
-		this->clipcellcount++;
-	}
-	if(state==2)
-	{
-		this->cliplist->add(bazeir);
-		this->clipcellcount++;
+		this->matrix.a=stack->matrix[0];
+		this->matrix.b=stack->matrix[1];
+		this->matrix.c=stack->matrix[2];
+		this->matrix.d=stack->matrix[3];
+		this->matrix.e=stack->matrix[4];
+		this->matrix.f=stack->matrix[5];
 	}
+	this->clips=clips;
+	this->clip=clip;
+	if(this->clip>=0)
+		this->clips->retain(this->clip);
 
 	stack->currentroute=stack->routeheadler;
 	this->pathlist=new Ipe_LinkList<class Ipe_PdfPath>();
@@ -202,7 +63,7 @@ Ipe_PdfStack::Ipe_PdfStack(struct zblstack* stack)//
 	for(i=0;i<this->countpath;i++)//·
 	{
 		stack->currentroute=stack->currentroute->nextroute;
-		Ipe_PdfPath* path=new Ipe_PdfPath(stack->currentroute);
+		Ipe_PdfPath* path=new Ipe_PdfPath(stack->currentroute,store,styles,this->ca);
 		pathlist->add(path);
 	}
 
@@ -210,12 +71,10 @@ Ipe_PdfStack::Ipe_PdfStack(struct zblstack* stack)//
 
 Ipe_PdfStack::~Ipe_PdfStack(void)
 {
-	if(this->existclip>0)//ڲü·
-	{
-		delete this->cliplist;
-	}
+	if(this->clip>=0)//ü·ҳĲü,ֻͷ
+		this->clips->release(this->clip);
+	this->pathlist->deleteall();
 	delete this->pathlist;
-	printf("ͷջ·ڵü·ڵ");
 }
 
 void Ipe_PdfStack::printfPath(void)
@@ -225,7 +84,7 @@ void Ipe_PdfStack::printfPath(void)
 	printf("ջǷתþ:%d\n",this->existcm);
 	if(this->existcm>0)
 	{
-		printf("תþ:%f %f %f %f %f %f\n",this->matrix[0],this->matrix[1],this->matrix[2],this->matrix[3],this->matrix[4],this->matrix[5]);
+		printf("תþ:%f %f %f %f %f %f\n",this->matrix.a,this->matrix.b,this->matrix.c,this->matrix.d,this->matrix.e,this->matrix.f);
 	}
 	Ipe_node<Ipe_PdfPath>* p=this->pathlist->headler;
 	//p->t->printPoint();
@@ -238,18 +97,25 @@ void Ipe_PdfStack::printfPath(void)
 	}
 }
 
-int Ipe_PdfStack::getelementtype()
-{
-	return 1;
-}
-
 int Ipe_PdfStack::getcountpath()
 {
 	return this->countpath;
 }
 int Ipe_PdfStack::getexistclip()
 {
-	return this->existclip;
+	if(this->clip<0)
+		return 0;
+	return this->clips->gettype(this->clip);
+}
+
+int Ipe_PdfStack::getclip()
+{
+	return this->clip;
+}
+
+int Ipe_PdfStack::getxobject()
+{
+	return this->xobject;
 }
 
 int Ipe_PdfStack::getexistcm()
@@ -257,14 +123,16 @@ int Ipe_PdfStack::getexistcm()
 	return this->existcm;
 }
 
-float* Ipe_PdfStack::getmatrix()
+fz_matrix Ipe_PdfStack::getmatrix()
 {
 	return this->matrix;
 }
 
 int Ipe_PdfStack::getclipcellcount()
 {
-	return this->clipcellcount;
+	if(this->clip<0)
+		return 0;
+	return this->clips->getcellcount(this->clip);
 }
 Ipe_LinkList<class Ipe_PdfPath>* Ipe_PdfStack::getpathlist()
 {
@@ -273,7 +141,9 @@ Ipe_LinkList<class Ipe_PdfPath>* Ipe_PdfStack::getpathlist()
 
 Ipe_LinkList<class Ipe_GraphicCell>* Ipe_PdfStack::getcliplist()
 {
-	return this->cliplist;
+	if(this->clip<0)
+		return NULL;
+	return this->clips->getcells(this->clip);
 }
 int Ipe_PdfStack::getshadowtype()
 {
@@ -295,7 +165,7 @@ float Ipe_PdfStack::getca()
 
 void Ipe_PdfStack::setgrade(int grade)
 {
-	this->grade;
+	this->grade=grade;
 }
 
 int Ipe_PdfStack::getgrade()
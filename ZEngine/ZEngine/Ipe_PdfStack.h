@@ -1,6 +1,9 @@
 #pragma once
 #include "ipe_pdfelement.h"
 #include "Ipe_LinkList.h"
+#include "Ipe_Geometry.h"
+#include "Ipe_StyleTable.h"
+#include "Ipe_ClipTable.h"
 //˲㴦һͼ״̬ջϢ
 class EX_PORT Ipe_PdfStack :
 	public Ipe_PdfElement
@@ -9,33 +12,34 @@ class EX_PORT Ipe_PdfStack :
 	int countpath;//¼һͼ״̬ջжٸ·
 
 	int existcm;//Ƿתþ,ĬΪ0- 1-
-	float* matrix;//תþ,ĬΪNULL
+	fz_matrix matrix;//ջϲתþ,ĬΪλ
 
-	int existclip;//Ƿڲü· Լʽ 1-W 2-W*
-	int countclip;//·
-	int clipcellcount;//·жٶ
+	Ipe_ClipTable* clips;//ҳĲü·
+	int clip;//ջЧĲü·clipsе±,-1Ϊ,Ƕջ̳Ĳü
 	
 	int shadowtype;//ǷӰ(Ϊȡɫ)0- ֮ÿֶиԶӦ
 	float *bcolor;//¼ʼɫ
 	float *ecolor;//¼ɫ
 	float ca;//͸,ĬΪ1
 
+	int xobject;//XObjectʵջõĶ,0Ϊͨջ
+
 	int grade;//ջĲ,Բü·Լתþд,ĬΪ
 
 	Ipe_LinkList<class Ipe_PdfPath>* pathlist;//һͼ״̬ջ·
-	Ipe_LinkList<class Ipe_GraphicCell>* cliplist;//Ųü·
 
 public:
 	Ipe_PdfStack(void);
-	Ipe_PdfStack(struct zblstack*);
+	Ipe_PdfStack(struct zblstack*,Ipe_Geometry* store,Ipe_StyleTable* styles,Ipe_ClipTable* clips,int clip);
 	void printfPath();
-	virtual int getelementtype();
 	~Ipe_PdfStack(void);
 	int getcountpath();
-	int getexistclip();
+	int getexistclip();//üʽ 0- 1-W 2-W*
+	int getclip();//ü·ҳüе±
+	int getxobject();//ʵõı,0Ϊͨջ
 	int getexistcm();
 	int getclipcellcount();
-	float *getmatrix();
+	fz_matrix getmatrix();
 	Ipe_LinkList<class Ipe_GraphicCell>* getcliplist();
 	Ipe_LinkList<class Ipe_PdfPath>* getpathlist();
 	int getshadowtype();
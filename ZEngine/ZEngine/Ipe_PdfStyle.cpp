@@ -0,0 +1,307 @@
+#include "Ipe_PdfStyle.h"
+#include <string.h>
+
+static Ipe_Color makecolor(int colorspace,float* v,int* outspace)//ɫռȡɫֵתΪIpe_Color,cmykתΪrgb
+{
+	Ipe_Color color(0,0,0,0,0);
+	*outspace=colorspace;
+	if(v==NULL)
+		return color;
+	if(colorspace==1||colorspace==2)//Ҷȿռ
+	{
+		color.setColor(-1,-1,-1,-1,v[0]);
+	}
+	else if(colorspace==3||colorspace==4)//RGBɫռ
+	{
+		color.setColor(v[0],v[1],v[2],-1,-1);
+	}
+	else if(colorspace==5||colorspace==6)//cmykɫռ
+	{
+		*outspace=3;
+		color.setCmykColor(255*(100-v[0]*100)*(100-v[3]*100)/10000,255*(100-v[1]*100)*(100-v[3]*100)/10000,255*(100-v[2]*100)*(100-v[3]*100)/10000,-1,-1);
+	}
+	return color;
+}
+
+static bool samecolor(Ipe_Color a,Ipe_Color b)
+{
+	return a.getr()==b.getr()&&a.getg()==b.getg()&&a.getb()==b.getb()&&a.getG()==b.getG();
+}
+
+static unsigned int mix(unsigned int h,unsigned int v)//FNV-1a
+{
+	for(int i=0;i<4;i++)
+	{
+		h^=(v>>(i*8))&0xff;
+		h*=16777619u;
+	}
+	return h;
+}
+
+static unsigned int floatbits(float f)
+{
+	unsigned int u;
+	memcpy(&u,&f,sizeof(u));
+	return u;
+}
+
+static void writecolor(Ipe_SvgWriter& w,int colorspace,Ipe_Color color,int pattern)
+{
+	if(pattern!=0)//ƽͼ,<pattern>
+	{
+		w.write("url(#p");
+		w.writeint(pattern);
+		w.write(')');
+	}
+	else if(colorspace==3||colorspace==4)//RGBռ
+	{
+		w.write("rgb(");
+		w.writeint(color.getr());
+		w.write(',');
+		w.writeint(color.getg());
+		w.write(',');
+		w.writeint(color.getb());
+		w.write(')');
+	}
+	else//Ҷȿռ 0Ǻɫ 1ǰɫ
+	{
+		w.write(color.getG()==0?"black":"white");
+	}
+}
+
+Ipe_PdfStyle::Ipe_PdfStyle(void)
+	:color(0,0,0,0,0),scolor(0,0,0,0,0)
+{
+	this->drawingmethord=0;
+	this->colorspace=0;
+	this->scolorspace=0;
+	this->pattern=0;
+	this->spattern=0;
+	this->linewidth=0;
+	this->ca=1;
+	this->linecap=0;
+	this->linejoin=0;
+	this->miterlimit=10;
+	this->dashlen=0;
+	this->dashphase=0;
+}
+
+Ipe_PdfStyle::Ipe_PdfStyle(zblroute* route,float ca)
+	:color(0,0,0,0,0),scolor(0,0,0,0,0)
+{
+	this->drawingmethord=route->drawingmethord;
+	this->color=makecolor(route->colorspace,route->color,&this->colorspace);
+	this->scolorspace=0;
+	if(this->drawingmethord>=5)//ͿĨ,ɫ,colorɫ,scolor
+	{
+		this->scolor=makecolor(route->scolorspace,route->scolor,&this->scolorspace);
+	}
+	this->pattern=isfill()?route->pattern:0;
+	this->spattern=isstroke()?route->spattern:0;
+	this->ca=ca;
+	//ʱصȡĬֵ,ʹֻ߿Ȳͬ·һʽ
+	this->linewidth=0;
+	this->linecap=0;
+	this->linejoin=0;
+	this->miterlimit=10;
+	this->dashlen=0;
+	this->dashphase=0;
+	if(isstroke())
+	{
+		this->linewidth=route->linewidth;
+		this->linecap=route->linecap;
+		this->linejoin=route->linejoin;
+		this->miterlimit=route->miterlimit;
+		this->dashlen=route->dashlen>IPE_STYLE_MAXDASH?IPE_STYLE_MAXDASH:route->dashlen;
+		this->dashphase=route->dashphase;
+		for(int i=0;i<this->dashlen;i++)
+			this->dash[i]=route->dash[i];
+	}
+}
+
+Ipe_PdfStyle::~Ipe_PdfStyle(void)
+{
+}
+
+bool Ipe_PdfStyle::isstroke()
+{
+	return this->drawingmethord==1||this->drawingmethord==-1||this->drawingmethord==4||this->drawingmethord>=5;
+}
+
+bool Ipe_PdfStyle::isfill()
+{
+	return this->drawingmethord>=5||!isstroke();
+}
+
+bool Ipe_PdfStyle::equals(const Ipe_PdfStyle& other) const
+{
+	if(this->drawingmethord!=other.drawingmethord||this->colorspace!=other.colorspace||this->scolorspace!=other.scolorspace)
+		return false;
+	if(!samecolor(this->color,other.color)||!samecolor(this->scolor,other.scolor))
+		return false;
+	if(this->pattern!=other.pattern||this->spattern!=other.spattern)
+		return false;
+	if(this->linewidth!=other.linewidth||this->ca!=other.ca||this->linecap!=other.linecap||this->linejoin!=other.linejoin)
+		return false;
+	if(this->miterlimit!=other.miterlimit||this->dashlen!=other.dashlen||this->dashphase!=other.dashphase)
+		return false;
+	for(int i=0;i<this->dashlen;i++)
+	{
+		if(this->dash[i]!=other.dash[i])
+			return false;
+	}
+	return true;
+}
+
+unsigned int Ipe_PdfStyle::hash() const
+{
+	Ipe_Color c=this->color,s=this->scolor;
+	unsigned int h=2166136261u;
+	h=mix(h,this->drawingmethord);
+	h=mix(h,this->colorspace);
+	h=mix(h,(c.getr()<<16)^(c.getg()<<8)^c.getb()^(c.getG()<<24));
+	h=mix(h,this->scolorspace);
+	h=mix(h,(s.getr()<<16)^(s.getg()<<8)^s.getb()^(s.getG()<<24));
+	h=mix(h,this->pattern|(this->spattern<<16));
+	h=mix(h,floatbits(this->linewidth));
+	h=mix(h,floatbits(this->ca));
+	h=mix(h,this->linecap|(this->linejoin<<8)|(this->dashlen<<16));
+	h=mix(h,floatbits(this->miterlimit));
+	h=mix(h,floatbits(this->dashphase));
+	for(int i=0;i<this->dashlen;i++)
+		h=mix(h,floatbits(this->dash[i]));
+	return h;
+}
+
+void Ipe_PdfStyle::writecss(Ipe_SvgWriter& w)
+{
+	if(isfill())
+	{
+		w.write("fill:");
+		writecolor(w,this->colorspace,this->color,this->pattern);
+		if(this->drawingmethord==2||this->drawingmethord==6||this->drawingmethord==8)//f* B* b*
+			w.write(";fill-rule:evenodd");
+	}
+	else
+	{
+		w.write("fill:none");
+	}
+	if(isstroke())
+	{
+		w.write(";stroke:");
+		if(this->drawingmethord>=5)
+			writecolor(w,this->scolorspace,this->scolor,this->spattern);
+		else
+			writecolor(w,this->colorspace,this->color,this->spattern);
+		w.write(";stroke-width:");
+		w.writenumber(this->linewidth);
+		if(this->linecap==1)
+			w.write(";stroke-linecap:round");
+		else if(this->linecap==2)
+			w.write(";stroke-linecap:square");
+		if(this->linejoin==1)
+			w.write(";stroke-linejoin:round");
+		else if(this->linejoin==2)
+			w.write(";stroke-linejoin:bevel");
+		else if(this->miterlimit!=4)//SVGĬϵļΪ4,PDFΪ10
+		{
+			w.write(";stroke-miterlimit:");
+			w.writenumber(this->miterlimit);
+		}
+		if(this->dashlen>0)
+		{
+			w.write(";stroke-dasharray:");
+			for(int i=0;i<this->dashlen;i++)
+			{
+				if(i>0)
+					w.write(',');
+				w.writenumber(this->dash[i]);
+			}
+			if(this->dashphase!=0)
+			{
+				w.write(";stroke-dashoffset:");
+				w.writenumber(this->dashphase);
+			}
+		}
+	}
+	if(this->ca!=1)//͸ȲΪ1,͸
+	{
+		w.write(";opacity:");
+		w.writenumber(this->ca);
+	}
+}
+
+int Ipe_PdfStyle::getdrawingmethord()
+{
+	return this->drawingmethord;
+}
+
+int Ipe_PdfStyle::getcolorspace()
+{
+	return this->colorspace;
+}
+
+Ipe_Color Ipe_PdfStyle::getcolor()
+{
+	return this->color;
+}
+
+int Ipe_PdfStyle::getscolorspace()
+{
+	return this->scolorspace;
+}
+
+Ipe_Color Ipe_PdfStyle::getscolor()
+{
+	return this->scolor;
+}
+
+int Ipe_PdfStyle::getpattern()
+{
+	return this->pattern;
+}
+
+int Ipe_PdfStyle::getspattern()
+{
+	return this->spattern;
+}
+
+float Ipe_PdfStyle::getlinewidth()
+{
+	return this->linewidth;
+}
+
+float Ipe_PdfStyle::getca()
+{
+	return this->ca;
+}
+
+int Ipe_PdfStyle::getlinecap()
+{
+	return this->linecap;
+}
+
+int Ipe_PdfStyle::getlinejoin()
+{
+	return this->linejoin;
+}
+
+float Ipe_PdfStyle::getmiterlimit()
+{
+	return this->miterlimit;
+}
+
+int Ipe_PdfStyle::getdashlen()
+{
+	return this->dashlen;
+}
+
+float Ipe_PdfStyle::getdashphase()
+{
+	return this->dashphase;
+}
+
+float* Ipe_PdfStyle::getdash()
+{
+	return this->dash;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "MuInclude.h"
+#include "Ipe_Color.h"
+#include "Ipe_SvgWriter.h"
+#define IPE_STYLE_MAXDASH 32//fz_stroke_stateһ
+//һ·Ļʽ:Ʒ,ɫ,߿,͸,߶˹ս
+//ͬһҳͬʽֻIpe_StyleTableбһ,·ֻ¼±
+class EX_PORT Ipe_PdfStyle
+{
+	int drawingmethord;//Ʒ 1-S 2-f* 3-f/F 4-s 5-B 6-B* 7-b 8-b*
+	int colorspace;//1-G 2-g 3-RG 4-rg,cmykתΪ3
+	Ipe_Color color;
+	int scolorspace;//ʱߵɫռ,Ϊ0
+	Ipe_Color scolor;
+	int pattern;//ƽͼı,0Ϊɫ
+	int spattern;//ƽͼı
+	float linewidth;
+	float ca;//͸
+	int linecap;//0-ƽͷ 1-Բͷ 2-ͷ
+	int linejoin;//0- 1-Բ 2-б
+	float miterlimit;
+	int dashlen;
+	float dashphase;
+	float dash[IPE_STYLE_MAXDASH];
+public:
+	Ipe_PdfStyle(void);
+	Ipe_PdfStyle(zblroute* route,float ca);//ȡ·ջ͸ʽ
+	~Ipe_PdfStyle(void);
+	bool isstroke();//Ƿ
+	bool isfill();//Ƿ
+	bool equals(const Ipe_PdfStyle& other) const;
+	unsigned int hash() const;
+	void writecss(Ipe_SvgWriter& w);//дcss,뻨
+	int getdrawingmethord();
+	int getcolorspace();
+	Ipe_Color getcolor();
+	int getscolorspace();
+	Ipe_Color getscolor();
+	int getpattern();
+	int getspattern();
+	float getlinewidth();
+	float getca();
+	int getlinecap();
+	int getlinejoin();
+	float getmiterlimit();
+	int getdashlen();
+	float getdashphase();
+	float* getdash();
+};
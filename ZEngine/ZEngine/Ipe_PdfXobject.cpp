@@ -3,9 +3,63 @@
 
 Ipe_PdfXobject::Ipe_PdfXobject(void)
 {
+	this->num=0;
+	this->list=new Ipe_LinkList<Ipe_PdfElement>();
+	this->clips=new Ipe_ClipTable();
+	this->boundstate=0;
+}
+
+Ipe_PdfXobject::Ipe_PdfXobject(int num,Ipe_LinkList<Ipe_PdfElement>* list,Ipe_ClipTable* clips)
+{
+	this->num=num;
+	this->list=list;
+	this->clips=clips;
+	this->boundstate=0;
 }
 
 
 Ipe_PdfXobject::~Ipe_PdfXobject(void)
 {
+	this->list->deleteall();
+	delete this->list;
+	delete this->clips;//ջͷŶԲü
+}
+
+int Ipe_PdfXobject::getnum()
+{
+	return this->num;
+}
+
+Ipe_LinkList<Ipe_PdfElement>* Ipe_PdfXobject::getelement()
+{
+	return this->list;
+}
+
+Ipe_ClipTable* Ipe_PdfXobject::getclips()
+{
+	return this->clips;
+}
+
+int Ipe_PdfXobject::getboundstate()
+{
+	return this->boundstate;
+}
+
+void Ipe_PdfXobject::setbound(int state,const double* box)
+{
+	this->boundstate=state;
+	if(state==1)
+	{
+		for(int i=0;i<4;i++)
+			this->box[i]=box[i];
+	}
+}
+
+bool Ipe_PdfXobject::getbound(double* box)
+{
+	if(this->boundstate!=1)
+		return false;
+	for(int i=0;i<4;i++)
+		box[i]=this->box[i];
+	return true;
 }
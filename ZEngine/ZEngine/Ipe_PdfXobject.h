@@ -1,8 +1,25 @@
 #pragma once
-class Ipe_PdfXobject
+#include "MuInclude.h"
+#include "Ipe_LinkList.h"
+#include "Ipe_PdfElement.h"
+#include "Ipe_ClipTable.h"
+//XObject:ͬһһҳֻȡһ,ڱԼϵ,ҳ湲üδ洢ʽ
+//ҳÿεһ¼ʵջ,SVGʱΪһ<symbol><use>
+class EX_PORT Ipe_PdfXobject
 {
+	int num;//
+	Ipe_LinkList<Ipe_PdfElement>* list;//ݵջ
+	Ipe_ClipTable* clips;//ڲĲü·,ҳ治ͬ,ɱ
+	double box[4];//ڱеİΧ,Ƕ׵ʵ
+	int boundstate;//0-δ 1-Ч 2-ûе 3-(ֱӻ)
 public:
 	Ipe_PdfXobject(void);
+	Ipe_PdfXobject(int num,Ipe_LinkList<Ipe_PdfElement>* list,Ipe_ClipTable* clips);//ӹlistclips
 	~Ipe_PdfXobject(void);
+	int getnum();
+	Ipe_LinkList<Ipe_PdfElement>* getelement();
+	Ipe_ClipTable* getclips();
+	int getboundstate();
+	void setbound(int state,const double* box);//ҳmakebounds,ֻ֮
+	bool getbound(double* box);//ûеδʱfalse
 };
-
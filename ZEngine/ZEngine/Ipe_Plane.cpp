@@ -5,12 +5,24 @@ Ipe_Plane::Ipe_Plane(void)
 {
 	this->graphiccellcount=0;
 	this->isplane=false;
+	this->store=NULL;
 	this->list=new Ipe_LinkList<Ipe_GraphicCell>();
+	this->boundvalid=false;
+}
+
+Ipe_Plane::Ipe_Plane(Ipe_Geometry* store)
+{
+	this->graphiccellcount=0;
+	this->isplane=false;
+	this->store=store;
+	this->list=new Ipe_LinkList<Ipe_GraphicCell>();
+	this->boundvalid=false;
 }
 
 
 Ipe_Plane::~Ipe_Plane(void)
 {
+	list->deleteall();
 	delete list;
 }
 
@@ -53,4 +65,42 @@ int Ipe_Plane::getgraphicellcount()
 void Ipe_Plane::setlist(Ipe_LinkList<Ipe_GraphicCell>* list)
 {
 	this->list=list;
-}
\ No newline at end of file
+	this->boundvalid=false;
+}
+Ipe_Geometry* Ipe_Plane::getstore()
+{
+	return this->store;
+}
+
+bool Ipe_Plane::getbound(double* box)
+{
+	if(!this->boundvalid)
+	{
+		bool empty=true;
+		double b[4];
+		Ipe_node<Ipe_GraphicCell>* p=list->headler;
+		while(p->next!=NULL)
+		{
+			p=p->next;
+			if(!p->t->getbound(b))
+				continue;
+			if(empty)
+			{
+				for(int i=0;i<4;i++)
+					this->bound[i]=b[i];
+				empty=false;
+				continue;
+			}
+			this->bound[0]=b[0]<this->bound[0]?b[0]:this->bound[0];
+			this->bound[1]=b[1]<this->bound[1]?b[1]:this->bound[1];
+			this->bound[2]=b[2]>this->bound[2]?b[2]:this->bound[2];
+			this->bound[3]=b[3]>this->bound[3]?b[3]:this->bound[3];
+		}
+		if(empty)
+			return false;
+		this->boundvalid=true;
+	}
+	for(int i=0;i<4;i++)
+		box[i]=this->bound[i];
+	return true;
+}
@@ -1,13 +1,18 @@
 #pragma once
 #include "Ipe_LinkList.h"
 #include "Ipe_GraphicCell.h"
-class EX_PORT Ipe_Plane//һΪ·,һϵֱ߼߼
+#include "Ipe_Geometry.h"
+class EX_PORT Ipe_Plane//һΪ·,һϵֱ߼߼,Ƕstoreеͼ
 {
 	int graphiccellcount;
 	bool isplane;//Ƿһ
+	Ipe_Geometry* store;//ֱ߼߼ĵڵĴ洢,
 	Ipe_LinkList<class Ipe_GraphicCell>* list;
+	double bound[4];//İΧ,ֱ߼߼İΧкϲ
+	bool boundvalid;
 public:
 	Ipe_Plane(void);
+	Ipe_Plane(Ipe_Geometry* store);
 	~Ipe_Plane(void);
 	Ipe_LinkList<class Ipe_GraphicCell>* getlist();
 	void setplane();
@@ -16,6 +21,8 @@ public:
 	bool getisplane();
 	int getgraphicellcount();
 	void setlist(Ipe_LinkList<Ipe_GraphicCell>* list);
+	Ipe_Geometry* getstore();
+	bool getbound(double* box);//Χx0,y0,x1,y1,һεʱ㲢,setlist¼;ûеʱfalse
 	
 };
 
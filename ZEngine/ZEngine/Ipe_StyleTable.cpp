@@ -0,0 +1,97 @@
+#include "Ipe_StyleTable.h"
+#include <stdlib.h>
+
+Ipe_StyleTable::Ipe_StyleTable(void)
+{
+	this->styles=NULL;
+	this->count=0;
+	this->capacity=0;
+	this->buckets=NULL;
+	this->bucketcount=0;
+	rehash(64);
+}
+
+Ipe_StyleTable::~Ipe_StyleTable(void)
+{
+	delete[] this->styles;
+	free(this->buckets);
+}
+
+void Ipe_StyleTable::rehash(int bucketcount)
+{
+	free(this->buckets);
+	this->bucketcount=bucketcount;
+	this->buckets=(int*)malloc(bucketcount*sizeof(int));
+	for(int i=0;i<bucketcount;i++)
+		this->buckets[i]=-1;
+	for(int i=0;i<this->count;i++)//·ʽ
+	{
+		unsigned int b=this->styles[i].hash()&(bucketcount-1);
+		while(this->buckets[b]!=-1)
+			b=(b+1)&(bucketcount-1);
+		this->buckets[b]=i;
+	}
+}
+
+int Ipe_StyleTable::intern(const Ipe_PdfStyle& style)
+{
+	unsigned int b=style.hash()&(this->bucketcount-1);
+	while(this->buckets[b]!=-1)//̽
+	{
+		if(this->styles[this->buckets[b]].equals(style))
+			return this->buckets[b];
+		b=(b+1)&(this->bucketcount-1);
+	}
+	if(this->count==this->capacity)
+	{
+		int capacity=this->capacity<16?16:this->capacity*2;
+		Ipe_PdfStyle* styles=new Ipe_PdfStyle[capacity];
+		for(int i=0;i<this->count;i++)
+			styles[i]=this->styles[i];
+		delete[] this->styles;
+		this->styles=styles;
+		this->capacity=capacity;
+	}
+	this->styles[this->count]=style;
+	this->buckets[b]=this->count;
+	this->count++;
+	if(this->count*2>this->bucketcount)//װӳһʱ
+		rehash(this->bucketcount*2);
+	return this->count-1;
+}
+
+int Ipe_StyleTable::getcount()
+{
+	return this->count;
+}
+
+Ipe_PdfStyle* Ipe_StyleTable::get(int index)
+{
+	return &this->styles[index];
+}
+
+void Ipe_StyleTable::clear()
+{
+	this->count=0;
+	for(int i=0;i<this->bucketcount;i++)
+		this->buckets[i]=-1;
+}
+
+size_t Ipe_StyleTable::getmemsize()
+{
+	return sizeof(Ipe_StyleTable)+(size_t)this->capacity*sizeof(Ipe_PdfStyle)+(size_t)this->bucketcount*sizeof(int);
+}
+
+void Ipe_StyleTable::writecss(Ipe_SvgWriter& w)
+{
+	w.write("<style type=\"text/css\"><![CDATA[\n");
+	for(int i=0;i<this->count;i++)
+	{
+		w.write(".s");
+		w.writeint(i);
+		w.write('{');
+		this->styles[i].writecss(w);
+		w.write("}\n");
+	}
+	w.write("]]></style>\n");
+}
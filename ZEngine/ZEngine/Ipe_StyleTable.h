@@ -0,0 +1,22 @@
+#pragma once
+#include "Ipe_PdfStyle.h"
+//ҳʽ:ȡʱÿ·ʽ,ͬʽֻһ,·¼±
+//SVGʱÿʽΪһcss
+class EX_PORT Ipe_StyleTable
+{
+	Ipe_PdfStyle* styles;
+	int count;
+	int capacity;
+	int* buckets;//Ŷַɢб,ʽ±,-1Ϊ
+	int bucketcount;//2
+	void rehash(int bucketcount);
+public:
+	Ipe_StyleTable(void);
+	~Ipe_StyleTable(void);
+	int intern(const Ipe_PdfStyle& style);//һʽ,±
+	int getcount();
+	Ipe_PdfStyle* get(int index);
+	void clear();
+	size_t getmemsize();
+	void writecss(Ipe_SvgWriter& w);//д<style>Ԫ,Ϊs±
+};
@@ -0,0 +1,273 @@
+#include "Ipe_SvgDevice.h"
+#include <stdlib.h>
+
+static Ipe_SvgDevice* getsvg(fz_device* dev)
+{
+	return (Ipe_SvgDevice*)dev->user;
+}
+
+static void writecolor(fz_device* dev,Ipe_SvgWriter& w,fz_colorspace* colorspace,float* color)//дɫ,ҶȵĴڴpagetoSVGһùؼ
+{
+	float rgb[3];
+	if(colorspace->n==1&&(color[0]==0||color[0]==1))
+	{
+		w.write(color[0]==0?"black":"white");
+		return;
+	}
+	fz_convert_color(dev->ctx,fz_device_rgb,rgb,colorspace,color);//ɫʿռͳһתΪrgb
+	w.write("rgb(");
+	w.writeint((int)(rgb[0]*255));
+	w.write(',');
+	w.writeint((int)(rgb[1]*255));
+	w.write(',');
+	w.writeint((int)(rgb[2]*255));
+	w.write(')');
+}
+
+static void svgfillpath(fz_device* dev,fz_path* path,int even_odd,fz_matrix ctm,fz_colorspace* colorspace,float* color,float alpha)
+{
+	Ipe_SvgDevice* svg=getsvg(dev);
+	if(svg->ismasking())
+		return;
+	Ipe_SvgWriter& w=svg->getwriter();
+	w.write("<path d=\"");
+	svg->writepath(path,ctm);
+	w.write("\" style=\"fill:");
+	writecolor(dev,w,colorspace,color);
+	if(even_odd)
+		w.write("; fill-rule:evenodd");
+	if(alpha!=1)
+	{
+		w.write(";opacity:");
+		w.writenumber(alpha);
+	}
+	w.write("\"/>\n\n");
+}
+
+static void svgstrokepath(fz_device* dev,fz_path* path,fz_stroke_state* stroke,fz_matrix ctm,fz_colorspace* colorspace,float* color,float alpha)
+{
+	Ipe_SvgDevice* svg=getsvg(dev);
+	if(svg->ismasking())
+		return;
+	Ipe_SvgWriter& w=svg->getwriter();
+	w.write("<path d=\"");
+	svg->writepath(path,ctm);
+	w.write("\" style=\"fill:none;stroke:");
+	writecolor(dev,w,colorspace,color);
+	w.write("; stroke-width:");
+	w.writenumber(stroke->linewidth*fz_matrix_expansion(ctm));//Ѿctm任,߿ҲҪ֮
+	if(alpha!=1)
+	{
+		w.write(";opacity:");
+		w.writenumber(alpha);
+	}
+	w.write("\"/>\n\n");
+}
+
+static void svgclippath(fz_device* dev,fz_path* path,fz_rect* rect,int even_odd,fz_matrix ctm)
+{
+	Ipe_SvgDevice* svg=getsvg(dev);
+	if(svg->ismasking())
+	{
+		svg->pushclip(false);
+		return;
+	}
+	Ipe_SvgWriter& w=svg->getwriter();
+	int id=svg->pushclip(true);
+	w.write("<defs><clipPath id=\"c-star");
+	w.writeint(id);
+	w.write("\">\n<path d=\"");
+	svg->writepath(path,ctm);
+	if(even_odd)
+		w.write("\" clip-rule=\"evenodd");
+	w.write("\"/>\n</clipPath></defs>\n<g style=\"clip-path: url(#c-star");
+	w.writeint(id);
+	w.write(");\">\n");
+}
+
+static void svgclipstrokepath(fz_device* dev,fz_path* path,fz_rect* rect,fz_stroke_state* stroke,fz_matrix ctm)
+{
+	getsvg(dev)->pushclip(false);//߲ü,ֻռһԱpop_clip
+}
+
+static void svgcliptext(fz_device* dev,fz_text* text,fz_matrix ctm,int accumulate)
+{
+	if(accumulate<2)//ۻֲüֻڵһѹ
+		getsvg(dev)->pushclip(false);
+}
+
+static void svgclipstroketext(fz_device* dev,fz_text* text,fz_stroke_state* stroke,fz_matrix ctm)
+{
+	getsvg(dev)->pushclip(false);
+}
+
+static void svgclipimagemask(fz_device* dev,fz_image* image,fz_rect* rect,fz_matrix ctm)
+{
+	getsvg(dev)->pushclip(false);
+}
+
+static void svgpopclip(fz_device* dev)
+{
+	getsvg(dev)->popclip();
+}
+
+static void svgbeginmask(fz_device* dev,fz_rect rect,int luminosity,fz_colorspace* colorspace,float* color)
+{
+	getsvg(dev)->beginmask();
+}
+
+static void svgendmask(fz_device* dev)
+{
+	getsvg(dev)->endmask();
+}
+
+Ipe_SvgDevice::Ipe_SvgDevice(fz_context* ctx,int decimals)
+{
+	this->dev=fz_new_device(ctx,this);
+	this->dev->hints=FZ_IGNORE_IMAGE|FZ_IGNORE_SHADE|FZ_NO_CAPTURE;//ֻ·,ͼƬӰؼ,Ҳʸȡ
+	this->dev->fill_path=svgfillpath;
+	this->dev->stroke_path=svgstrokepath;
+	this->dev->clip_path=svgclippath;
+	this->dev->clip_stroke_path=svgclipstrokepath;
+	this->dev->clip_text=svgcliptext;
+	this->dev->clip_stroke_text=svgclipstroketext;
+	this->dev->clip_image_mask=svgclipimagemask;
+	this->dev->pop_clip=svgpopclip;
+	this->dev->begin_mask=svgbeginmask;
+	this->dev->end_mask=svgendmask;
+	this->writer.setdecimals(decimals);
+	this->opened=false;
+	this->clipcount=0;
+	this->clipdepth=0;
+	this->clipcapacity=16;
+	this->clipstack=(char*)malloc(this->clipcapacity);
+	this->maskdepth=0;
+}
+
+Ipe_SvgDevice::~Ipe_SvgDevice(void)
+{
+	close();
+	fz_free_device(this->dev);
+	free(this->clipstack);
+}
+
+bool Ipe_SvgDevice::open(const char* path,fz_rect rect)
+{
+	if(!this->writer.open(path))
+	{
+		printf("޷SVGļ:%s\n",path);
+		return false;
+	}
+	this->opened=true;
+	this->clipcount=0;
+	this->clipdepth=0;
+	this->maskdepth=0;
+	this->writer.write("<?xml version=\"1.0\" standalone=\"no\"?>\n\n<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \n\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n <svg width=\"100%\" height=\"100%\" version=\"1.1\" viewBox=\" ");
+	this->writer.writenumber(rect.x0);
+	this->writer.write(' ');
+	this->writer.writenumber(rect.y0);
+	this->writer.write(' ');
+	this->writer.writenumber(rect.x1);
+	this->writer.write(' ');
+	this->writer.writenumber(rect.y1);
+	this->writer.write("\" xmlns=\"http://www.w3.org/2000/svg\">\n");
+	return true;
+}
+
+void Ipe_SvgDevice::close()
+{
+	if(!this->opened)
+		return;
+	while(this->clipdepth>0)//q/Qʱ
+		popclip();
+	this->writer.write("</svg>");
+	this->writer.close();
+	this->opened=false;
+}
+
+fz_device* Ipe_SvgDevice::getdevice()
+{
+	return this->dev;
+}
+
+Ipe_SvgWriter& Ipe_SvgDevice::getwriter()
+{
+	return this->writer;
+}
+
+void Ipe_SvgDevice::writepath(fz_path* path,fz_matrix ctm)
+{
+	fz_point p;
+	int i=0;
+	while(i<path->len)
+	{
+		switch(path->items[i++].k)
+		{
+		case FZ_MOVETO:
+		case FZ_LINETO:
+			this->writer.write(path->items[i-1].k==FZ_MOVETO?'M':'L');
+			p.x=path->items[i++].v;
+			p.y=path->items[i++].v;
+			p=fz_transform_point(ctm,p);//ctmѰҳyᷭת,ø߶
+			this->writer.writenumber(p.x);
+			this->writer.write(' ');
+			this->writer.writenumber(p.y);
+			this->writer.write(' ');
+			break;
+		case FZ_CURVETO:
+			this->writer.write('C');
+			for(int n=0;n<3;n++)//Ƶյ
+			{
+				p.x=path->items[i++].v;
+				p.y=path->items[i++].v;
+				p=fz_transform_point(ctm,p);
+				this->writer.writenumber(p.x);
+				this->writer.write(' ');
+				this->writer.writenumber(p.y);
+				this->writer.write(n==2?'\n':' ');
+			}
+			break;
+		case FZ_CLOSE_PATH:
+			this->writer.write("Z ");
+			break;
+		}
+	}
+}
+
+int Ipe_SvgDevice::pushclip(bool group)
+{
+	if(this->clipdepth==this->clipcapacity)
+	{
+		this->clipcapacity*=2;
+		this->clipstack=(char*)realloc(this->clipstack,this->clipcapacity);
+	}
+	this->clipstack[this->clipdepth++]=group?1:0;
+	if(!group)
+		return 0;
+	return ++this->clipcount;
+}
+
+void Ipe_SvgDevice::popclip()
+{
+	if(this->clipdepth==0)
+		return;
+	if(this->clipstack[--this->clipdepth])
+		this->writer.write("</g>");
+}
+
+bool Ipe_SvgDevice::ismasking()
+{
+	return this->maskdepth>0;
+}
+
+void Ipe_SvgDevice::beginmask()
+{
+	this->maskdepth++;
+}
+
+void Ipe_SvgDevice::endmask()//ɰݽ,ɰ汾Ϊһü,֮pop_clip
+{
+	if(this->maskdepth>0)
+		this->maskdepth--;
+	pushclip(false);
+}
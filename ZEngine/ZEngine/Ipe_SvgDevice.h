@@ -0,0 +1,30 @@
+#pragma once
+#include "MuInclude.h"
+#include "Ipe_SvgWriter.h"
+//ʽSVG豸:ÿһ·ֱд<path>,zblroutesetҳģ
+//ڴֻ뵱ǰһ·й,Ipe_PdfPage::pagetoSVGȼ
+class EX_PORT Ipe_SvgDevice
+{
+	fz_device* dev;
+	Ipe_SvgWriter writer;
+	bool opened;
+	int clipcount;//дĲü·,id
+	char* clipstack;//ÿüǷ<g>,pop_clipʱݴ˹ر
+	int clipdepth;
+	int clipcapacity;
+	int maskdepth;//ɰʱ
+public:
+	Ipe_SvgDevice(fz_context* ctx,int decimals=3);
+	~Ipe_SvgDevice(void);
+	bool open(const char* path,fz_rect rect);//ļдļͷ,ʧܷfalse
+	void close();//رδպϵĲü,дļβ
+	fz_device* getdevice();//fz_run_page豸
+	//豸صʹ
+	Ipe_SvgWriter& getwriter();
+	void writepath(fz_path* path,fz_matrix ctm);//ctm任д·
+	int pushclip(bool group);//ѹһü,groupΪtrueʱµĲüid
+	void popclip();
+	bool ismasking();
+	void beginmask();
+	void endmask();
+};
@@ -0,0 +1,173 @@
+#include "Ipe_SvgWriter.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#define IPE_SNPRINTF _snprintf//VS2010ûsnprintf,ضʱβ0,ɵô
+#else
+#define IPE_SNPRINTF snprintf
+#endif
+
+static const double pow10table[10]={1,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9};
+static const unsigned long long pow10int[10]={1ULL,10ULL,100ULL,1000ULL,10000ULL,100000ULL,1000000ULL,10000000ULL,100000000ULL,1000000000ULL};
+
+Ipe_SvgWriter::Ipe_SvgWriter(int size)
+{
+	this->file=NULL;
+	this->size=size<256?256:size;
+	this->buffer=(char*)malloc(this->size);
+	this->used=0;
+	this->decimals=3;
+}
+
+Ipe_SvgWriter::~Ipe_SvgWriter(void)
+{
+	close();
+	free(this->buffer);
+}
+
+bool Ipe_SvgWriter::open(const char* path)
+{
+	close();
+	this->file=fopen(path,"wb");
+	this->used=0;
+	return this->file!=NULL;
+}
+
+void Ipe_SvgWriter::close()
+{
+	if(this->file==NULL)
+		return;
+	flush();
+	fclose(this->file);
+	this->file=NULL;
+}
+
+void Ipe_SvgWriter::flush()
+{
+	if(this->file!=NULL&&this->used>0)
+	{
+		fwrite(this->buffer,1,this->used,this->file);
+	}
+	this->used=0;
+}
+
+void Ipe_SvgWriter::setdecimals(int decimals)
+{
+	this->decimals=decimals>9?9:decimals;
+}
+
+int Ipe_SvgWriter::getdecimals()
+{
+	return this->decimals;
+}
+
+void Ipe_SvgWriter::write(const char* s)
+{
+	write(s,(int)strlen(s));
+}
+
+void Ipe_SvgWriter::write(const char* s,int len)
+{
+	if(this->used+len>this->size)
+	{
+		flush();
+		if(len>this->size)//Ȼֱдļ
+		{
+			if(this->file!=NULL)
+				fwrite(s,1,len,this->file);
+			return;
+		}
+	}
+	memcpy(this->buffer+this->used,s,len);
+	this->used+=len;
+}
+
+void Ipe_SvgWriter::write(char c)
+{
+	if(this->used==this->size)
+		flush();
+	this->buffer[this->used++]=c;
+}
+
+void Ipe_SvgWriter::writenumber(double v)
+{
+	if(this->size-this->used<32)
+		flush();
+	this->used+=formatnumber(this->buffer+this->used,v,this->decimals);
+}
+
+void Ipe_SvgWriter::writeint(int v)
+{
+	writenumber(v);
+}
+
+void Ipe_SvgWriter::appendnumber(std::string& s,double v)
+{
+	char buf[32];
+	int len=formatnumber(buf,v,this->decimals);
+	s.append(buf,len);
+}
+
+int Ipe_SvgWriter::formatnumber(char* buf,double v,int decimals)
+{
+	if(v!=v)//NaN
+	{
+		buf[0]='0';
+		return 1;
+	}
+	if(decimals<0)//̵ܾȷԭʽ,15λЧּ
+	{
+		int len=0;
+		for(int p=15;p<=17;p++)
+		{
+			len=sprintf(buf,"%.*g",p,v);
+			if(strtod(buf,NULL)==v)
+				break;
+		}
+		return len;
+	}
+	bool negative=v<0;
+	if(negative)
+		v=-v;
+	double scaled=v*pow10table[decimals]+0.5;
+	if(scaled>=9e18)//㷶Χ,%fдȫλ,н%g
+	{
+		int len=IPE_SNPRINTF(buf,32,"%.17g",negative?-v:v);
+		if(len<0||len>31)
+			len=31;
+		buf[len]='\0';
+		return len;
+	}
+	unsigned long long r=(unsigned long long)scaled;
+	unsigned long long ip=r/pow10int[decimals];//
+	unsigned long long fp=r%pow10int[decimals];//С
+	char digits[24];
+	int n=0,len=0;
+	if(negative&&r!=0)//Ϊ0ʱ-0
+		buf[len++]='-';
+	do
+	{
+		digits[n++]=(char)('0'+ip%10);
+		ip/=10;
+	}while(ip!=0);
+	while(n>0)
+		buf[len++]=digits[--n];
+	if(fp!=0)
+	{
+		int d=decimals;
+		while(fp%10==0)//ȥĩβ0
+		{
+			fp/=10;
+			d--;
+		}
+		buf[len++]='.';
+		for(int i=d-1;i>=0;i--)
+		{
+			buf[len+i]=(char)('0'+fp%10);
+			fp/=10;
+		}
+		len+=d;
+	}
+	return len;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+#include "MuInclude.h"
+//SVG:дһظʹõĻ,˲дļ,ֱӸʽ,ѷ
+class EX_PORT Ipe_SvgWriter
+{
+	FILE* file;
+	char* buffer;
+	int size;//С
+	int used;//дֽ
+	int decimals;//ֱСλ,С0ʱܾȷԭʽ
+public:
+	Ipe_SvgWriter(int size=1<<16);
+	~Ipe_SvgWriter(void);
+	bool open(const char* path);//ļ,ʧܷfalse
+	void close();//дرļ
+	void flush();//дļ
+	void setdecimals(int decimals);
+	int getdecimals();
+	void write(const char* s);
+	void write(const char* s,int len);
+	void write(char c);
+	void writenumber(double v);//Сλ
+	void writeint(int v);
+	void appendnumber(std::string& s,double v);//׷ӵַĩβ,Ҫظʹõ
+	static int formatnumber(char* buf,double v,int decimals);//ָʽbuf(32ֽ),س
+};
@@ -0,0 +1,60 @@
+#pragma once
+//߳뻥ļ򵥷װ,WindowsʹWin32 API,ƽ̨ʹpthread
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+
+typedef CRITICAL_SECTION Ipe_Mutex;
+typedef HANDLE Ipe_Thread;
+#define IPE_THREAD_RETURN unsigned __stdcall
+typedef unsigned (__stdcall *Ipe_ThreadFunc)(void*);
+
+inline void Ipe_MutexInit(Ipe_Mutex* m){InitializeCriticalSection(m);}
+inline void Ipe_MutexDestroy(Ipe_Mutex* m){DeleteCriticalSection(m);}
+inline void Ipe_MutexLock(Ipe_Mutex* m){EnterCriticalSection(m);}
+inline void Ipe_MutexUnlock(Ipe_Mutex* m){LeaveCriticalSection(m);}
+
+inline bool Ipe_ThreadStart(Ipe_Thread* t,Ipe_ThreadFunc func,void* arg)
+{
+	*t=(HANDLE)_beginthreadex(NULL,0,func,arg,0,NULL);
+	return *t!=0;
+}
+inline void Ipe_ThreadJoin(Ipe_Thread t)
+{
+	WaitForSingleObject(t,INFINITE);
+	CloseHandle(t);
+}
+inline int Ipe_CpuCount()//߼
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+}
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t Ipe_Mutex;
+typedef pthread_t Ipe_Thread;
+#define IPE_THREAD_RETURN void*
+typedef void* (*Ipe_ThreadFunc)(void*);
+
+inline void Ipe_MutexInit(Ipe_Mutex* m){pthread_mutex_init(m,NULL);}
+inline void Ipe_MutexDestroy(Ipe_Mutex* m){pthread_mutex_destroy(m);}
+inline void Ipe_MutexLock(Ipe_Mutex* m){pthread_mutex_lock(m);}
+inline void Ipe_MutexUnlock(Ipe_Mutex* m){pthread_mutex_unlock(m);}
+
+inline bool Ipe_ThreadStart(Ipe_Thread* t,Ipe_ThreadFunc func,void* arg)
+{
+	return pthread_create(t,NULL,func,arg)==0;
+}
+inline void Ipe_ThreadJoin(Ipe_Thread t)
+{
+	pthread_join(t,NULL);
+}
+inline int Ipe_CpuCount()
+{
+	long n=sysconf(_SC_NPROCESSORS_ONLN);
+	return n>0?(int)n:1;
+}
+#endif
@@ -0,0 +1,705 @@
+#include "Ipe_TilePyramid.h"
+#include "Ipe_PdfPage.h"
+#include "Ipe_PdfStack.h"
+#include "Ipe_PageView.h"
+#include "Ipe_Lines.h"
+#include "Ipe_Bazeir.h"
+#include "Ipe_Thread.h"
+#include "Ipe_Flattener.h"
+#include <vector>
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#define IPE_TILE_FLATNESS 0.25//չҸ,Ƭ굥λ
+
+static void makedir(const char* path)//Ѵʱ
+{
+#ifdef _WIN32
+	_mkdir(path);
+#else
+	mkdir(path,0755);
+#endif
+}
+
+struct tilepath//һҪƬµ,չ
+{
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<int> starts;//ÿ·һ±
+	std::vector<bool> closed;
+	double beginx;//ǰ·
+	double beginy;
+	bool current;//Ƿеǰ
+	bool reopen;//պ֮Ļߴ㿪ʼµ·
+};
+
+static void pathclear(struct tilepath* p)
+{
+	p->x.clear();
+	p->y.clear();
+	p->starts.clear();
+	p->closed.clear();
+	p->current=false;
+	p->reopen=false;
+}
+
+static void pathmove(struct tilepath* p,double x,double y)
+{
+	p->starts.push_back((int)p->x.size());
+	p->closed.push_back(false);
+	p->x.push_back(x);
+	p->y.push_back(y);
+	p->beginx=x;
+	p->beginy=y;
+	p->current=true;
+	p->reopen=false;
+}
+
+static void pathline(struct tilepath* p,double x,double y)
+{
+	if(!p->current)
+	{
+		pathmove(p,x,y);
+		return;
+	}
+	if(p->reopen)
+		pathmove(p,p->beginx,p->beginy);
+	p->x.push_back(x);
+	p->y.push_back(y);
+}
+
+static void pathcurve(struct tilepath* p,double x1,double y1,double x2,double y2,double x3,double y3)//ȷչҸݲ
+{
+	if(!p->current)
+		pathmove(p,x1,y1);
+	if(p->reopen)
+		pathmove(p,p->beginx,p->beginy);
+	double x[4]={p->x.back(),x1,x2,x3};
+	double y[4]={p->y.back(),y1,y2,y3};
+	int n=Ipe_Flattener::segments(x,y,IPE_TILE_FLATNESS);
+	size_t size=p->x.size();
+	p->x.resize(size+n);
+	p->y.resize(size+n);
+	Ipe_Flattener::evaluate(x,y,n,&p->x[size],&p->y[size]);
+}
+
+static void pathclose(struct tilepath* p)
+{
+	if(!p->current||p->starts.empty())
+		return;
+	p->closed.back()=true;
+	p->reopen=true;
+}
+
+struct tiletransform//ҳ굽Ƭ,y
+{
+	double x0;
+	double y0;
+	double scale;
+};
+
+static void addcells(struct tilepath* p,Ipe_LinkList<Ipe_GraphicCell>* cells,bool isplane,const struct tiletransform* m)//writeplaneĹֱ߼߼
+{
+	Ipe_node<Ipe_GraphicCell>* current=cells->headler;
+	while(current->next!=NULL)
+	{
+		current=current->next;
+		Ipe_GraphicCell* cell=current->t;
+		if(cell->gettype()==1)
+		{
+			Ipe_Lines* lines=static_cast<Ipe_Lines*>(cell);
+			for(int k=0;k<lines->getnum();k++)
+			{
+				int state=lines->getstate(k);
+				if(state==2)//պָ,ص
+				{
+					pathline(p,p->beginx,p->beginy);
+					if(isplane)
+						pathclose(p);
+					continue;
+				}
+				double x=(lines->getx(k)-m->x0)*m->scale;
+				double y=(m->y0-lines->gety(k))*m->scale;
+				if(state==0&&k==0&&isplane&&p->current&&!p->reopen&&x==p->x.back()&&y==p->y.back())//߼ֱ֮߼ڽظ
+					continue;
+				if(state==0||(k==0&&!isplane))//ÿֱ߼
+					pathmove(p,x,y);
+				else
+					pathline(p,x,y);
+			}
+		}
+		else
+		{
+			Ipe_Bazeir* bazeir=static_cast<Ipe_Bazeir*>(cell);
+			int pt=0;
+			if(bazeir->getnum()==0)
+				continue;
+			if(!isplane||!p->current)//еǰʱ߼Ӵ˽
+				pathmove(p,(bazeir->getx(0)-m->x0)*m->scale,(m->y0-bazeir->gety(0))*m->scale);
+			pt+=3;
+			for(int k=0;k<bazeir->getnum()-1;k++,pt+=3)
+			{
+				int state=bazeir->getstate(pt);
+				if(state==2)
+				{
+					pathline(p,p->beginx,p->beginy);
+					if(isplane)
+						pathclose(p);
+					continue;
+				}
+				double x=(bazeir->getx(pt)-m->x0)*m->scale;
+				double y=(m->y0-bazeir->gety(pt))*m->scale;
+				if(state==0)
+				{
+					pathmove(p,x,y);
+					continue;
+				}
+				pathcurve(p,x,y,(bazeir->getx(pt+1)-m->x0)*m->scale,(m->y0-bazeir->gety(pt+1))*m->scale,
+					(bazeir->getx(pt+2)-m->x0)*m->scale,(m->y0-bazeir->gety(pt+2))*m->scale);
+			}
+		}
+	}
+}
+
+static int quantize(const struct tilepath* p,int sub,std::vector<int>& qx,std::vector<int>& qy)//·ȡȥظ,ص
+{
+	int begin=p->starts[sub];
+	int end=sub+1<(int)p->starts.size()?p->starts[sub+1]:(int)p->x.size();
+	qx.clear();
+	qy.clear();
+	for(int i=begin;i<end;i++)
+	{
+		int x=(int)floor(p->x[i]+0.5);
+		int y=(int)floor(p->y[i]+0.5);
+		if(!qx.empty()&&qx.back()==x&&qy.back()==y)
+			continue;
+		qx.push_back(x);
+		qy.push_back(y);
+	}
+	return (int)qx.size();
+}
+
+static double ringarea(const std::vector<int>& x,const std::vector<int>& y)//Ƭ(y)⻷Ϊ
+{
+	double area=0;
+	int n=(int)x.size();
+	for(int i=0,j=n-1;i<n;j=i++)
+		area+=(double)x[j]*y[i]-(double)x[i]*y[j];
+	return area/2;
+}
+
+static bool ringcontains(const std::vector<int>& x,const std::vector<int>& y,int px,int py)//߷
+{
+	bool inside=false;
+	int n=(int)x.size();
+	for(int i=0,j=n-1;i<n;j=i++)
+	{
+		if((y[i]>py)!=(y[j]>py)&&px<(double)(x[j]-x[i])*(py-y[i])/(y[j]-y[i])+x[i])
+			inside=!inside;
+	}
+	return inside;
+}
+
+static void reversering(std::vector<int>& x,std::vector<int>& y)
+{
+	for(size_t i=1,j=x.size()-1;i<j;i++,j--)//һ
+	{
+		int t=x[i];x[i]=x[j];x[j]=t;
+		t=y[i];y[i]=y[j];y[j]=t;
+	}
+}
+
+static void encodepath(Ipe_MvtEncoder& encoder,const struct tilepath* p,bool isplane)
+{
+	std::vector<int> qx,qy;
+	std::vector<int> outerx,outery;//ǰ⻷,еĻΪ
+	for(int sub=0;sub<(int)p->starts.size();sub++)
+	{
+		int n=quantize(p,sub,qx,qy);
+		if(!isplane)
+		{
+			if(p->closed[sub]&&n>2&&(qx[0]!=qx[n-1]||qy[0]!=qy[n-1]))
+			{
+				qx.push_back(qx[0]);
+				qy.push_back(qy[0]);
+				n++;
+			}
+			if(n>=2)
+				encoder.addpath(&qx[0],&qy[0],n,false);
+			continue;
+		}
+		if(n>1&&qx[0]==qx[n-1]&&qy[0]==qy[n-1])//ıպClosePathʾ
+		{
+			qx.pop_back();
+			qy.pop_back();
+			n--;
+		}
+		if(n<3)
+			continue;
+		double area=ringarea(qx,qy);
+		if(area==0)//ڱ˻
+			continue;
+		bool hole=!outerx.empty()&&ringcontains(outerx,outery,qx[0],qy[0]);
+		if(!hole)
+		{
+			if(area<0)
+				reversering(qx,qy);
+			outerx=qx;
+			outery=qy;
+		}
+		else if(area>0)
+		{
+			reversering(qx,qy);
+		}
+		encoder.addpath(&qx[0],&qy[0],n,true);
+	}
+}
+
+static void colortag(Ipe_MvtEncoder& encoder,const char* key,int colorspace,Ipe_Color color,int pattern)
+{
+	char text[16];
+	if(pattern!=0)//ƽͼûжӦɫ
+		return;
+	if(colorspace==3||colorspace==4)
+		sprintf(text,"#%02x%02x%02x",color.getr()&0xff,color.getg()&0xff,color.getb()&0xff);
+	else
+		sprintf(text,color.getG()==0?"#000000":"#ffffff");
+	encoder.addtag(key,text);
+}
+
+static void styletags(Ipe_MvtEncoder& encoder,Ipe_PdfPath* path)
+{
+	Ipe_PdfStyle* style=path->getpathstyle();
+	encoder.addtag("style",(long long)path->getstyle());
+	if(style==NULL)
+		return;
+	if(style->isfill())
+		colortag(encoder,"fill",style->getcolorspace(),style->getcolor(),style->getpattern());
+	if(style->isstroke())
+	{
+		if(style->getdrawingmethord()>=5)
+			colortag(encoder,"stroke",style->getscolorspace(),style->getscolor(),style->getspattern());
+		else
+			colortag(encoder,"stroke",style->getcolorspace(),style->getcolor(),style->getspattern());
+		encoder.addtag("stroke-width",(double)style->getlinewidth());
+	}
+	if(style->getca()<1)
+		encoder.addtag("opacity",(double)style->getca());
+}
+
+Ipe_TilePyramid::Ipe_TilePyramid(Ipe_PdfPage* page,int minzoom,int maxzoom)
+{
+	this->page=page;
+	this->minzoom=minzoom<0?0:minzoom;
+	this->maxzoom=maxzoom>30?30:maxzoom;
+	this->extent=4096;
+	this->buffer=64;
+	this->tolerance=1;
+	this->method=IPE_SIMPLIFY_DOUGLAS;
+	fz_rect rect=page->getrect();
+	this->left=rect.x0;
+	this->top=rect.y1;
+	this->size=rect.x1-rect.x0;
+	if(rect.y1-rect.y0>this->size)
+		this->size=rect.y1-rect.y0;
+	if(this->size<=0)
+		this->size=1;
+	unsigned long long id=1,instance=1;
+	Ipe_node<Ipe_PdfElement>* current=page->getelement()->headler;
+	while(current->next!=NULL)//ҳ˳Ҫر
+	{
+		current=current->next;
+		if(current->t->getelementtype()!=1)
+			continue;
+		Ipe_PdfStack* stack=static_cast<Ipe_PdfStack*>(current->t);
+		if(stack->getxobject()!=0)
+			this->instances[stack]=instance++;
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)
+			{
+				cplane=cplane->next;
+				this->ids[cplane->t]=id++;
+			}
+		}
+	}
+}
+
+Ipe_TilePyramid::~Ipe_TilePyramid(void)
+{
+}
+
+void Ipe_TilePyramid::setextent(int extent)
+{
+	if(extent>0)
+		this->extent=extent;
+}
+
+void Ipe_TilePyramid::setbuffer(int buffer)
+{
+	if(buffer>=0)
+		this->buffer=buffer;
+}
+
+void Ipe_TilePyramid::setsimplify(double tolerance,int method)
+{
+	this->tolerance=tolerance<0?0:tolerance;
+	this->method=method;
+}
+
+void Ipe_TilePyramid::gettilerect(int z,int x,int y,cliprect* rect)
+{
+	double s=this->size/(double)(1<<z);
+	rect->x0=this->left+x*s;
+	rect->x1=rect->x0+s;
+	rect->y0=this->top-y*s;
+	rect->y1=rect->y0-s;
+}
+
+unsigned long long Ipe_TilePyramid::featureid(struct viewplane* v)
+{
+	if(v->order>=0)
+	{
+		std::map<Ipe_PdfStack*,unsigned long long>::const_iterator instance=this->instances.find(v->stack);
+		return instance==this->instances.end()?0:(instance->second<<32)+v->order+1;
+	}
+	std::map<Ipe_Plane*,unsigned long long>::const_iterator id=this->ids.find(v->plane);
+	return id==this->ids.end()?0:id->second;
+}
+
+bool Ipe_TilePyramid::encodetile(int z,int x,int y,std::string& data)
+{
+	return encodetile(z,x,y,data,NULL);
+}
+
+bool Ipe_TilePyramid::encodetile(int z,int x,int y,std::string& data,bool* content)
+{
+	cliprect rect;
+	gettilerect(z,x,y,&rect);
+	struct tiletransform m;
+	m.x0=rect.x0;
+	m.y0=rect.y0;
+	m.scale=this->extent/(rect.x1-rect.x0);
+	double b=this->buffer/m.scale;//Ϊҳ
+	rect.x0-=b;
+	rect.x1+=b;
+	rect.y0+=b;
+	rect.y1-=b;
+	data.clear();
+	Ipe_PageView* view=this->page->clipwithrect(&rect);
+	if(view==NULL)
+		return false;
+	for(int i=0;i<view->getcount();i++)
+	{
+		if(view->get(i)->plane!=NULL)
+			continue;
+		Ipe_PageView* expanded=view->expand();//бʵʱչ,չҪûоü
+		view->release();
+		view=expanded->clip(&rect);
+		expanded->release();
+		break;
+	}
+	if(content!=NULL)
+		*content=view->getcount()>0;
+	if(this->tolerance>0&&view->getcount()>0)//Ƭ߳,ٷ߳
+	{
+		Ipe_PageView* simple=view->simplify(this->tolerance/m.scale,this->method,1);
+		view->release();//simpleview
+		view=simple;
+	}
+	Ipe_MvtEncoder encoder;
+	struct tilepath p;
+	encoder.beginlayer("page",this->extent);
+	for(int i=0;i<view->getcount();i++)
+	{
+		struct viewplane* v=view->get(i);
+		if(v->plane==NULL)
+			continue;
+		bool isplane=v->plane->getisplane();
+		pathclear(&p);
+		addcells(&p,v->cells,isplane,&m);
+		encoder.beginfeature(isplane?IPE_MVT_POLYGON:IPE_MVT_LINESTRING,featureid(v));
+		styletags(encoder,v->path);
+		encodepath(encoder,&p,isplane);
+		encoder.endfeature();
+	}
+	encoder.endlayer();
+	view->release();
+	data=encoder.getdata();
+	return !data.empty();
+}
+
+#ifdef _MSC_VER
+#define IPE_SNPRINTF _snprintf//VS2010ûsnprintf,ضʱβ0,ɵô
+#else
+#define IPE_SNPRINTF snprintf
+#endif
+
+struct Ipe_PyramidJob
+{
+	Ipe_TilePyramid* pyramid;
+	int zoom;//ǰ
+	std::vector<int> tiles;//ǰҪɵƬ,ÿΪx,y
+	std::vector<char> content;//ÿƬĴǷҪ,֮߳䲻ص
+	int nexttile;
+	const char* path;
+	FILE* archive;//NULLʱдĿ¼
+	unsigned long long offset;//鵵ļǰ
+	std::vector<unsigned char> index;//鵵
+	int written;
+	bool failed;//Ƭûд
+	Ipe_Mutex mutex;
+};
+
+static void putint(unsigned char* p,unsigned long long v,int bytes)//С
+{
+	for(int i=0;i<bytes;i++)
+		p[i]=(unsigned char)((v>>(i*8))&0xff);
+}
+
+static bool tilename(char* name,int size,const char* path,int z,int x,int y,int depth)//depthΪ1,2,3ʱֱΪĿ¼,Ŀ¼Ƭļ;·ʱfalse
+{
+	int len;
+	if(depth==1)
+		len=IPE_SNPRINTF(name,size,"%s/%d",path,z);
+	else if(depth==2)
+		len=IPE_SNPRINTF(name,size,"%s/%d/%d",path,z,x);
+	else
+		len=IPE_SNPRINTF(name,size,"%s/%d/%d/%d.mvt",path,z,x,y);
+	if(len<0||len>=size)
+	{
+		name[size-1]='\0';
+		return false;
+	}
+	return true;
+}
+
+static void writetile(Ipe_PyramidJob* job,int z,int x,int y,const std::string& data)
+{
+	if(job->archive==NULL)//ÿƬһļ,֮߳䲻ͻ
+	{
+		char name[1024];
+		bool ok=false;
+		if(tilename(name,sizeof(name),job->path,z,x,y,1))
+		{
+			makedir(name);
+			tilename(name,sizeof(name),job->path,z,x,y,2);
+			makedir(name);
+			if(tilename(name,sizeof(name),job->path,z,x,y,3))
+			{
+				FILE* f=fopen(name,"wb");
+				if(f!=NULL)
+				{
+					ok=fwrite(data.data(),1,data.size(),f)==data.size();
+					if(fclose(f)!=0)
+						ok=false;
+				}
+			}
+		}
+		Ipe_MutexLock(&job->mutex);
+		if(ok)
+			job->written++;
+		else
+			job->failed=true;
+		Ipe_MutexUnlock(&job->mutex);
+		return;
+	}
+	unsigned char head[13];
+	unsigned char entry[24];
+	putint(head,z,1);
+	putint(head+1,x,4);
+	putint(head+5,y,4);
+	putint(head+9,data.size(),4);
+	Ipe_MutexLock(&job->mutex);
+	if(job->failed)//дʧ֮ļ¼λòɿ,д
+	{
+		Ipe_MutexUnlock(&job->mutex);
+		return;
+	}
+	putint(entry,z,4);
+	putint(entry+4,x,4);
+	putint(entry+8,y,4);
+	putint(entry+12,job->offset+13,8);
+	putint(entry+20,data.size(),4);
+	if(fwrite(head,1,13,job->archive)!=13||fwrite(data.data(),1,data.size(),job->archive)!=data.size())
+	{
+		job->failed=true;
+		Ipe_MutexUnlock(&job->mutex);
+		return;
+	}
+	job->offset+=13+data.size();
+	job->index.insert(job->index.end(),entry,entry+24);
+	job->written++;
+	Ipe_MutexUnlock(&job->mutex);
+}
+
+static IPE_THREAD_RETURN pyramidworker(void* arg)
+{
+	Ipe_PyramidJob* job=(Ipe_PyramidJob*)arg;
+	std::string data;
+	int t;
+	int count=(int)job->tiles.size()/2;
+	while(true)
+	{
+		Ipe_MutexLock(&job->mutex);
+		t=job->nexttile++;
+		Ipe_MutexUnlock(&job->mutex);
+		if(t>=count)
+			break;
+		int x=job->tiles[t*2];
+		int y=job->tiles[t*2+1];
+		bool content=false;
+		if(job->pyramid->encodetile(job->zoom,x,y,data,&content))//ҳֻ
+			writetile(job,job->zoom,x,y,data);
+		job->content[t]=content;
+	}
+	return 0;
+}
+
+static void runlevel(Ipe_PyramidJob* job,int threadcount)//߳ɵǰȫƬ
+{
+	int i,count=(int)job->tiles.size()/2;
+	job->content.assign(count,0);
+	job->nexttile=0;
+	if(threadcount>count)
+		threadcount=count;
+	if(threadcount<1)
+		threadcount=1;
+	Ipe_Thread* threads=new Ipe_Thread[threadcount];
+	bool* started=new bool[threadcount];
+	for(i=0;i<threadcount;i++)
+		started[i]=Ipe_ThreadStart(&threads[i],pyramidworker,job);
+	for(i=0;i<threadcount;i++)
+	{
+		if(started[i])
+			Ipe_ThreadJoin(threads[i]);
+	}
+	if(job->nexttile<count)//ûܹ߳,ڵǰ߳
+		pyramidworker(job);
+	delete[] started;
+	delete[] threads;
+}
+
+int Ipe_TilePyramid::run(const char* path,bool archive,int threadcount)
+{
+	Ipe_PyramidJob job;
+	int i,z;
+	if(this->maxzoom<this->minzoom)
+		return 0;
+	Ipe_PageIndex* index=this->page->getindex();//֮߳ǰ
+	double box[4]={DBL_MAX,DBL_MAX,-DBL_MAX,-DBL_MAX};//ҳݵķΧ
+	for(i=0;i<index->getcount();i++)
+	{
+		struct indexitem* e=index->get(i);//ʵķΧѾʵ任
+		if(e->box[0]<box[0])box[0]=e->box[0];
+		if(e->box[1]<box[1])box[1]=e->box[1];
+		if(e->box[2]>box[2])box[2]=e->box[2];
+		if(e->box[3]>box[3])box[3]=e->box[3];
+	}
+	if(box[0]>box[2])
+		return 0;
+	job.pyramid=this;
+	job.path=path;
+	job.archive=NULL;
+	job.offset=0;
+	job.written=0;
+	job.failed=false;
+	if(archive)
+	{
+		job.archive=fopen(path,"wb");
+		if(job.archive==NULL)
+			return -1;
+		if(fwrite("IPEMVT01",1,8,job.archive)!=8)
+			job.failed=true;
+		job.offset=8;
+	}
+	else
+	{
+		makedir(path);
+	}
+	Ipe_MutexInit(&job.mutex);
+	if(threadcount<=0)
+		threadcount=Ipe_CpuCount();
+	for(z=this->minzoom;z<=this->maxzoom&&!job.failed;z++)
+	{
+		int n=1<<z,r[4];
+		double s=this->size/n,b=s*this->buffer/this->extent;
+		r[0]=(int)floor((box[0]-b-this->left)/s);//ݷΧཻƬ
+		r[1]=(int)floor((this->top-box[3]-b)/s);
+		r[2]=(int)floor((box[2]+b-this->left)/s);
+		r[3]=(int)floor((this->top-box[1]+b)/s);
+		if(r[0]<0)r[0]=0;
+		if(r[1]<0)r[1]=0;
+		if(r[2]>n-1)r[2]=n-1;
+		if(r[3]>n-1)r[3]=n-1;
+		std::vector<int> tiles;
+		if(z==this->minzoom)
+		{
+			for(int y=r[1];y<=r[3];y++)
+			{
+				for(int x=r[0];x<=r[2];x++)
+				{
+					tiles.push_back(x);
+					tiles.push_back(y);
+				}
+			}
+		}
+		else//ƬĴ()ڸƬĴ֮,ֻдҪصĸƬſзǿյƬ
+		{
+			for(i=0;i<(int)job.content.size();i++)
+			{
+				if(!job.content[i])
+					continue;
+				for(int k=0;k<4;k++)
+				{
+					int x=job.tiles[i*2]*2+(k&1);
+					int y=job.tiles[i*2+1]*2+(k>>1);
+					if(x<r[0]||x>r[2]||y<r[1]||y>r[3])
+						continue;
+					tiles.push_back(x);
+					tiles.push_back(y);
+				}
+			}
+		}
+		if(tiles.empty())
+			break;
+		job.zoom=z;
+		job.tiles.swap(tiles);
+		runlevel(&job,threadcount);
+	}
+	Ipe_MutexDestroy(&job.mutex);
+	if(job.archive!=NULL)//β
+	{
+		unsigned char tail[20];
+		if(!job.failed&&!job.index.empty()&&fwrite(&job.index[0],1,job.index.size(),job.archive)!=job.index.size())
+			job.failed=true;
+		putint(tail,job.offset,8);
+		putint(tail+8,job.written,4);
+		memcpy(tail+12,"IPEMVTIX",8);
+		if(!job.failed&&fwrite(tail,1,20,job.archive)!=20)
+			job.failed=true;
+		if(fclose(job.archive)!=0)
+			job.failed=true;
+	}
+	return job.failed?-1:job.written;
+}
+
+int Ipe_TilePyramid::todirectory(const char* path,int threadcount)
+{
+	return run(path,false,threadcount);
+}
+
+int Ipe_TilePyramid::toarchive(const char* path,int threadcount)
+{
+	return run(path,true,threadcount);
+}
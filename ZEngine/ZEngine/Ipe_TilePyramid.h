@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <map>
+#include "MuInclude.h"
+#include "Ipe_MvtEncoder.h"
+#include "clipfunction.h"
+#include "simplifyfunction.h"
+//һҳz/x/yƬ,ÿƬΪMapbox Vector Tile
+//0һƬҳϽнϴߵ,ÿиӱ,кŴ;СҳݷΧཻƬ,ֻ֮ɴҪصƬƬ,Ƭ
+//ÿƬҳĿռȡҪ,˻Ĵڲü,ֱ߼Ƭ굥λݲ(һ),չΪ,ȡƬȥظ
+//ÿͼҪΪһҪ,Ϊ,Ϊ;ʵչΪҪ,ʵ任ͬü,ʵչ
+//鵵ļʽ(С):8ֽͷ"IPEMVT01",֮ƬΪz(1ֽ),x,y,(4ֽ);
+//ĩβΪ,ÿz,x,y(4ֽ),ƫ(8ֽ),(4ֽ),ƫ(8ֽ),Ƭ(4ֽ)"IPEMVTIX"
+class EX_PORT Ipe_TilePyramid
+{
+	class Ipe_PdfPage* page;
+	int minzoom;
+	int maxzoom;
+	int extent;//Ƭ귶Χ
+	int buffer;//ƬܵĻ,Ƭ굥λ
+	double tolerance;//ݲ,Ƭ굥λ,㵽ҳ浥λÿͬ
+	int method;
+	double left;//0ƬϽ,ҳ
+	double top;
+	double size;//0Ƭ߳
+	std::map<class Ipe_Plane*,unsigned long long> ids;//ҪرΪҳе˳1,ƬеͬһҪرͬ
+	std::map<class Ipe_PdfStack*,unsigned long long> instances;//ʵҳе˳1,ʵչҪرΪ32λʵеż1
+	unsigned long long featureid(struct viewplane* v);
+	int run(const char* path,bool archive,int threadcount);
+public:
+	Ipe_TilePyramid(class Ipe_PdfPage* page,int minzoom,int maxzoom);
+	~Ipe_TilePyramid(void);
+	void setextent(int extent);//Ĭ4096
+	void setbuffer(int buffer);//Ĭ64
+	void setsimplify(double tolerance,int method=IPE_SIMPLIFY_DOUGLAS);//Ĭݲ1,Ϊ0ʱֻȡȥ
+	void gettilerect(int z,int x,int y,cliprect* rect);//Ƭҳ淶Χ,
+	bool encodetile(int z,int x,int y,std::string& data);//һƬ,ûҪʱfalse
+	bool encodetile(int z,int x,int y,std::string& data,bool* content);//contentȡôǷҪ,Ҫڱ˻ʱΪtrue,Ƭܷǿ
+	int todirectory(const char* path,int threadcount=0);//߳,дpath/z/x/y.mvt,дƬ,Ƭ鵵ûдʱ-1;threadcount<=0ʱȡCPU
+	int toarchive(const char* path,int threadcount=0);//߳,˳ʽдһ鵵ļ
+};
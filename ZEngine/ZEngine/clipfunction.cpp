@@ -1,32 +1,30 @@
 #include "clipfunction.h"
+#include <math.h>
+#include <stdlib.h>
 
-class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect)//ֱ߼봰ھβ
+class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect,Ipe_Geometry* store)//ֱ߼봰ھβ,ֱ߼ĵӵstore
 {
-	Ipe_node<Ipe_Point2D>* currentpoint=lines->getlist()->headler;
-	Ipe_Point2D *p0,*p1,*cp0,*cp1;
-	int count=0;
-	bool isfirstpoint=true;
-	Ipe_Lines* newlines=new Ipe_Lines();
+	Ipe_Point2D p0,p1;
+	int i;
+	double box[4];
+	if(!lines->getbound(box)||!boxoverlap(box,rect))//ֱ߼ڴ
+		return new Ipe_Lines(store);
+	if(boxinside(box,rect))//ֱ߼ڴ,ԭ
+		return static_cast<Ipe_Lines*>(copycell(lines,store));
+	Ipe_Lines* newlines=new Ipe_Lines(store);
 
-	while(currentpoint->next!=NULL)
+	if(lines->GetPointCount()>0)
 	{
-		currentpoint=currentpoint->next;
-		if(isfirstpoint)
-		{
-			isfirstpoint=false;
-			cp0=currentpoint->t;
-			count++;
-			p0=new Ipe_Point2D(currentpoint->t->getx(),currentpoint->t->gety(),currentpoint->t->getstate());
-			continue;
-		}
-		cp1=currentpoint->t;
-		count++;
-		p1=new Ipe_Point2D(cp1->getx(),cp1->gety(),cp1->getstate());
+		p0=lines->getpoint(0);
+	}
+	for(i=1;i<lines->GetPointCount();i++)
+	{
+		p1=lines->getpoint(i);
 		//ʱp0,p1Ϊֱϵ˵
 		int code0,code1;
 		bool done=false;
-		code0=compcode(p0,rect);
-		code1=compcode(p1,rect);//봰,бж
+		code0=compcode(&p0,rect);
+		code1=compcode(&p1,rect);//봰,бж
 		//printf("%d,%d\n",code0,code1);
 		int endcount=0;
 		do
@@ -35,24 +33,16 @@ class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect)//ֱ
 			{
 				//ȫڴ
 				//ȫ
-				newlines->addpoint(p0->getx(),p0->gety(),p0->getstate());
-				newlines->addpoint(p1->getx(),p1->gety(),p1->getstate());
-				cp0=cp1;
-				p0->setx(cp0->getx());
-				p0->sety(cp0->gety());
-				p0->setstate(cp0->getstate());
-				delete p1;
+				newlines->addpoint(&p0);
+				newlines->addpoint(&p1);
+				p0=lines->getpoint(i);//һδԭĶ˵㿪ʼ
 				done=true;
 			}
 			else if((code0&code1))
 			{
 				//ȫڴ
 				//
-				cp0=cp1;
-				p0->setx(cp0->getx());
-				p0->sety(cp0->gety());
-				p0->setstate(cp0->getstate());
-				delete p1;
+				p0=lines->getpoint(i);
 				done=true;
 			}
 			else
@@ -63,21 +53,21 @@ class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect)//ֱ
 				float delx,dely;
 				if(code0!=0)//p0
 				{
-					delx=p1->getx()-p0->getx();
-					dely=p1->gety()-p0->gety();
-					chopline(p0,code0,rect,delx,dely);
-					//printf("x0:%f  y0:%f\n",p0->getx(),p0->gety());
-					code0=compcode(p0,rect);
-					p0->setstate(0);
+					delx=p1.getx()-p0.getx();
+					dely=p1.gety()-p0.gety();
+					chopline(&p0,code0,rect,delx,dely);
+					//printf("x0:%f  y0:%f\n",p0.getx(),p0.gety());
+					code0=compcode(&p0,rect);
+					p0.setstate(0);
 					//endcount++;
 				}
 				else//p1
 				{
-					delx=p1->getx()-p0->getx();
-					dely=p1->gety()-p0->gety();
-					chopline(p1,code1,rect,delx,dely);
-					//printf("x1:%f  y1:%f\n",p1->getx(),p1->gety());
-					code1=compcode(p1,rect);
+					delx=p1.getx()-p0.getx();
+					dely=p1.gety()-p0.gety();
+					chopline(&p1,code1,rect,delx,dely);
+					//printf("x1:%f  y1:%f\n",p1.getx(),p1.gety());
+					code1=compcode(&p1,rect);
 					//endcount++;
 				}
 				//printf("ѭ\n");
@@ -90,8 +80,7 @@ class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect)//ֱ
 			}
 		}while(!done);
 	}
-	//lines->setnum(count);
-	//printf("·:%d\n",count);
+	//printf("·:%d\n",newlines->getnum());
 	return newlines;
 }
 
@@ -144,310 +133,684 @@ void chopline(Ipe_Point2D* p0,int code,cliprect* rect,float delx,float dely)
 	p0->sety(y);
 }
 
-class Ipe_Bazeir* clipbazeir (Ipe_Bazeir* bazeir,cliprect* rect)//üߵĺ,󷵻һµı߼
+static int addroot(double r,double* t,int n)//ֻ(0,1)ڵĸ,˵ɵ߲
 {
-	Ipe_node<Ipe_Point2D>* currentpoint=bazeir->getlist()->headler;
-	/*
-	currentpoint=currentpoint->next;
-	while(currentpoint)
+	if(r>0&&r<1)
+		t[n++]=r;
+	return n;
+}
+
+static int solvecubic(double a,double b,double c,double d,double* t)//a*t^3+b*t^2+c*t+d=0(0,1)ڵʵ,ظĸ
+{
+	const double pi=3.14159265358979323846;
+	double scale=fabs(a)+fabs(b)+fabs(c)+fabs(d);
+	int n=0;
+	if(scale==0)
+		return 0;
+	if(fabs(a)<1e-9*scale)//ɺ,˻Ϊ
 	{
-		printf("ԭ:%f %f %d\n",currentpoint->t->getx(),currentpoint->t->gety(),currentpoint->t->getstate());
-		currentpoint=currentpoint->next;
+		if(fabs(b)<1e-9*scale)//һ
+		{
+			if(c!=0)
+				n=addroot(-d/c,t,n);
+			return n;
+		}
+		double disc=c*c-4*b*d;
+		if(disc<0)
+			return 0;
+		double q=-0.5*(c+(c<0?-sqrt(disc):sqrt(disc)));//
+		n=addroot(q/b,t,n);
+		if(q!=0)
+			n=addroot(d/q,t,n);
+		return n;
 	}
-	currentpoint=bazeir->getlist()->headler;
-	*/
-	Ipe_Bazeir* newbazeir=new Ipe_Bazeir();
-	Ipe_Point2D *p0,*p1,*c0,*c1;//˵Ƶ
-	int state=0;//bazeirߵĲü״̬
-	bool first=true;
-	bool origin=true;
-	currentpoint=currentpoint->next;
-	while(currentpoint)//һ
+	//Ϊt^3+A*t^2+B*t+C=0,ʹÿŵʽ
+	double A=b/a,B=c/a,C=d/a;
+	double Q=(A*A-3*B)/9;
+	double R=(2*A*A*A-9*A*B+27*C)/54;
+	if(R*R<Q*Q*Q)//ʵ
 	{
-			//жĸǷڲü
-			//printf("ʼü\n");
-			if(first)//
-			{
-				p0=currentpoint->t;
-				//printf("ԭ0:%f %f %d\n",currentpoint->t->getx(),currentpoint->t->gety(),currentpoint->t->getstate());
-				first=false;
-				currentpoint=currentpoint->next;
-				currentpoint=currentpoint->next;
-				currentpoint=currentpoint->next;
-				c0=currentpoint->t;
-				currentpoint=currentpoint->next;
-				c1=currentpoint->t;
-				currentpoint=currentpoint->next;
-				p1=currentpoint->t;
-				//printf("ԭ1:%f %f %d\n",currentpoint->t->getx(),currentpoint->t->gety(),currentpoint->t->getstate());
-				currentpoint=currentpoint->next;
-				//printf("\n");
-				//printf(": %f %f \n",p0->getx(),p0->gety());
-			}
-			else
+		double theta=acos(R/sqrt(Q*Q*Q));
+		double m=-2*sqrt(Q);
+		n=addroot(m*cos(theta/3)-A/3,t,n);
+		n=addroot(m*cos((theta+2*pi)/3)-A/3,t,n);
+		n=addroot(m*cos((theta-2*pi)/3)-A/3,t,n);
+	}
+	else//һʵ
+	{
+		double u=-(R<0?-1:1)*pow(fabs(R)+sqrt(R*R-Q*Q*Q),1.0/3);
+		double v=(u==0)?0:Q/u;
+		n=addroot(u+v-A/3,t,n);
+	}
+	return n;
+}
+
+static int crossings(const double* p,double edge,double* t)//ߵһedgeʱĲ,pΪ÷ĸֵ
+{
+	double a=-p[0]+3*p[1]-3*p[2]+p[3];
+	double b=3*p[0]-6*p[1]+3*p[2];
+	double c=-3*p[0]+3*p[1];
+	return solvecubic(a,b,c,p[0]-edge,t);
+}
+
+static double evaluate(const double* p,double t)//һڲtֵ
+{
+	double s=1-t;
+	return s*s*s*p[0]+3*s*s*t*p[1]+3*s*t*t*p[2]+t*t*t*p[3];
+}
+
+static void splitleft(double* p,double t)//de Casteljauϸ,pΪ[0,t]ֵĿֵ
+{
+	double a=p[0]+(p[1]-p[0])*t,b=p[1]+(p[2]-p[1])*t,c=p[2]+(p[3]-p[2])*t;
+	double d=a+(b-a)*t,e=b+(c-b)*t;
+	p[1]=a;
+	p[2]=d;
+	p[3]=d+(e-d)*t;
+}
+
+static void splitright(double* p,double t)//de Casteljauϸ,pΪ[t,1]ֵĿֵ
+{
+	double a=p[0]+(p[1]-p[0])*t,b=p[1]+(p[2]-p[1])*t,c=p[2]+(p[3]-p[2])*t;
+	double d=a+(b-a)*t,e=b+(c-b)*t;
+	p[0]=d+(e-d)*t;
+	p[1]=e;
+	p[2]=c;
+}
+
+static void subsegment(const double* p,double t0,double t1,double* q)//ȡ߶[t0,t1]ֵĸֵ
+{
+	for(int i=0;i<4;i++)
+		q[i]=p[i];
+	if(t1<1)
+		splitleft(q,t1);
+	if(t0>0)
+		splitright(q,t0/t1);//[0,t1]еt0
+}
+
+static double clampvalue(double v,double lo,double hi)
+{
+	return v<lo?lo:(v>hi?hi:v);
+}
+
+static void addsegment(Ipe_Bazeir* bazeir,const double* x,const double* y,bool* connected)//һ,һβʱƶ
+{
+	if(!*connected)
+		bazeir->addmove(x[0],y[0]);
+	bazeir->addpoint(x[1],y[1],x[2],y[2],x[3],y[3],3);
+	*connected=true;
+}
+
+static bool clipsegment(Ipe_Bazeir* newbazeir,const double* px,const double* py,cliprect* rect,bool* connected)//üһ߲ڵĲ,αʱtrue
+{
+	const double eps=1e-6;
+	double qx[4],qy[4];//ϸֳӶ
+	double t[14];//,ÿ,01
+	int j,k,n;
+	double minx=px[0],maxx=px[0],miny=py[0],maxy=py[0];
+	for(j=1;j<4;j++)
+	{
+		minx=px[j]<minx?px[j]:minx;
+		maxx=px[j]>maxx?px[j]:maxx;
+		miny=py[j]<miny?py[j]:miny;
+		maxy=py[j]>maxy?py[j]:maxy;
+	}
+	if(maxx<rect->x0||minx>rect->x1||maxy<rect->y1||miny>rect->y0)//봰ڲཻ,
+	{
+		*connected=false;
+		return false;
+	}
+	if(minx>=rect->x0&&maxx<=rect->x1&&miny>=rect->y1&&maxy<=rect->y0)//ȫڴ,α
+	{
+		addsegment(newbazeir,px,py,connected);
+		return true;
+	}
+	//ֻοı߲ſཻ
+	n=0;
+	t[n++]=0;
+	if(minx<rect->x0&&maxx>rect->x0)
+		n+=crossings(px,rect->x0,t+n);
+	if(minx<rect->x1&&maxx>rect->x1)
+		n+=crossings(px,rect->x1,t+n);
+	if(miny<rect->y1&&maxy>rect->y1)
+		n+=crossings(py,rect->y1,t+n);
+	if(miny<rect->y0&&maxy>rect->y0)
+		n+=crossings(py,rect->y0,t+n);
+	t[n++]=1;
+	for(j=2;j<n-1;j++)//,
+	{
+		double v=t[j];
+		for(k=j;k>1&&t[k-1]>v;k--)
+			t[k]=t[k-1];
+		t[k]=v;
+	}
+	bool whole=true;
+	for(j=0;j+1<n;j++)//֮ĲҪôȫڴ,Ҫôȫڴ,ȡеж
+	{
+		if(t[j+1]-t[j]<1e-9)//ظ
+			continue;
+		double tm=(t[j]+t[j+1])/2;
+		double x=evaluate(px,tm),y=evaluate(py,tm);
+		if(x<rect->x0-eps||x>rect->x1+eps||y<rect->y1-eps||y>rect->y0+eps)
+		{
+			*connected=false;
+			whole=false;
+			continue;
+		}
+		subsegment(px,t[j],t[j+1],qx);
+		subsegment(py,t[j],t[j+1],qy);
+		for(k=0;k<4;k+=3)//˵ڱ,ϸֵ
+		{
+			qx[k]=clampvalue(qx[k],rect->x0,rect->x1);
+			qy[k]=clampvalue(qy[k],rect->y1,rect->y0);
+		}
+		addsegment(newbazeir,qx,qy,connected);
+	}
+	return whole;
+}
+
+class Ipe_Bazeir* clipbazeir (Ipe_Bazeir* bazeir,cliprect* rect,Ipe_Geometry* store)//üߵĺ,󷵻һµı߼
+{
+	//ÿÿƶεж:һ,ȫڴֱӱ,봰ڲֱཻ
+	//ĶߵĽ,ڽ㴦de Casteljau㷨ϸ,ֻڴڵĲ
+	//Ĳʹ߶Ͽ,֮Ĳִƶ¿ʼ
+	//պϿص·:·ʱպϿ,ѻصֱΪ߲ü;պϿռλ㲻
+	Ipe_Bazeir* newbazeir=new Ipe_Bazeir(store);
+	double px[4],py[4];//ǰε,Ƶյ
+	double bx,by;//ǰ·
+	bool connected=false;//һյǷǵǰε
+	bool intact=true;//ǰ·Ƿ
+	int i,j;
+	double box[4];
+	if(!bazeir->getbound(box)||!boxoverlap(box,rect))//߼ڴ
+		return newbazeir;
+	if(boxinside(box,rect))//߼ڴ,ԭ
+	{
+		delete newbazeir;
+		return static_cast<Ipe_Bazeir*>(copycell(bazeir,store));
+	}
+	px[3]=bx=bazeir->getx(0);//,֮Ϊռλ
+	py[3]=by=bazeir->gety(0);
+	for(i=3;i+2<bazeir->GetPointCount();i+=3)//һ,ÿ
+	{
+		int state=bazeir->getstate(i);
+		if(state==0)//ƶ,߱ڴ˶Ͽ
+		{
+			px[3]=bx=bazeir->getx(i);
+			py[3]=by=bazeir->gety(i);
+			connected=false;
+			intact=true;
+			continue;
+		}
+		px[0]=px[3];//Ϊһεյ
+		py[0]=py[3];
+		if(state==2)//պϿ,ص·;м¼ֱ߽ʱ·
+		{
+			bx=bazeir->getx(i);
+			by=bazeir->gety(i);
+			if(intact&&connected)
 			{
-				p0=p1;//,p0ָp1
-				c0=currentpoint->t;
-				currentpoint=currentpoint->next;
-				c1=currentpoint->t;
-				currentpoint=currentpoint->next;
-				//printf("ԭ1:%f %f %d\n",currentpoint->t->getx(),currentpoint->t->gety(),currentpoint->t->getstate());
-				p1=currentpoint->t;
-				currentpoint=currentpoint->next;
+				newbazeir->addpoint(bx,by,-1,-1,-1,-1,2);
 			}
-			//ʱp0,p1,c0,c1ֱ¼Ŷ˵ƵϢ
-			int ps0,ps1,cs0,cs1;//ŵ״̬
-			ps0=compcode(p0, rect);//жĸλ
-			ps1=compcode(p1, rect);
-			cs0=compcode(c0, rect);
-			cs1=compcode(c1, rect);
-			
-			//:
-				//	˵㶼 
-				//  һ˵ 
-				//  ˵㶼  ʱƵ һ 
-													//  ɾ
-			//ܽ::ĸ㶼ڲü(жϵ߽ľ,Сĳֵ,,ɾ);ڵڲü()
-			if((ps0!=0)&&(ps1!=0)&&(cs0!=0)&&(cs1!=0))//ĸڲü
+			else if(px[0]!=bx||py[0]!=by)
 			{
-				//Ĭ,֮Ӿ㺯
-				if(1)
+				for(j=1;j<4;j++)//ֱ߻ΪƵȷִ
 				{
-					//printf("ߵ\n");
-					continue;
+					px[j]=px[0]+(bx-px[0])*j/3;
+					py[j]=py[0]+(by-py[0])*j/3;
 				}
+				clipsegment(newbazeir,px,py,rect,&connected);
 			}
-			if(origin)
-			{
-				newbazeir->addpoint(p0->getx(),p0->gety(),-1,-1,-1,-1,0);//
-				//printf(":%f %f\n",p0->getx(),p0->gety());
-				newbazeir->addpoint(c0->getx(),c0->gety(),c1->getx(),c1->gety(),p1->getx(),p1->gety(),3);
-				origin=false;
-			}
-			else//
-			{
-				newbazeir->addpoint(c0->getx(),c0->gety(),c1->getx(),c1->gety(),p1->getx(),p1->gety(),3);//һ
-				//printf("·:%f %f\n",p1->getx(),p1->gety());
-			}
+			px[3]=bx;
+			py[3]=by;
+			connected=false;
+			intact=true;
+			continue;
+		}
+		for(j=0;j<3;j++)
+		{
+			px[j+1]=bazeir->getx(i+j);
+			py[j+1]=bazeir->gety(i+j);
+		}
+		if(!clipsegment(newbazeir,px,py,rect,&connected))
+			intact=false;
 	}
 	return newbazeir;
 }
 
-int rtinside(Ipe_Point2D* start,Ipe_Point2D* end,Ipe_Point2D* p)
+void initclipbuffer(clipbuffer* buffer)
+{
+	for(int i=0;i<2;i++)
+	{
+		buffer->edges[i]=NULL;
+		buffer->count[i]=0;
+		buffer->capacity[i]=0;
+	}
+	buffer->current=0;
+}
+
+void freeclipbuffer(clipbuffer* buffer)
 {
-	return ((end->getx()-start->getx())*(p->gety()-start->gety())-(p->getx()-start->getx())*(end->gety()-start->gety()))>0?0:1;
+	for(int i=0;i<2;i++)
+	{
+		free(buffer->edges[i]);
+		buffer->edges[i]=NULL;
+		buffer->count[i]=0;
+		buffer->capacity[i]=0;
+	}
+}
+
+static clipedge* pushedge(clipbuffer* buffer,int which)//ڻĩβȡһߵĿռ,ʱ,֮ظʹòٷ
+{
+	if(buffer->count[which]==buffer->capacity[which])
+	{
+		buffer->capacity[which]=buffer->capacity[which]>0?buffer->capacity[which]*2:64;
+		buffer->edges[which]=(clipedge*)realloc(buffer->edges[which],buffer->capacity[which]*sizeof(clipedge));
+	}
+	return &buffer->edges[which][buffer->count[which]++];
 }
 
-Ipe_Point2D* intersection (Ipe_Point2D* l1s,Ipe_Point2D* l1e,Ipe_Point2D* l2s,Ipe_Point2D* l2e)//ֱߵĽ l1s/eΪҪüֱ,l2s/eΪֱ߽
+static void pushline(clipbuffer* buffer,int which,double x0,double y0,double x1,double y1)
 {
-	Ipe_Point2D *p=new Ipe_Point2D();
-	//󱻲üֱߵĵбʽ
-	//printf("üֱ:%f %f \n %f %f \n߽:%f %f \n %f %f\n ",l1s->getx(),l1s->gety(),l1e->getx(),l1e->gety(),l2s->getx(),l2s->gety(),l2e->getx(),l2e->gety());
-	double k1=(l1e->gety()-l1s->gety())/(l1e->getx()-l1s->getx());
-	double b1=l1s->gety()-(k1*l1s->getx());
-	double x,y;
-	if(l2s->getx()==l2e->getx())
+	clipedge* e=pushedge(buffer,which);
+	e->curve=0;
+	e->x[0]=x0;
+	e->y[0]=y0;
+	e->x[3]=x1;
+	e->y[3]=y1;
+}
+
+struct clippen//߲üʱĵǰλ
+{
+	bool down;//Ƿ
+	double x,y;//յ
+	double firstx,firsty;//һߵ
+};
+
+static void pushpiece(clipbuffer* buffer,int which,const clipedge* piece,clippen* pen)//һڰƽڵı,һ֮Ŀȱرֱ߽߲
+{
+	if(!pen->down)
 	{
-		x=l2s->getx();
-		y=(k1*x)+b1;
+		pen->down=true;
+		pen->firstx=piece->x[0];
+		pen->firsty=piece->y[0];
 	}
-	else
+	else if(pen->x!=piece->x[0]||pen->y!=piece->y[0])
 	{
-		y=l2s->gety();
-		x=(y-b1)/k1;
+		pushline(buffer,which,pen->x,pen->y,piece->x[0],piece->y[0]);
 	}
-	//
-	//printf("x y %f %f\n",x,y);
-	p->setx(x);
-	p->sety(y);
-	p->setstate(l1s->getstate());
-	//printf("%f %f %d\n",p->getx(),p->gety(),p->getstate());
-	return p;
+	*pushedge(buffer,which)=*piece;
+	pen->x=piece->x[3];
+	pen->y=piece->y[3];
 }
 
-Ipe_LinkList<Ipe_GraphicCell>* clipplane(Ipe_LinkList<Ipe_GraphicCell>* list,cliprect* rect)//üĺ,һֱ߼߼
+static void clippass(clipbuffer* buffer,int axis,double value,double sign)//Sutherland-Hodgmanһ:ðƽsign*(-value)>=0üǰ,߽ߵĽ㴦ϸ
 {
-	Ipe_LinkList<Ipe_GraphicCell>* newlist=new Ipe_LinkList<Ipe_GraphicCell>();//½
-	Ipe_node<Ipe_GraphicCell>* cgc=list->headler;
-	bool existbazeir=false;
-	while(cgc->next!=NULL)//ȱ·еֱ߼߼(鿴)
+	int src=buffer->current,dst=1-src;
+	clippen pen;
+	clipedge piece;
+	double t[5];
+	int i,j,k,n;
+	pen.down=false;
+	buffer->count[dst]=0;
+	for(i=0;i<buffer->count[src];i++)
 	{
-		cgc=cgc->next;
-		Ipe_GraphicCell* graphiccell=cgc->t;
-		if(graphiccell->gettype()==2)//߼
+		const clipedge* e=&buffer->edges[src][i];
+		const double* p=axis==0?e->x:e->y;
+		bool allin=true,allout=true;
+		for(j=0;j<4;j+=(e->curve?1:3))//ֱֻ˵
 		{
-			existbazeir=true;
+			double d=sign*(p[j]-value);
+			if(d<0)
+				allin=false;
+			if(d>0)
+				allout=false;
+		}
+		if(allin)
+		{
+			pushpiece(buffer,dst,e,&pen);
+			continue;
+		}
+		if(allout)
+			continue;
+		n=0;
+		t[n++]=0;
+		if(e->curve)
+		{
+			n+=crossings(p,value,t+n);
+		}
+		else
+		{
+			double r=(value-p[0])/(p[3]-p[0]);
+			if(r>0&&r<1)
+				t[n++]=r;
+		}
+		t[n++]=1;
+		for(j=2;j<n-1;j++)//
+		{
+			double v=t[j];
+			for(k=j;k>1&&t[k-1]>v;k--)
+				t[k]=t[k-1];
+			t[k]=v;
+		}
+		for(j=0;j+1<n;j++)
+		{
+			if(t[j+1]-t[j]<1e-9)
+				continue;
+			double tm=(t[j]+t[j+1])/2;
+			double v=e->curve?evaluate(p,tm):p[0]+(p[3]-p[0])*tm;
+			if(sign*(v-value)<0)//һڰƽ,ɱ߽ϵĲߴ
+				continue;
+			piece.curve=e->curve;
+			if(e->curve)
+			{
+				subsegment(e->x,t[j],t[j+1],piece.x);
+				subsegment(e->y,t[j],t[j+1],piece.y);
+			}
+			else
+			{
+				piece.x[0]=e->x[0]+(e->x[3]-e->x[0])*t[j];
+				piece.y[0]=e->y[0]+(e->y[3]-e->y[0])*t[j];
+				piece.x[3]=e->x[0]+(e->x[3]-e->x[0])*t[j+1];
+				piece.y[3]=e->y[0]+(e->y[3]-e->y[0])*t[j+1];
+			}
+			double* q=axis==0?piece.x:piece.y;
+			if(j>0)//˵ڱ߽,
+				q[0]=value;
+			if(j+2<n)
+				q[3]=value;
+			pushpiece(buffer,dst,&piece,&pen);
 		}
 	}
-	cgc=list->headler;
-	if(existbazeir)//Ǵڱ߼,·
+	if(pen.down&&(pen.x!=pen.firstx||pen.y!=pen.firsty))//ر߽߻ص
+		pushline(buffer,dst,pen.x,pen.y,pen.firstx,pen.firsty);
+	buffer->current=dst;
+}
+
+static void emitring(clipbuffer* buffer,Ipe_LinkList<Ipe_GraphicCell>* list,Ipe_Geometry* store)//ѲüĻתΪֱ߼߼,ֱ߻߷ͬһ
+{
+	//Ipe_CellBuilderͬ,ÿڱߵ㿪ʼ(ֱ߼״̬0,߼Ϊƶ),мһϵյغ,ǽµ·
+	const clipedge* edges=buffer->edges[buffer->current];
+	int count=buffer->count[buffer->current];
+	Ipe_Lines* lines=NULL;
+	Ipe_Bazeir* bazeir=NULL;
+	for(int i=0;i<count;i++)
 	{
-		//ڲü,ȥ
-		//ڲڲü,ȫ,Էԭ,޸
-		while(cgc->next!=NULL)
+		const clipedge* e=&edges[i];
+		if(e->curve)
 		{
-			cgc=cgc->next;
-			if(cgc->t->gettype()==1)
+			if(lines!=NULL)
 			{
-				Ipe_Lines* line=dynamic_cast<Ipe_Lines*>(cgc->t);
-				Ipe_node<Ipe_Point2D>* currentpoint=line->getlist()->headler;
-				while(currentpoint->next!=0)
-				{
-					currentpoint=currentpoint->next;
-					if(!compcode(currentpoint->t,rect))//ڵڲü
-					{
-						newlist=list;
-						break;
-					}
-				}
+				list->add(lines);
+				lines=NULL;
 			}
-			else if(cgc->t->gettype()==2)
+			if(bazeir==NULL)
 			{
-				Ipe_Bazeir* bazeir=dynamic_cast<Ipe_Bazeir*>(cgc->t);
-				Ipe_node<Ipe_Point2D>* currentpoint=bazeir->getlist()->headler;
-				bool first=true;
-				while(currentpoint->next!=0)
-				{
-					currentpoint=currentpoint->next;
-					if(!compcode(currentpoint->t,rect))//ڵڲü
-					{
-						newlist=list;
-						break;
-					}
-					if(first)
-					{
-						currentpoint=currentpoint->next;
-						currentpoint=currentpoint->next;
-						first=false;
-					}
-				}
+				bazeir=new Ipe_Bazeir(store);
+				bazeir->addmove(e->x[0],e->y[0]);
 			}
-			else
+			bazeir->addpoint(e->x[1],e->y[1],e->x[2],e->y[2],e->x[3],e->y[3],3);
+		}
+		else
+		{
+			if(bazeir!=NULL)
 			{
-				printf("graphiccellԱ\n");
+				list->add(bazeir);
+				bazeir=NULL;
 			}
+			if(lines==NULL)
+			{
+				lines=new Ipe_Lines(store);
+				lines->addpoint(e->x[0],e->y[0],0);
+			}
+			lines->addpoint(e->x[3],e->y[3],i==count-1?2:1);//һ߻ص,Ϊպ
 		}
 	}
-	else//߹ɵ,ʹsutherland-hodgman㷨߲ü
+	if(lines!=NULL)
+		list->add(lines);
+	else if(bazeir!=NULL)
+		list->add(bazeir);
+}
+
+static void clipring(clipbuffer* buffer,cliprect* rect,Ipe_LinkList<Ipe_GraphicCell>* list,Ipe_Geometry* store)//üеһ,ӵlist
+{
+	clipedge* edges=buffer->edges[buffer->current];
+	int count=buffer->count[buffer->current];
+	int i,j;
+	if(count==0)
+		return;
+	//ĿƵ,ȫڴԭ,봰ڲཻ
+	double minx=edges[0].x[0],maxx=minx,miny=edges[0].y[0],maxy=miny;
+	for(i=0;i<count;i++)
 	{
-		//printf("ʹsutherland-hodgman㷨߲ü\n");
-		int flag=0;//flagΪ0ʾڱ߽ⲿ,Ϊһʾڱ߽ڲ
-		Ipe_Lines* rline=new Ipe_Lines();//ž·,߽вü
-		rline->addpoint(rect->x0,rect->y0,0);
-		rline->addpoint(rect->x1,rect->y0,0);
-		rline->addpoint(rect->x1,rect->y1,0);
-		rline->addpoint(rect->x0,rect->y1,0);
-		rline->addpoint(rect->x0,rect->y0,0);
-		Ipe_node<Ipe_Point2D>* start=rline->getlist()->headler;
-		Ipe_node<Ipe_Point2D>* end=start->next;
-		
-		cgc=cgc->next;
-		Ipe_Lines* line=dynamic_cast<Ipe_Lines*>(cgc->t);
-		Ipe_Lines* res=new Ipe_Lines();//ɵ·
-		Ipe_node<Ipe_Point2D>* lp=line->getlist()->headler;//lpΪҪüĵָ
-		Ipe_Point2D* p=new Ipe_Point2D();//
+		for(j=0;j<4;j+=(edges[i].curve?1:3))
+		{
+			minx=edges[i].x[j]<minx?edges[i].x[j]:minx;
+			maxx=edges[i].x[j]>maxx?edges[i].x[j]:maxx;
+			miny=edges[i].y[j]<miny?edges[i].y[j]:miny;
+			maxy=edges[i].y[j]>maxy?edges[i].y[j]:maxy;
+		}
+	}
+	if(maxx<rect->x0||minx>rect->x1||maxy<rect->y1||miny>rect->y0)
+		return;
+	//ֻԻı߽ü
+	if(minx<rect->x0)
+		clippass(buffer,0,rect->x0,1);
+	if(maxx>rect->x1)
+		clippass(buffer,0,rect->x1,-1);
+	if(miny<rect->y1)
+		clippass(buffer,1,rect->y1,1);
+	if(maxy>rect->y0)
+		clippass(buffer,1,rect->y0,-1);
+	emitring(buffer,list,store);
+}
+
+struct ringreader//ֱ߼߼в
+{
+	clipbuffer* buffer;
+	cliprect* rect;
+	Ipe_LinkList<Ipe_GraphicCell>* list;
+	Ipe_Geometry* store;
+	bool open;//Ƿеǰ
+	double x,y;//ǰ
+	double beginx,beginy;//ǰ·
+};
+
+static void endring(ringreader* r)//ǰ:ʽպϺü
+{
+	clipbuffer* buffer=r->buffer;
+	if(buffer->count[buffer->current]>0)
+	{
+		if(r->x!=r->beginx||r->y!=r->beginy)
+			pushline(buffer,buffer->current,r->x,r->y,r->beginx,r->beginy);
+		clipring(buffer,r->rect,r->list,r->store);
+	}
+	buffer->current=0;
+	buffer->count[0]=0;
+}
 
-		for(int i=0;i<4;i++)//Ĵ
+static void moveto(ringreader* r,double x,double y)
+{
+	endring(r);
+	r->open=true;
+	r->x=r->beginx=x;
+	r->y=r->beginy=y;
+}
+
+static void lineto(ringreader* r,double x,double y)
+{
+	if(!r->open)
+	{
+		moveto(r,x,y);
+		return;
+	}
+	pushline(r->buffer,r->buffer->current,r->x,r->y,x,y);
+	r->x=x;
+	r->y=y;
+}
+
+static void closering(ringreader* r)//h:ص·,֮ĵ㿪ʼµ·
+{
+	double x=r->beginx,y=r->beginy;
+	moveto(r,x,y);
+}
+
+Ipe_LinkList<Ipe_GraphicCell>* clipplane(Ipe_LinkList<Ipe_GraphicCell>* list,cliprect* rect,Ipe_Geometry* store,clipbuffer* buffer)//üĺ,һֱ߼߼
+{
+	//水SVGʱĺɻ:ֱ߼״̬0Ϊƶ,1Ϊֱ,2Ϊص·;߼ֻ濪ͷʱΪƶ,
+	//֮״̬Ϊ0ĿΪƶ,״̬Ϊ2ĿΪպ,Ϊ߶
+	//ÿSutherland-Hodgman㷨βü,͹,ڸĻ,˴ż򶼱ȷ
+	Ipe_LinkList<Ipe_GraphicCell>* newlist=new Ipe_LinkList<Ipe_GraphicCell>();
+	clipbuffer local;
+	ringreader r;
+	int i;
+	double box[4];
+	if(!cellsbound(list,box)||!boxoverlap(box,rect))//ڴ
+		return newlist;
+	if(boxinside(box,rect))//ڴ,ԭ
+	{
+		Ipe_node<Ipe_GraphicCell>* p=list->headler;
+		while(p->next!=NULL)
+		{
+			p=p->next;
+			newlist->add(copycell(p->t,store));
+		}
+		return newlist;
+	}
+	if(buffer==NULL)//δʱεʹԼĻ
+	{
+		initclipbuffer(&local);
+		buffer=&local;
+	}
+	buffer->current=0;
+	buffer->count[0]=0;
+	r.buffer=buffer;
+	r.rect=rect;
+	r.list=newlist;
+	r.store=store;
+	r.open=false;
+	r.x=r.y=r.beginx=r.beginy=0;
+	Ipe_node<Ipe_GraphicCell>* cgc=list->headler;
+	while(cgc->next!=NULL)
+	{
+		cgc=cgc->next;
+		if(cgc->t->gettype()==1)//ֱ߼
 		{
-			start=start->next;
-			end=end->next;
-			bool first=true;
-			bool deletestart=false;
-			//printf("%d\n",i);
-			while(lp->next!=NULL)
+			Ipe_Lines* lines=static_cast<Ipe_Lines*>(cgc->t);
+			for(i=0;i<lines->getnum();i++)
 			{
-				lp=lp->next;
-				//printf("%f %f %d\n",lp->t->getx(),lp->t->gety(),lp->t->getstate());
-				if(first)
-				{
-					p->setx(lp->t->getx());
-					p->sety(lp->t->gety());
-					p->setstate(lp->t->getstate());
-					flag=rtinside(start->t,end->t,p);
-					if(flag==1)//ڲ
-					{
-						res->addpoint(p);
-					}
-					else
-					{
-						deletestart=true;
-					}
-					first=false;
+				int state=lines->getstate(i);
+				if(state==0&&i==0&&r.open&&lines->getx(i)==r.x&&lines->gety(i)==r.y)//߼ֱ֮߼ڽظ,µ·
 					continue;
+				if(state==0)
+					moveto(&r,lines->getx(i),lines->gety(i));
+				else if(state==2)
+				{
+					lineto(&r,r.beginx,r.beginy);
+					closering(&r);
 				}
-
-				if(rtinside(start->t,end->t,lp->t)==0)//ǰڱ߽ⲿ
+				else
+					lineto(&r,lines->getx(i),lines->gety(i));
+			}
+		}
+		else if(cgc->t->gettype()==2)//߼
+		{
+			Ipe_Bazeir* bazeir=static_cast<Ipe_Bazeir*>(cgc->t);
+			if(bazeir->GetPointCount()==0)
+				continue;
+			if(!r.open)
+				moveto(&r,bazeir->getx(0),bazeir->gety(0));
+			for(i=3;i+2<bazeir->GetPointCount();i+=3)
+			{
+				int state=bazeir->getstate(i);
+				if(state==0)
 				{
-					if(flag==1)//
-					{
-						flag=0;
-						Ipe_Point2D* cp;
-						//߽罻
-						cp=intersection (p,lp->t,start->t,end->t);
-						res->addpoint(cp);//߽Ľ
-					}
+					moveto(&r,bazeir->getx(i),bazeir->gety(i));
 				}
-				else //ڱ߽ڲ
+				else if(state==2)
 				{
-					if(flag==0)//
-					{
-						flag=1;
-						Ipe_Point2D* cp;
-						//߽罻
-						cp=intersection (p,lp->t,start->t,end->t);
-						res->addpoint(cp);//߽Ľ
-						res->addpoint(lp->t);
-					}
-					else
-					{
-						res->addpoint(lp->t);//ڲüڲ	
-					}
+					lineto(&r,r.beginx,r.beginy);
+					closering(&r);
 				}
-				p->setx(lp->t->getx());
-				p->sety(lp->t->gety());
-				p->setstate(lp->t->getstate());
-				//printf("%f %f %d\n",p->getx(),p->gety(),p->getstate());
-			}
-			//һѭ
-			if(deletestart==true)
-			{
-				if(res->getlist()->headler!=NULL&&res->getlist()->headler->next!=NULL)
+				else
 				{
-					Ipe_Point2D* sp=new Ipe_Point2D(res->getlist()->headler->next->t->getx(),res->getlist()->headler->next->t->gety(),res->getlist()->headler->next->t->getstate());
-					res->addpoint(sp);
+					clipedge* e=pushedge(buffer,buffer->current);
+					e->curve=1;
+					e->x[0]=r.x;
+					e->y[0]=r.y;
+					for(int j=0;j<3;j++)
+					{
+						e->x[j+1]=bazeir->getx(i+j);
+						e->y[j+1]=bazeir->gety(i+j);
+					}
+					r.x=e->x[3];
+					r.y=e->y[3];
 				}
 			}
-			/*
-			lp=res->getlist()->headler;
-			printf("%dβü\n",i);
-			while(lp->next!=NULL)
-			{
-				lp=lp->next;
-				printf("%f %f %d\n",lp->t->getx(),lp->t->gety(),lp->t->getstate());
-			}
-			*/
-			lp=res->getlist()->headler;
-			if(i!=3)
-			{
-				res=new Ipe_Lines();
-			}
 		}
-		if(res->getlist()->headler->next!=NULL)
+		else
 		{
-			res->getlist()->headler->next->t->setstate(0);
+			printf("graphiccellԱ\n");
 		}
-		newlist->add(res);
 	}
-	/*
-	Ipe_node<class Ipe_GraphicCell> *p=newlist->headler->next;
-	Ipe_Lines *k=dynamic_cast<Ipe_Lines*>(p->t);
-	Ipe_node<Ipe_Point2D>*cp=k->getlist()->headler;
-	printf("ü:\n");
-	while(cp->next!=NULL)
+	endring(&r);
+	if(buffer==&local)
+		freeclipbuffer(&local);
+	return newlist;
+}
+
+Ipe_GraphicCell* copycell(Ipe_GraphicCell* cell,Ipe_Geometry* store)
+{
+	int count=cell->GetPointCount();
+	if(cell->gettype()==2)
 	{
-		cp=cp->next;
-		printf("%f %f %d\n",cp->t->getx(),cp->t->gety(),cp->t->getstate());
+		Ipe_Bazeir* bazeir=new Ipe_Bazeir(store);
+		for(int i=0;i+2<count;i+=3)
+			bazeir->addpoint(cell->getx(i),cell->gety(i),cell->getx(i+1),cell->gety(i+1),cell->getx(i+2),cell->gety(i+2),cell->getstate(i));
+		return bazeir;
 	}
-	*/
-	return newlist;
-}
\ No newline at end of file
+	Ipe_Lines* lines=new Ipe_Lines(store);
+	for(int i=0;i<count;i++)
+		lines->addpoint(cell->getx(i),cell->gety(i),cell->getstate(i));
+	return lines;
+}
+
+bool cellsbound(Ipe_LinkList<Ipe_GraphicCell>* list,double* box)
+{
+	bool empty=true;
+	double b[4];
+	Ipe_node<Ipe_GraphicCell>* cgc=list->headler;
+	while(cgc->next!=NULL)
+	{
+		cgc=cgc->next;
+		if(!cgc->t->getbound(b))
+			continue;
+		if(empty)
+		{
+			box[0]=b[0];
+			box[1]=b[1];
+			box[2]=b[2];
+			box[3]=b[3];
+			empty=false;
+			continue;
+		}
+		if(b[0]<box[0])
+			box[0]=b[0];
+		if(b[2]>box[2])
+			box[2]=b[2];
+		if(b[1]<box[1])
+			box[1]=b[1];
+		if(b[3]>box[3])
+			box[3]=b[3];
+	}
+	return !empty;
+}
+
+bool boxinside(const double* box,cliprect* rect)
+{
+	return box[0]>=rect->x0&&box[2]<=rect->x1&&box[1]>=rect->y1&&box[3]<=rect->y0;
+}
+
+bool boxoverlap(const double* box,cliprect* rect)
+{
+	return box[0]<=rect->x1&&box[2]>=rect->x0&&box[1]<=rect->y0&&box[3]>=rect->y1;
+}
@@ -3,6 +3,7 @@
 #include "Ipe_Bazeir.h"
 #include "Ipe_LinkList.h"
 #include "Ipe_GraphicCell.h"
+#include "Ipe_Geometry.h"
 #define LEFT_EDGE 1//ñ߽
 #define RIGHT_EDGE 2
 #define BOTTOM_EDGE 4
@@ -16,10 +17,30 @@ struct cliprect
 	float y1;
 };
 
-class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect);//üֱ߼ĺ,󷵻һµĽڵ
+struct clipedge//üʱһ,ֱֻx[0],x[3]˵,ΪĸƵ
+{
+	double x[4];
+	double y[4];
+	int curve;
+};
+
+struct clipbuffer//üʱ,߽Ϊÿβü,ڶε֮ظʹ
+{
+	clipedge* edges[2];
+	int count[2];
+	int capacity[2];
+	int current;//ǰڵһ
+};
+
+class Ipe_Lines* cliplines(Ipe_Lines* lines,cliprect* rect,Ipe_Geometry* store);//üֱ߼ĺ,󷵻һµĽڵ,µӵstore
 int compcode(Ipe_Point2D *p0,cliprect* rect);//üɱĺ
 void chopline(Ipe_Point2D* p0,int code,cliprect* rect,float delx,float dely);//ƽֱߵĺ
 
-class Ipe_Bazeir* clipbazeir (Ipe_Bazeir* bazeir,cliprect* rect);//üߵĺ,󷵻һµı߼
-int rtinside(Ipe_Point2D* start,Ipe_Point2D* end,Ipe_Point2D* p);//ֱߵķ
-Ipe_LinkList<Ipe_GraphicCell>* clipplane(Ipe_LinkList<Ipe_GraphicCell>* list,cliprect* rect);//üĺ,һֱ߼߼
\ No newline at end of file
+class Ipe_Bazeir* clipbazeir (Ipe_Bazeir* bazeir,cliprect* rect,Ipe_Geometry* store);//üߵĺ,봰ڱ߽Ľ㴦ϸ,һµı߼,ϿΪƶ
+void initclipbuffer(clipbuffer* buffer);
+void freeclipbuffer(clipbuffer* buffer);
+Ipe_LinkList<Ipe_GraphicCell>* clipplane(Ipe_LinkList<Ipe_GraphicCell>* list,cliprect* rect,Ipe_Geometry* store,clipbuffer* buffer=NULL);//üĺ,һµֱ߼߼,bufferΪNULLʱʱ
+Ipe_GraphicCell* copycell(Ipe_GraphicCell* cell,Ipe_Geometry* store);//ֱ߼߼ĵԭƵstore,ͬ͵¶
+bool cellsbound(Ipe_LinkList<Ipe_GraphicCell>* list,double* box);//һֱ߼߼İΧ,ɸԻİΧкϲ,boxΪx0,y0,x1,y1;ûеʱfalse
+bool boxinside(const double* box,cliprect* rect);//Χȫڴ
+bool boxoverlap(const double* box,cliprect* rect);//Χ봰ཻ
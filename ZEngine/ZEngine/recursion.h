@@ -2,7 +2,6 @@
 #include "Ipe_LinkList.h"
 #include "Ipe_PdfStack.h"
 //#include "MuInclude.h"
-int grade=0;
 int getlength(routepoint* clipheadler)
 {
 	int count=0;
@@ -21,101 +20,112 @@ int getlength(routepoint* clipheadler)
 }
 
 
-void recursion(Ipe_LinkList<Ipe_PdfElement>* list,struct zblstack* cs,float* cm,struct  routepoint* clipheadler,int cliptype)
+fz_matrix getstackmatrix(struct zblstack* cs)//ȡջм¼תþ
 {
-	//жǷcm,clip,ֱǰջǶջ
-	if(cm!=NULL)//תþ
+	fz_matrix m;
+	m.a=cs->matrix[0];
+	m.b=cs->matrix[1];
+	m.c=cs->matrix[2];
+	m.d=cs->matrix[3];
+	m.e=cs->matrix[4];
+	m.f=cs->matrix[5];
+	return m;
+}
+
+void setstackmatrix(struct zblstack* cs,fz_matrix m)
+{
+	cs->matrix[0]=m.a;
+	cs->matrix[1]=m.b;
+	cs->matrix[2]=m.c;
+	cs->matrix[3]=m.d;
+	cs->matrix[4]=m.e;
+	cs->matrix[5]=m.f;
+}
+
+void mergestack(struct zblstack* cs,struct zblstack* parent)//ջ(Ѻϲ)תþϲڲջ,ü·ɲü±̳
+{
+	if(parent->existcm)//תþ
 	{
-		if(cs->existcm)//ڲҲתþ
+		if(cs->existcm)//ڲҲתþ,Ⱦڲ,پ
 		{
-			cs->matrix[0]=cs->matrix[0]*cm[0]+cs->matrix[1]*cm[2];
-			cs->matrix[1]=cs->matrix[0]*cm[1]+cs->matrix[1]*cm[3];
-			cs->matrix[2]=cs->matrix[2]*cm[0]+cs->matrix[3]*cm[2];
-			cs->matrix[3]=cs->matrix[2]*cm[1]+cs->matrix[3]*cm[3];
-			cs->matrix[4]=cs->matrix[4]*cm[0]+cs->matrix[5]*cm[2]+cs->matrix[4];
-			cs->matrix[5]=cs->matrix[4]*cm[1]+cs->matrix[5]*cm[3]+cs->matrix[5];
+			setstackmatrix(cs,fz_concat(getstackmatrix(cs),getstackmatrix(parent)));
 		}
-		else//ڲ㲻תþ,ڲи
+		else//ڲ㲻תþ,㸴Ƶڲ
 		{
-			cs->matrix[0]=cm[0];
-			cs->matrix[1]=cm[1];
-			cs->matrix[2]=cm[2];
-			cs->matrix[3]=cm[3];
-			cs->matrix[4]=cm[4];
-			cs->matrix[5]=cm[5];
+			setstackmatrix(cs,getstackmatrix(parent));
 			cs->existcm=1;
 		}
 	}
-	//ڵ?
-	else//㲻
-	{
-		/*
-		if(cs->existcm)//ڲתþ
-		{
-			cs->matrix[0]=cs->matrix[0]*cm[0]+cs->matrix[1]*cm[2];
-			cs->matrix[1]=cs->matrix[0]*cm[1]+cs->matrix[1]*cm[3];
-			cs->matrix[2]=cs->matrix[2]*cm[0]+cs->matrix[3]*cm[2];
-			cs->matrix[3]=cs->matrix[2]*cm[1]+cs->matrix[3]*cm[3];
-			cs->matrix[4]=cs->matrix[4]*cm[0]+cs->matrix[5]*cm[2]+cs->matrix[4];
-			cs->matrix[5]=cs->matrix[4]*cm[1]+cs->matrix[5]*cm[3]+cs->matrix[5];
-		}
-		*/
-	}
-	if(cliptype!=0)//ڲü·
+}
+
+struct stackframe//ջʱһ
+{
+	struct zblstack* stack;//ջ,ϲ
+	struct zblstack* child;//һǶջ,ʼΪǶջͷ
+	int grade;//ջĲ
+	int clip;//ЧĲüڲüе±,-1Ϊ
+};
+
+int internclip(Ipe_ClipTable* clips,struct zblstack* cs,int parent,Ipe_Geometry* store)//ջԼĲüü,رջЧĲü±
+{
+	if(cs->existclip==0)//ûµĲü,
+		return parent;
+	return clips->intern(cs->clipheadler,cs->countclip,cs->existclip,parent,getstackmatrix(cs),cs->existcm,store);
+}
+
+void recursion(Ipe_LinkList<Ipe_PdfElement>* list,Ipe_Geometry* store,Ipe_StyleTable* styles,Ipe_ClipTable* clips,struct zblstack* stackheadler)//ҳջ,ϲתþü·Ipe_PdfStack,storeΪҳļδ洢,stylesΪҳʽ,clipsΪҳĲü
+{
+	//ʹʽջݹ,ǶҲľջ
+	int size=16;
+	int top=0;
+	struct stackframe* frames=(struct stackframe*)malloc(size*sizeof(struct stackframe));
+	struct zblstack* cs=stackheadler;
+	while(cs->nextstack!=NULL)
 	{
-		if(cs->existclip)//ڲҲ
+		cs=cs->nextstack;//ջ
+		int clip=internclip(clips,cs,-1,store);
+		Ipe_PdfStack* stack=new Ipe_PdfStack(cs,store,styles,clips,clip);
+		stack->setgrade(0);
+		list->add(stack);
+		if(cs->existnest==0)//Ƕջ
+			continue;
+		frames[0].stack=cs;
+		frames[0].child=cs->stackheadler;
+		frames[0].grade=0;
+		frames[0].clip=clip;
+		top=1;
+		while(top>0)
 		{
-			//вü·ĺϲ
-			struct routepoint* p=clipheadler;
-			while(p->nextpoint!=NULL)
+			struct stackframe* f=&frames[top-1];
+			if(f->child->nextstack==NULL)//Ƕջѱ
 			{
-				p=p->nextpoint;
+				top--;
+				continue;
 			}
-			p->nextpoint=cs->clipheadler->nextpoint;
-		}
-		else//ڲ㲻 ü·Ƶڲü·
-		{
-			cs->existclip=cliptype;//ڲü·͵
-			cs->clipheadler=(struct routepoint*)malloc(sizeof(struct routepoint));
-			cs->currentclip=cs->clipheadler;
-			cs->currentclip->nextpoint=NULL;
-			cs->countclip=getlength(clipheadler);
-			struct routepoint* cc=clipheadler;
-			while(cc->nextpoint!=NULL)
+			f->child=f->child->nextstack;
+			struct zblstack* k=f->child;
+			int grade=f->grade+1;
+			mergestack(k,f->stack);//Ѻϲ,ֻϲһ
+			clip=internclip(clips,k,f->clip,store);
+			stack=new Ipe_PdfStack(k,store,styles,clips,clip);
+			stack->setgrade(grade);
+			list->add(stack);
+			if(k->existnest!=0)//Ƕջ,һ
 			{
-				cc=cc->nextpoint;
-				struct routepoint* p=(struct routepoint*)malloc(sizeof(struct routepoint));
-				p->nextpoint=NULL;
-				p->p0=cc->p0;
-				p->p1=cc->p1;
-				p->p2=cc->p2;
-				p->p3=cc->p3;
-				p->p4=cc->p4;
-				p->p5=cc->p5;
-				p->state=cc->state;
-				cs->currentclip->nextpoint=p;
-				cs->currentclip=cs->currentclip->nextpoint;
+				if(top==size)
+				{
+					size*=2;
+					frames=(struct stackframe*)realloc(frames,size*sizeof(struct stackframe));
+				}
+				frames[top].stack=k;
+				frames[top].child=k->stackheadler;
+				frames[top].grade=grade;
+				frames[top].clip=clip;
+				top++;
 			}
 		}
 	}
-	Ipe_PdfStack* stack=new Ipe_PdfStack(cs);
-	stack->setgrade(grade);
-	list->add(stack);
-	if(cs->existnest==0)//Ƕջ
-	{
-		return;
-	}
-	else//Ƕջ
-	{
-		zblstack* k=cs->stackheadler;
-		while(k->nextstack!=NULL)
-		{
-			k=k->nextstack;
-			grade++;
-			recursion(list,k,cs->matrix,cs->clipheadler,cs->existclip);//Ƕ׵
-			grade--;
-		}
-	}
+	free(frames);
 }
 
 
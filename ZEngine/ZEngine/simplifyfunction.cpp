@@ -0,0 +1,277 @@
+#include "simplifyfunction.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <queue>
+
+static double segmentdistance(double px,double py,double ax,double ay,double bx,double by)//㵽߶εľ,߶˻ΪʱΪľ
+{
+	double dx=bx-ax,dy=by-ay;
+	double len=dx*dx+dy*dy;
+	double t=0;
+	if(len>0)
+	{
+		t=((px-ax)*dx+(py-ay)*dy)/len;
+		if(t<0)
+			t=0;
+		else if(t>1)
+			t=1;
+	}
+	double ex=ax+t*dx-px,ey=ay+t*dy-py;
+	return sqrt(ex*ex+ey*ey);
+}
+
+void simplifydouglas(const double* x,const double* y,int count,double tolerance,char* keep)
+{
+	if(count<=0)
+		return;
+	memset(keep,0,count);
+	keep[0]=1;
+	keep[count-1]=1;
+	std::vector<int> stack;//,ջݹ
+	stack.push_back(0);
+	stack.push_back(count-1);
+	while(!stack.empty())
+	{
+		int last=stack.back();
+		stack.pop_back();
+		int first=stack.back();
+		stack.pop_back();
+		int best=-1;
+		double dmax=tolerance;
+		for(int i=first+1;i<last;i++)
+		{
+			double d=segmentdistance(x[i],y[i],x[first],y[first],x[last],y[last]);
+			if(d>dmax)
+			{
+				dmax=d;
+				best=i;
+			}
+		}
+		if(best<0)
+			continue;
+		keep[best]=1;
+		stack.push_back(first);
+		stack.push_back(best);
+		stack.push_back(best);
+		stack.push_back(last);
+	}
+}
+
+struct vwentry//С,º汾
+{
+	double area;
+	int index;
+	int version;
+	bool operator<(const vwentry& other) const{return area>other.area;}
+};
+
+static double trianglearea(const double* x,const double* y,int a,int b,int c)
+{
+	return fabs((x[b]-x[a])*(y[c]-y[a])-(x[c]-x[a])*(y[b]-y[a]))/2;
+}
+
+void simplifyvisvalingam(const double* x,const double* y,int count,double tolerance,char* keep)
+{
+	if(count<=0)
+		return;
+	memset(keep,1,count);
+	if(count<3)
+		return;
+	double threshold=tolerance*tolerance;
+	std::vector<int> prev(count),next(count),version(count,0);
+	std::priority_queue<vwentry> heap;
+	for(int i=0;i<count;i++)
+	{
+		prev[i]=i-1;
+		next[i]=i+1;
+	}
+	for(int i=1;i<count-1;i++)
+	{
+		vwentry e={trianglearea(x,y,i-1,i,i+1),i,0};
+		heap.push(e);
+	}
+	double removed=0;//ȥ,С,֤ȥ˳򵥵
+	while(!heap.empty())
+	{
+		vwentry e=heap.top();
+		heap.pop();
+		if(e.version!=version[e.index]||!keep[e.index])
+			continue;
+		if(e.area>threshold)
+			break;
+		int i=e.index;
+		keep[i]=0;
+		if(e.area>removed)
+			removed=e.area;
+		int p=prev[i],n=next[i];
+		next[p]=n;
+		prev[n]=p;
+		if(p>0)//β㲻
+		{
+			double a=trianglearea(x,y,prev[p],p,n);
+			vwentry u={a<removed?removed:a,p,++version[p]};
+			heap.push(u);
+		}
+		if(n<count-1)
+		{
+			double a=trianglearea(x,y,p,n,next[n]);
+			vwentry u={a<removed?removed:a,n,++version[n]};
+			heap.push(u);
+		}
+	}
+}
+
+static void simplifysection(const double* x,const double* y,int count,int method,double tolerance,char* keep)
+{
+	if(method==IPE_SIMPLIFY_VISVALINGAM)
+		simplifyvisvalingam(x,y,count,tolerance,keep);
+	else
+		simplifydouglas(x,y,count,tolerance,keep);
+}
+
+void simplifychain(const double* x,const double* y,int count,const char* fixed,int method,double tolerance,char* keep)
+{
+	std::vector<double> sx,sy;
+	std::vector<char> sk;
+	int first=0;
+	if(count<=0)
+		return;
+	keep[0]=1;
+	for(int last=1;last<count;last++)
+	{
+		if(last<count-1&&(fixed==NULL||!fixed[last]))
+			continue;
+		keep[last]=1;
+		int n=last-first+1;
+		if(n>2)
+		{
+			//Զ˵СһΪ,߻ͬĵ
+			bool reverse=x[last]<x[first]||(x[last]==x[first]&&y[last]<y[first]);
+			sx.resize(n);
+			sy.resize(n);
+			sk.resize(n);
+			for(int i=0;i<n;i++)
+			{
+				int k=reverse?last-i:first+i;
+				sx[i]=x[k];
+				sy[i]=y[k];
+			}
+			if(sx[0]==sx[n-1]&&sy[0]==sy[n-1])//պϵĻ,˻Ϊ,Զٷһ
+			{
+				int far=0;
+				double dmax=-1;
+				for(int i=1;i<n-1;i++)
+				{
+					double d=(sx[i]-sx[0])*(sx[i]-sx[0])+(sy[i]-sy[0])*(sy[i]-sy[0]);
+					if(d>dmax)
+					{
+						dmax=d;
+						far=i;
+					}
+				}
+				simplifysection(&sx[0],&sy[0],far+1,method,tolerance,&sk[0]);
+				simplifysection(&sx[far],&sy[far],n-far,method,tolerance,&sk[far]);
+			}
+			else
+			{
+				simplifysection(&sx[0],&sy[0],n,method,tolerance,&sk[0]);
+			}
+			for(int i=1;i<n-1;i++)
+				keep[reverse?last-i:first+i]=sk[i];
+		}
+		first=last;
+	}
+}
+
+static unsigned int pointhash(double x,double y)
+{
+	unsigned int h[4];
+	x+=0.0;//-00ͬ
+	y+=0.0;
+	memcpy(h,&x,8);
+	memcpy(h+2,&y,8);
+	unsigned int v=2166136261u;
+	for(int i=0;i<4;i++)
+	{
+		v^=h[i];
+		v*=16777619u;
+		v^=v>>15;
+	}
+	return v;
+}
+
+void initsharetable(struct sharetable* table,int capacity)
+{
+	int size=16;
+	while(size<capacity*2)
+		size*=2;
+	table->size=size;
+	table->used=0;
+	table->x=(double*)malloc(size*sizeof(double));
+	table->y=(double*)malloc(size*sizeof(double));
+	table->count=(int*)malloc(size*sizeof(int));
+	table->owner=(int*)malloc(size*sizeof(int));
+	memset(table->count,0,size*sizeof(int));
+}
+
+void freesharetable(struct sharetable* table)
+{
+	free(table->x);
+	free(table->y);
+	free(table->count);
+	free(table->owner);
+	table->size=0;
+	table->used=0;
+}
+
+static int sharefind(struct sharetable* table,double x,double y)//ڵĲ,ûʱΪղ
+{
+	int mask=table->size-1;
+	int i=pointhash(x,y)&mask;
+	while(table->count[i]!=0&&(table->x[i]!=x||table->y[i]!=y))
+		i=(i+1)&mask;
+	return i;
+}
+
+void shareadd(struct sharetable* table,double x,double y,int owner)
+{
+	if((table->used+1)*2>table->size)//һµװ
+	{
+		struct sharetable bigger;
+		initsharetable(&bigger,table->size);
+		for(int k=0;k<table->size;k++)
+		{
+			if(table->count[k]==0)
+				continue;
+			int j=sharefind(&bigger,table->x[k],table->y[k]);
+			bigger.x[j]=table->x[k];
+			bigger.y[j]=table->y[k];
+			bigger.count[j]=table->count[k];
+			bigger.owner[j]=table->owner[k];
+		}
+		bigger.used=table->used;
+		freesharetable(table);
+		*table=bigger;
+	}
+	int i=sharefind(table,x,y);
+	if(table->count[i]==0)
+	{
+		table->x[i]=x;
+		table->y[i]=y;
+		table->count[i]=1;
+		table->owner[i]=owner;
+		table->used++;
+	}
+	else if(table->owner[i]!=owner)
+	{
+		table->count[i]++;
+		table->owner[i]=owner;
+	}
+}
+
+int sharecount(struct sharetable* table,double x,double y)
+{
+	return table->count[sharefind(table,x,y)];
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "MuInclude.h"
+#define IPE_SIMPLIFY_DOUGLAS 1//Douglas-Peucker,ȥҾ벻ݲĵ
+#define IPE_SIMPLIFY_VISVALINGAM 2//Visvalingam-Whyatt,ȥЧݲƽĵ
+
+struct sharetable//ȫͬĵĹ,Ŷַɢ,ڱҪعߵ
+{
+	double* x;
+	double* y;
+	int* count;//ڶͬ
+	int* owner;//߱,ͬһظĵֻһ
+	int size;//2
+	int used;
+};
+
+//keepΪ,10ȥ,βǱ;ݲΪҳ浥λ
+void simplifydouglas(const double* x,const double* y,int count,double tolerance,char* keep);
+void simplifyvisvalingam(const double* x,const double* y,int count,double tolerance,char* keep);
+void simplifychain(const double* x,const double* y,int count,const char* fixed,int method,double tolerance,char* keep);//fixedǵĵ㴦ֶκԻ,ÿΰ˵ĴС,෴Ҳõͬ;βغϵĶȡԶĵΪ
+void initsharetable(struct sharetable* table,int capacity);//capacityΪԤƵĵ
+void freesharetable(struct sharetable* table);
+void shareadd(struct sharetable* table,double x,double y,int owner);
+int sharecount(struct sharetable* table,double x,double y);//ûмĵ㷵0
@@ -1,10 +1,101 @@
 #include<stdio.h>
 #include <string>
 #include <fstream>
+#include <time.h>
 #include "Ipe_Lines.h"
-int main()
+#include "Ipe_Bazeir.h"
+#include "Ipe_Plane.h"
+#include "Ipe_PdfPath.h"
+#include "Ipe_PdfStack.h"
+#include "Ipe_PdfPage.h"
+#include "Ipe_PdfDocument.h"
+
+int traversecells(Ipe_PdfPage* page,bool usetag)//һҳֱ߼߼,·,usetagΪfalseʱʹdynamic_cast
+{
+	int count=0;
+	Ipe_node<Ipe_PdfElement>* current=page->getelement()->headler;
+	while(current->next!=NULL)
+	{
+		current=current->next;
+		Ipe_PdfStack* stack;
+		if(usetag)
+		{
+			if(current->t->getelementtype()!=1)
+				continue;
+			stack=static_cast<Ipe_PdfStack*>(current->t);
+		}
+		else
+		{
+			stack=dynamic_cast<Ipe_PdfStack*>(current->t);
+			if(stack==NULL)
+				continue;
+		}
+		Ipe_node<Ipe_PdfPath>* pathlist=stack->getpathlist()->headler;
+		while(pathlist->next!=NULL)
+		{
+			pathlist=pathlist->next;
+			Ipe_node<Ipe_Plane>* cplane=pathlist->t->getPlane()->headler;
+			while(cplane->next!=NULL)
+			{
+				cplane=cplane->next;
+				Ipe_node<Ipe_GraphicCell>* cgc=cplane->t->getlist()->headler;
+				while(cgc->next!=NULL)
+				{
+					cgc=cgc->next;
+					if(usetag)
+					{
+						if(cgc->t->gettype()==1)
+							count+=static_cast<Ipe_Lines*>(cgc->t)->getnum();
+						else if(cgc->t->gettype()==2)
+							count+=static_cast<Ipe_Bazeir*>(cgc->t)->getnum();
+					}
+					else
+					{
+						Ipe_Lines* lines=dynamic_cast<Ipe_Lines*>(cgc->t);
+						if(lines!=NULL)
+						{
+							count+=lines->getnum();
+						}
+						else
+						{
+							Ipe_Bazeir* bazeir=dynamic_cast<Ipe_Bazeir*>(cgc->t);
+							if(bazeir!=NULL)
+								count+=bazeir->getnum();
+						}
+					}
+				}
+			}
+		}
+	}
+	return count;
+}
+
+void traversaltest(Ipe_PdfPage* page,int rounds)//ʱ,Ƚdynamic_castͱֱʽ
+{
+	int i;
+	int count=0;
+	clock_t begin=clock();
+	for(i=0;i<rounds;i++)
+		count+=traversecells(page,false);
+	double dynamictime=(double)(clock()-begin)*1000/CLOCKS_PER_SEC;
+	begin=clock();
+	for(i=0;i<rounds;i++)
+		count-=traversecells(page,true);
+	double tagtime=(double)(clock()-begin)*1000/CLOCKS_PER_SEC;
+	printf("%d dynamic_cast:%.1fms ͱ:%.1fms%s\n",rounds,dynamictime,tagtime,count==0?"":" һ");
+}
+
+int main(int argc,char** argv)
 {
 	Ipe_Lines* lines=new Ipe_Lines();
-	lines->addpoint(1,2);
+	lines->addpoint(1,2,0);
+	if(argc>1)//ʱ:test ļ· []
+	{
+		Ipe_PdfDocument* document=new Ipe_PdfDocument(argv[1]);
+		Ipe_PdfPage* page=document->getPage(0);
+		if(page!=NULL)
+			traversaltest(page,argc>2?atoi(argv[2]):1000);
+		delete document;
+	}
 	system("pause");
-}
\ No newline at end of file
+}
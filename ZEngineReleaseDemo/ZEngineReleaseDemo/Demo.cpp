@@ -19,7 +19,9 @@ void main ()
 	//ʸݲԲ
 	Ipe_node<Ipe_PdfPage>* page=document->getlist()->headler;//һDocumentӦһPDFļ,ʱʹһpageṹȡDocumentҳͷ
 	page=page->next;//ʱָָPDFļĵһҳ
-	//page->t->clipwithrect(&rect);//ü
+	//Ipe_PageView* view=page->t->clipwithrect(&rect);//ü,ҳ治,زüͼ
+	//page->t->viewtoSVG(view,"C:\\Users\\Բ\\Desktop\\ü.svg");//üͼ
+	//view->release();//ͼͷ
 	page->t->searchedge();//ڴ߽
 	page->t->pagetoSVG("C:\\Users\\Բ\\Desktop\\1.svg");//˺PDFָҳתΪSVG洢,·Լ趨
 	//page->t->printpage();
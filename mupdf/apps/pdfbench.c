@@ -153,7 +153,28 @@ void benchrenderpage(fz_context *ctx, pdf_document *xref, pdf_page *page, int pa
 	fz_free_device(dev);
 }
 
-void benchfile(char *pdffilename, int loadonly, int pageNo)
+/* interpret the page without rasterizing; only the vector capture runs */
+void benchextractpage(fz_context *ctx, pdf_document *xref, pdf_page *page, int pagenum)
+{
+	fz_device *dev;
+	mstimer timer;
+
+	timerstart(&timer);
+
+	dev = fz_new_capture_device(ctx, 0);
+	fz_try(ctx) {
+		pdf_run_page(xref, page, dev, fz_identity, NULL);
+		timerstop(&timer);
+		logbench("pageextract %3d: %.2f ms\n", pagenum, timeinms(&timer));
+	}
+	fz_catch(ctx) {
+		logbench("Error: pdf_run_page() failed\n");
+	}
+
+	fz_free_device(dev);
+}
+
+void benchfile(char *pdffilename, int loadonly, int extract, int pageNo)
 {
 	pdf_document *xref = NULL;
 	mstimer timer;
@@ -189,7 +210,10 @@ void benchfile(char *pdffilename, int loadonly, int pageNo)
 			continue;
 		page = benchloadpage(ctx, xref, curpage);
 		if (page) {
-			benchrenderpage(ctx, xref, page, curpage);
+			if (extract)
+				benchextractpage(ctx, xref, page, curpage);
+			else
+				benchrenderpage(ctx, xref, page, curpage);
 			pdf_free_page(xref, page);
 		}
 	}
@@ -202,11 +226,11 @@ Exit:
 
 void usage(void)
 {
-	fprintf(stderr, "usage: pdfbench [-loadonly] [-page N] <pdffile>\n");
+	fprintf(stderr, "usage: pdfbench [-loadonly] [-extract] [-page N] <pdffile>\n");
 	exit(1);
 }
 
-void parsecmdargs(int argc, char **argv, int *loadonly, int *pageNo)
+void parsecmdargs(int argc, char **argv, int *loadonly, int *extract, int *pageNo)
 {
 	int i;
 
@@ -217,6 +241,9 @@ void parsecmdargs(int argc, char **argv, int *loadonly, int *pageNo)
 		if (!strcmp(argv[i], "-loadonly")) {
 			*loadonly = 1;
 		}
+		else if (!strcmp(argv[i], "-extract")) {
+			*extract = 1;
+		}
 		else if (!strcmp(argv[i], "-page") && i + 1 < argc) {
 			++i;
 			*pageNo = atoi(argv[i]);
@@ -229,9 +256,9 @@ void parsecmdargs(int argc, char **argv, int *loadonly, int *pageNo)
 
 int main(int argc, char **argv)
 {
-	int loadonly = 0, pageNo = -1;
-	parsecmdargs(argc, argv, &loadonly, &pageNo);
+	int loadonly = 0, extract = 0, pageNo = -1;
+	parsecmdargs(argc, argv, &loadonly, &extract, &pageNo);
 	/* for simplicity assume the file to parse is always the last */
-	benchfile(argv[argc-1], loadonly, pageNo);
+	benchfile(argv[argc-1], loadonly, extract, pageNo);
 	return 0;
 }
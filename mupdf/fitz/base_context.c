@@ -158,12 +158,75 @@ fz_clone_context_internal(fz_context *ctx)
 	return new_ctx;
 }
 
-void addroute(struct zblstack* stack);
-void addpoint(struct zblroute* route);
-void addclippoint(struct zblstack* stack);
+#define ZBLARENA_BLOCKSIZE (64*1024)//ڴÿĬϴС
+#define ZBLARENA_ALIGN(n) (((n)+7)&~(size_t)7)
 
-void addneststack(struct zblstack* pointer);
-void recursion(struct zblstack* s,struct zblstack* d)//ݹ麯,ڵݹĸ ps:ֻȡһ
+struct zblarena* initarena(fz_context* ctx)
+{
+	struct zblarena* arena=(struct zblarena*)malloc(sizeof(struct zblarena));
+	if(arena==NULL)
+		fz_throw(ctx,"malloc of %d bytes failed",(int)sizeof(struct zblarena));
+	arena->block=NULL;
+	arena->total=0;
+	arena->ctx=ctx;
+	return arena;
+}
+
+void* arenaalloc(struct zblarena* arena,size_t size)
+{
+	struct zblarenablock* block=arena->block;
+	char* p;
+	size=ZBLARENA_ALIGN(size);
+	if(block==NULL||block->used+size>block->size)//ǰ鲻,·һ,󵥶ɿ
+	{
+		size_t blocksize=size>ZBLARENA_BLOCKSIZE?size:ZBLARENA_BLOCKSIZE;
+		block=(struct zblarenablock*)malloc(ZBLARENA_ALIGN(sizeof(struct zblarenablock))+blocksize);
+		if(block==NULL)
+			fz_throw(arena->ctx,"malloc of %d bytes failed",(int)blocksize);
+		block->size=blocksize;
+		block->used=0;
+		block->next=arena->block;
+		arena->block=block;
+		arena->total+=blocksize;
+	}
+	p=(char*)block+ZBLARENA_ALIGN(sizeof(struct zblarenablock))+block->used;
+	block->used+=size;
+	return p;
+}
+
+void freearena(struct zblarena* arena)
+{
+	struct zblarenablock* block;
+	if(arena==NULL)
+		return;
+	while(arena->block!=NULL)
+	{
+		block=arena->block;
+		arena->block=block->next;
+		free(block);
+	}
+	free(arena);
+}
+
+void fz_free_line(struct zblrouteset* getline)//ҳͷ,ڵfree
+{
+	if(getline==NULL)
+		return;
+	freearena(getline->arena);
+	getline->arena=NULL;
+	getline->count=0;
+	getline->stackheadler=NULL;
+	getline->currentstack=NULL;
+	getline->xobjectheadler=NULL;
+	getline->patternheadler=NULL;
+}
+
+void addroute(struct zblarena* arena,struct zblstack* stack);
+void addpoint(struct zblarena* arena,struct zblroute* route);
+void addclippoint(struct zblarena* arena,struct zblstack* stack);
+
+void addneststack(struct zblarena* arena,struct zblstack* pointer);
+void recursion(struct zblarena* arena,struct zblstack* s,struct zblstack* d)//ݹ麯,ڵݹĸ ps:ֻȡһ,dĽڵarena
 {
 	//struct zblstack* spointer;//ܴһָ
 	//struct zblstack* dpointer;
@@ -173,12 +236,13 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 	d->countclip=s->countclip;
 	d->existclip=s->existclip;
 	d->existnest=s->existnest;
+	d->xobject=s->xobject;
 	d->shadowtype=s->shadowtype;
 	d->ca=s->ca;
 	if(d->shadowtype!=0)
 	{
-		d->bcolor=(float*)malloc(4*sizeof(float));
-		d->ecolor=(float*)malloc(4*sizeof(float));
+		d->bcolor=(float*)arenaalloc(arena,4*sizeof(float));
+		d->ecolor=(float*)arenaalloc(arena,4*sizeof(float));
 		for(i=0;i<3;i++)
 		{
 			d->bcolor[i]=s->bcolor[i];
@@ -189,13 +253,13 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 	if(s->existclip>0)//Ʋü·
 		{
 			s->currentclip=s->clipheadler;
-			d->clipheadler=(struct routepoint*)malloc(sizeof(struct routepoint));
+			d->clipheadler=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));
 			d->currentclip=d->clipheadler;
 			d->currentclip->nextpoint=NULL;
 			while(s->currentclip->nextpoint!=NULL)
 			{
 				s->currentclip=s->currentclip->nextpoint;
-				addclippoint(d);
+				addclippoint(arena,d);
 				d->currentclip->p0=s->currentclip->p0;
 				d->currentclip->p1=s->currentclip->p1;
 				d->currentclip->p2=s->currentclip->p2;
@@ -209,7 +273,6 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 		d->existcm=s->existcm;//תþ
 		if(d->existcm==1)
 		{
-			d->matrix=(float*)malloc(6*sizeof(float));
 			d->matrix[0]=s->matrix[0];
 			d->matrix[1]=s->matrix[1];
 			d->matrix[2]=s->matrix[2];
@@ -245,7 +308,7 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 			if(d->currentroute->scolorspace!=0)//ߵĲ,ɫ
 			{
 				d->currentroute->scolorspace=s->currentroute->scolorspace;
-				d->currentroute->scolor=(float*)malloc(4*sizeof(float));
+				d->currentroute->scolor=(float*)arenaalloc(arena,4*sizeof(float));
 				if((d->currentroute->scolorspace==3)||(d->currentroute->scolorspace==4)||(d->currentroute->scolorspace==5)||(d->currentroute->scolorspace==6))
 				{
 					d->currentroute->scolor[0]=s->currentroute->scolor[0];
@@ -260,6 +323,19 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 				}
 			}
 			d->currentroute->drawingmethord=s->currentroute->drawingmethord;
+			d->currentroute->linecap=s->currentroute->linecap;
+			d->currentroute->linejoin=s->currentroute->linejoin;
+			d->currentroute->miterlimit=s->currentroute->miterlimit;
+			d->currentroute->dashphase=s->currentroute->dashphase;
+			d->currentroute->dashlen=s->currentroute->dashlen;
+			d->currentroute->pattern=s->currentroute->pattern;
+			d->currentroute->spattern=s->currentroute->spattern;
+			if(s->currentroute->dashlen>0)
+			{
+				d->currentroute->dash=(float*)arenaalloc(arena,s->currentroute->dashlen*sizeof(float));
+				for(i=0;i<s->currentroute->dashlen;i++)
+					d->currentroute->dash[i]=s->currentroute->dash[i];
+			}
 			d->currentroute->countpoint=s->currentroute->countpoint;
 			s->currentroute->currentpoint=s->currentroute->pointheadler;
 			while(s->currentroute->currentpoint->nextpoint!=NULL)//·
@@ -276,12 +352,12 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 				//printf("ƽ׶·:%f %f %f %f %f %f %f \n",d->currentroute->currentpoint->p0,d->currentroute->currentpoint->p1,d->currentroute->currentpoint->p2,d->currentroute->currentpoint->p3,d->currentroute->currentpoint->p4,d->currentroute->currentpoint->p5,d->currentroute->currentpoint->state);
 				if(d->currentroute->currentpoint->state!=-1)
 				{
-					addpoint(d->currentroute);
+					addpoint(arena,d->currentroute);
 				}
 			}
 			if(d->currentroute->colorspace!=-1||d->currentroute->linewidth!=-1)
 			{
-				addroute(d);
+				addroute(arena,d);
 			}
 		}
 		if(s->existnest==0)//Ƕջ,
@@ -295,8 +371,8 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 			{
 				//spointer=spointer->nextstack;
 				s->currentstack=s->currentstack->nextstack;
-				addneststack(d);
-				recursion(s->currentstack,d->currentstack);
+				addneststack(arena,d);
+				recursion(arena,s->currentstack,d->currentstack);
 			}
 		}
 		return;
@@ -304,27 +380,139 @@ void recursion(struct zblstack* s,struct zblstack* d)//
 
 
 
-void initrouteset(struct zblrouteset* getline);
+void initrouteset(fz_context* ctx,struct zblrouteset* getline);
 void addstack(struct zblrouteset* getline);
+void initstack(struct zblarena* arena,struct zblstack* stack);
 //void addroute(struct zblstack* stack);
 //void addpoint(struct zblroute* route);
 //void addclippoint(struct zblstack* stack);
 
-extern struct zblrouteset * getline;
-void fz_return_line(struct zblrouteset *p)//ҵĹ̵Ľӿ,ȡPDFͼ
+void fz_return_line(fz_device *dev, struct zblrouteset *p)//ҵĹ̵Ľӿ,ȡPDFͼ
+{
+	struct zblrouteset *getline;
+	if(dev->capture==NULL||dev->capture->getline==NULL||dev->capture->getline->arena==NULL)//豸δ͹ҳѱȡ
+	{
+		initrouteset(dev->ctx,p);
+		return;
+	}
+	//ٸ,ͬڴֱӽp,豸һÿ,ɵfz_free_lineͷ
+	getline=dev->capture->getline;
+	*p=*getline;
+	getline->count=0;
+	getline->stackheadler=NULL;
+	getline->currentstack=NULL;
+	getline->xobjectheadler=NULL;
+	getline->patternheadler=NULL;
+	getline->arena=NULL;
+}
+
+void fz_init_images(struct zimages *p)
 {
-	struct zblstack* spointer=NULL;//ָ
-	struct zblstack* dpointer=NULL;
-	initrouteset(p);
+	p->head=(struct zimagenode*)malloc(sizeof(struct zimagenode));
+	p->head->w=p->head->h=p->head->n=0;
+	p->head->data=NULL;
+	p->head->next=NULL;
+	p->currentimage=p->head;
+	p->count=0;
+}
+
+void fz_return_images(fz_device *dev, struct zimages *p)//ڵֱƽ,
+{
+	struct zimages *images;
+	if(p->head==NULL)
+		fz_init_images(p);
+	if(dev->capture==NULL||dev->capture->images.head==NULL||dev->capture->images.count==0)
+		return;
+	images=&dev->capture->images;
+	p->currentimage->next=images->head->next;
+	p->currentimage=images->currentimage;
+	p->count+=images->count;
+	images->head->next=NULL;
+	images->currentimage=images->head;
+	images->count=0;
+}
+
+void fz_free_images(struct zimages *p)
+{
+	struct zimagenode *node,*next;
+	if(p==NULL||p->head==NULL)
+		return;
+	for(node=p->head;node!=NULL;node=next)
+	{
+		next=node->next;
+		free(node->data);
+		free(node);
+	}
+	p->head=NULL;
+	p->currentimage=NULL;
+	p->count=0;
+}
+
+static void copystacks(struct zblarena* arena,struct zblstack* from,struct zblrouteset* to)//һջ,׷ӵtoĩβ
+{
+	struct zblstack* s=from;
+	while(s->nextstack!=NULL)//һջ,ÿδһ
+	{
+		s=s->nextstack;
+		addstack(to);
+		recursion(arena,s,to->currentstack);
+	}
+}
+
+void fz_copy_line(fz_device *dev, struct zblrouteset *p)//ȡ,豸Լһ
+{
+	struct zblrouteset *getline;
+	struct zblxobject *sx,*dx;
+	struct zblxobject **tail;
+	struct zblpattern *sp,*dp;
+	struct zblpattern **ptail;
+	initrouteset(dev->ctx,p);//pнڵp->arena,ɵfz_free_lineһͷ
+	if(dev->capture==NULL||dev->capture->getline==NULL||dev->capture->getline->arena==NULL)
+		return;
+	getline=dev->capture->getline;
 	p->count=getline->count;
-	getline->currentstack=getline->stackheadler;
-	while(getline->currentstack->nextstack!=NULL)//һջ,ÿδһ
+	copystacks(p->arena,getline->stackheadler,p);
+	tail=&p->xobjectheadler;
+	for(sx=getline->xobjectheadler;sx!=NULL;sx=sx->nextxobject)//ƱXObject,˳򲻱
 	{
-		getline->currentstack=getline->currentstack->nextstack;
-		addstack(p);
-		recursion(getline->currentstack,p->currentstack);
+		struct zblrouteset form;
+		dx=(struct zblxobject*)arenaalloc(p->arena,sizeof(struct zblxobject));
+		dx->num=sx->num;
+		dx->count=sx->count;
+		dx->stackheadler=(struct zblstack*)arenaalloc(p->arena,sizeof(struct zblstack));
+		initstack(p->arena,dx->stackheadler);
+		form.count=0;
+		form.arena=p->arena;
+		form.stackheadler=dx->stackheadler;
+		form.currentstack=dx->stackheadler;
+		form.xobjectheadler=NULL;
+		form.patternheadler=NULL;
+		copystacks(p->arena,sx->stackheadler,&form);
+		dx->currentstack=form.currentstack;
+		dx->nextxobject=NULL;
+		*tail=dx;
+		tail=&dx->nextxobject;
+	}
+	ptail=&p->patternheadler;
+	for(sp=getline->patternheadler;sp!=NULL;sp=sp->nextpattern)//ƽͼ,˳򲻱
+	{
+		struct zblrouteset tile;
+		dp=(struct zblpattern*)arenaalloc(p->arena,sizeof(struct zblpattern));
+		*dp=*sp;//,,뷶ΧֱӸ
+		dp->stackheadler=(struct zblstack*)arenaalloc(p->arena,sizeof(struct zblstack));
+		initstack(p->arena,dp->stackheadler);
+		tile.count=0;
+		tile.arena=p->arena;
+		tile.stackheadler=dp->stackheadler;
+		tile.currentstack=dp->stackheadler;
+		tile.xobjectheadler=NULL;
+		tile.patternheadler=NULL;
+		copystacks(p->arena,sp->stackheadler,&tile);
+		dp->currentstack=tile.currentstack;
+		dp->nextpattern=NULL;
+		*ptail=dp;
+		ptail=&dp->nextpattern;
 	}
-	//printf("%d ",p->count);
 }
 
 /*
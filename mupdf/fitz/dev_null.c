@@ -8,6 +8,15 @@ fz_new_device(fz_context *ctx, void *user)
 	dev->flags = 0;
 	dev->user = user;
 	dev->ctx = ctx;
+	dev->capture = NULL;
+	return dev;
+}
+
+fz_device *
+fz_new_capture_device(fz_context *ctx, int hints)
+{
+	fz_device *dev = fz_new_device(ctx, NULL);
+	dev->hints = hints | FZ_CAPTURE_ONLY;
 	return dev;
 }
 
@@ -18,6 +27,25 @@ fz_free_device(fz_device *dev)
 		return;
 	if (dev->free_user)
 		dev->free_user(dev);
+	if (dev->capture)
+	{
+		/* whatever fz_return_line has not taken over (or what
+		 * fz_copy_line left behind) goes with the device */
+		struct zstacknode *node = dev->capture->cstack.head;
+		while (node)
+		{
+			struct zstacknode *next = node->next;
+			free(node);
+			node = next;
+		}
+		if (dev->capture->getline)
+		{
+			fz_free_line(dev->capture->getline);
+			free(dev->capture->getline);
+		}
+		fz_free_images(&dev->capture->images);
+		fz_free(dev->ctx, dev->capture);
+	}
 	fz_free(dev->ctx, dev);
 }
 
@@ -922,6 +922,10 @@ struct fz_shade_s
 	int type; /* linear, radial, mesh */
 	int extend[2];
 
+	int shadowtype;//PDFеӰ1-7,ȡɫ
+	float bcolor[4];//ʼɫ,ȡԲ
+	float ecolor[4];//ɫ,ȡԲĩ
+
 	int mesh_len;
 	int mesh_cap;
 	float *mesh; /* [x y 0], [x y r], [x y t] or [x y c1 ... cn] */
@@ -966,6 +970,8 @@ enum
 	/* Hints */
 	FZ_IGNORE_IMAGE = 1,
 	FZ_IGNORE_SHADE = 2,
+	FZ_NO_CAPTURE = 4,//豸Լͼ,ʸȡṹ
+	FZ_CAPTURE_ONLY = 8,//豸,ֻʸȡ,ȡıXObjectٽ
 
 	/* Flags */
 	FZ_DEVFLAG_MASK = 1,
@@ -993,6 +999,8 @@ struct fz_device_s
 	void (*free_user)(fz_device *);
 	fz_context *ctx;
 
+	struct zblcapture *capture;//ʸȡ״̬,״νҳʱ
+
 	void (*fill_path)(fz_device *, fz_path *, int even_odd, fz_matrix, fz_colorspace *, float *color, float alpha);
 	void (*stroke_path)(fz_device *, fz_path *, fz_stroke_state *, fz_matrix, fz_colorspace *, float *color, float alpha);
 	void (*clip_path)(fz_device *, fz_path *, fz_rect *rect, int even_odd, fz_matrix);
@@ -1110,6 +1118,11 @@ struct fz_document_s
 	void (*run_page)(fz_document *doc, fz_page *page, fz_device *dev, fz_matrix transform, fz_cookie *cookie);
 	void (*free_page)(fz_document *doc, fz_page *page);
 };
-void fz_return_line(struct zblrouteset *getline);//ȡֱ߽ṹ庯
+void fz_return_line(fz_device *dev, struct zblrouteset *getline);//ȡȡ,Ȩͬڴƽgetline
+void fz_copy_line(fz_device *dev, struct zblrouteset *getline);//ȡ,豸еĽ
+void fz_free_line(struct zblrouteset *getline);//ͷȡȫڵ,getlineٴʹ
+void fz_init_images(struct zimages *getimages);//յͼƬ
+void fz_return_images(fz_device *dev, struct zimages *getimages);//ȡ豸ȡͼƬ,˳׷ӵgetimagesĩβ
+void fz_free_images(struct zimages *getimages);//ͷͼƬȫڵ,getimagesͷ
 
 #endif
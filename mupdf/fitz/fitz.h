@@ -149,6 +149,15 @@ struct zblroute//ͼ
 	float *scolor;//,ɫɫ
 
 	int drawingmethord;//Ʒ 1-S 2-f* 3-f/F 4-s 5-B 6-B* 7-b 8-b*
+
+	int linecap;//ʱ߶ʽ 0-ƽͷ 1-Բͷ 2-ͷ
+	int linejoin;//սʽ 0- 1-Բ 2-б
+	float miterlimit;
+	int dashlen;//鳤,0Ϊʵ
+	float dashphase;
+	float *dash;//,ڴط
+	int pattern;//ƽͼzblpatternеı,0Ϊͼ
+	int spattern;//ƽͼı
 	
 	int countpoint;//¼·
 	struct routepoint* pointheadler;//p0 p1ֱֱ·x,y,p0-p6,state·m,l,h,c״̬(ֱӦ0123
@@ -174,7 +183,8 @@ struct zblstack//һ
 	float ca;//͸,ĬΪ1
 
 	int existcm;//Ƿתþ,ĬΪ0- 1-
-	float* matrix;//תþ,ĬΪNULL
+	float matrix[6];//תþa b c d e f,ջһ,ĬΪλ
+	int xobject;//XObjectʵջ¼,ֻzblxobjectȡһ,0Ϊͨջ
 
 	struct zblroute* routeheadler;//·ͷ
 	struct zblroute* currentroute;//ǰ·
@@ -197,11 +207,52 @@ struct spointstack
 };
 
 
+struct zblarenablock//ڴеһ,ͷ֮ΪɷĿռ
+{
+	struct zblarenablock* next;
+	size_t size;//ֽ
+	size_t used;//ѷֽ
+};
+
+struct zblarena//ȡڵڴ,˳,ҳһͷ
+{
+	struct zblarenablock* block;//ǰ,ǰĿ
+	size_t total;//пֽ
+	fz_context* ctx;//ʧʱڴcontext׳쳣
+};
+
+struct zblxobject//һXObjectȡ,ͬһһҳֻһ
+{
+	int num;//
+	int count;
+	struct zblstack* stackheadler;//ݵջ,ṹҳͬ,ڱԼϵ
+	struct zblstack* currentstack;
+	struct zblxobject* nextxobject;
+};
+
+struct zblpattern//һƽͼȡ,ֻȡһͼԪ,չ
+{
+	int id;//ҳڵı,1ʼ,·pattern/spatternô˱
+	int num;//ͼĶ
+	int nested;//Ƿڱͼʹ,ʱͼռΪֲϵ,ҳʹõķֿȡ
+	float xstep;//ƽ̲
+	float ystep;
+	float matrix[6];//ͼռ䵽ʼϵľ
+	float bbox[4];//ͼԪΧx0 y0 x1 y1
+	int count;
+	struct zblstack* stackheadler;//ͼԪݵջ,ͼռ
+	struct zblstack* currentstack;
+	struct zblpattern* nextpattern;
+};
+
 struct zblrouteset//ȡ·Ͻṹ һҳеͼϢ
 {
 	int count;
 	struct zblstack* stackheadler;
 	struct zblstack* currentstack;
+	struct zblxobject* xobjectheadler;//ҳõıXObject,NULLβ
+	struct zblpattern* patternheadler;//ҳõƽͼ,NULLβ
+	struct zblarena* arena;//üнڵ(ջ,·,,,ɫ)Ӵ˷
 };
 
 struct routepoint
@@ -216,6 +267,41 @@ struct routepoint
 	float state;//state·m,l,h,c״̬(ֱӦ0123//˴v y
 };
 
+struct zimagenode//һͼƬ
+{
+	int w,h,n;//,(alpha)
+	unsigned char *data;//rgbֵ,϶
+	struct zimagenode* next;
+};
+
+struct zimages//ȡͼƬ,headΪͷڵ,currentimageΪβڵ
+{
+	struct zimagenode* head;
+	struct zimagenode* currentimage;
+	int count;//ͼƬ
+};
+
+struct zblcapture//ȡ̵״̬,豸,ͨcsi,ʹȫֱ
+{
+	struct spointstack cstack;//ջָһջṹ ʼ ʹ pop push delete
+	struct zblrouteset *getline;//ǰȡ
+	struct zblstack* currentstackpoint;//ǰջָ
+	float currentlinewidth;//ǰɫռ,ɫ,߿˳
+	float Vpointx,Vpointy;
+	int colorchanged;//ĬΪ 1-ɫ 2-
+	int currentfillcolorspace;
+	int currentstrokecolorspace;
+	float currentfillcolor[4];//ǰɫ ·
+	float currentstrokecolor[4];//ǰɫ fill
+	int stackstate;//жǷͼջ
+	int nested;//ȡıͼݲ,0Ϊҳ
+	struct zimages images;//ҳеͼƬ,ʸһ豸,̼߳以Ӱ
+};
+
+struct zblarena* initarena(fz_context* ctx);//½ڴ,ʧʱ׳쳣
+void* arenaalloc(struct zblarena* arena,size_t size);//ڴط,8ֽڶ;ڴ治ʱfz_mallocһ׳쳣,NULL
+void freearena(struct zblarena* arena);//ͷڴؼнڵ
+
 
 /*
 extern
@@ -1703,6 +1789,20 @@ fz_device *fz_new_trace_device(fz_context *ctx);
 */
 fz_device *fz_new_bbox_device(fz_context *ctx, fz_bbox *bboxp);
 
+/*
+	fz_new_capture_device: Create a device that discards all
+	marks. Running a page through it only drives the interpreter,
+	so the vector capture (fz_return_line) is filled without the
+	cost of rasterizing into a pixmap.
+
+	Images and shadings are still loaded since the capture needs
+	them; pass FZ_IGNORE_IMAGE/FZ_IGNORE_SHADE in hints to skip.
+
+	Since nothing is drawn, a Form XObject that was already captured
+	on the page is not interpreted again when it is reused.
+*/
+fz_device *fz_new_capture_device(fz_context *ctx, int hints);
+
 /*
 	fz_new_draw_device: Create a device to draw on a pixmap.
 
@@ -252,6 +252,7 @@ typedef struct pdf_pattern_s pdf_pattern;
 struct pdf_pattern_s
 {
 	fz_storable storable;
+	int num;
 	int ismask;
 	float xstep;
 	float ystep;
@@ -8,9 +8,6 @@ enum
 };
 
 typedef struct psobj_s psobj;
-extern int zcounter;
-extern struct zblrouteset *getline;
-extern struct zblstack* currentstackpoint;
 enum
 {
 	SAMPLE = 0,
@@ -1178,15 +1175,7 @@ eval_exponential_func(fz_context *ctx, pdf_function *func, float in, float *out)
 {
 	float x = in;
 	float tmp;
-	int i,j;
-	if(zcounter==0)
-	{
-		for(j=0;j<3;j++)
-		{
-			currentstackpoint->bcolor[j]=func->u.e.c0[j];
-			currentstackpoint->ecolor[j]=func->u.e.c1[j];
-		}
-	}
+	int i;
 	x = CLAMP(x, func->domain[0][0], func->domain[0][1]);
 
 	/* constraint Լ*/
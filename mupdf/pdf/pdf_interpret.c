@@ -8,52 +8,53 @@ typedef struct pdf_material_s pdf_material;
 typedef struct pdf_gstate_s pdf_gstate;
 typedef struct pdf_csi_s pdf_csi;
 
-struct spointstack cstack;//ջָһջṹ ʼ ʹ pop push delete
-struct zblrouteset *getline;
-struct zblstack* currentstackpoint;
-float currentlinewidth=1;//ǰɫռ,ɫ,߿˳
-float Vpointx,Vpointy;
-int colorchanged=0;//ĬΪ 1-ɫ 2-
-int currentfillcolorspace;
-int currentstrokecolorspace;
-float currentfillcolor[4];//ǰɫ ·
-float currentstrokecolor[4];//ǰɫ fill
-int stackstate;//жǷͼջ
-
-void initcstack()//ʼջ
+void initcstack(struct spointstack* cstack)//ʼջ
 {
 	struct zstacknode* node=(struct zstacknode*)malloc(sizeof(struct zstacknode));
 	node->pointer=NULL;
 	node->next=NULL;
-	cstack.head=node;
-	cstack.tail=cstack.head;
+	cstack->head=node;
+	cstack->tail=cstack->head;
 }
 
-void push(struct zblstack* pointer)//ջ
+void push(struct spointstack* cstack,struct zblstack* pointer)//ջ
 {
 	struct zstacknode* node=(struct zstacknode*)malloc(sizeof(struct zstacknode));
 	node->pointer=pointer;
-	node->next=cstack.head;
-	cstack.head=node;
+	node->next=cstack->head;
+	cstack->head=node;
 }
 
-void pop()//ջ
+void pop(struct spointstack* cstack)//ջ
 {
-	if(cstack.head==cstack.tail)
+	if(cstack->head==cstack->tail)
 	{
 		printf("ջΪ\n");
 	}
 	else
 	{
-		struct zstacknode* node=cstack.head;
-		cstack.head=node->next;
+		struct zstacknode* node=cstack->head;
+		cstack->head=node->next;
 		free(node);
 	}
 }
 
-struct zblstack* currentstack()//ȡջڵŵָ
+void freecstack(struct spointstack* cstack)//ͷջṹȫڵ
 {
-	return cstack.head->pointer;
+	struct zstacknode* node=cstack->head;
+	while(node!=NULL)
+	{
+		struct zstacknode* next=node->next;
+		free(node);
+		node=next;
+	}
+	cstack->head=NULL;
+	cstack->tail=NULL;
+}
+
+struct zblstack* currentstack(struct spointstack* cstack)//ȡջڵŵָ
+{
+	return cstack->head->pointer;
 }
 
 void initpoint(struct routepoint* head)
@@ -68,7 +69,17 @@ void initpoint(struct routepoint* head)
 	head->nextpoint=NULL;
 }
 
-void initroute(struct zblroute* route)
+static void initstroke(struct zblroute* route)//״̬ȡPDFĬֵ
+{
+	route->linecap=0;
+	route->linejoin=0;
+	route->miterlimit=10;
+	route->dashlen=0;
+	route->dashphase=0;
+	route->dash=NULL;
+}
+
+void initroute(struct zblarena* arena,struct zblroute* route)
 {
 	//ʼ
 	route->type=100;
@@ -82,14 +93,27 @@ void initroute(struct zblroute* route)
 	route->scolor=NULL;
 	route->countpoint=0;
 	route->drawingmethord=0;
+	route->pattern=0;
+	route->spattern=0;
+	initstroke(route);
 	//ͷָռ
-	route->pointheadler=(struct routepoint*)malloc(sizeof(struct routepoint));
+	route->pointheadler=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));
 	route->currentpoint=route->pointheadler;
 	initpoint(route->pointheadler);
 	route->nextroute=NULL;
 }
 
-void initstack(struct zblstack* stack)
+static void setidentity(float* matrix)//ջתþΪλ
+{
+	matrix[0]=1;
+	matrix[1]=0;
+	matrix[2]=0;
+	matrix[3]=1;
+	matrix[4]=0;
+	matrix[5]=0;
+}
+
+void initstack(struct zblarena* arena,struct zblstack* stack)
 {
 	stack->existstack=0;//Ĭ0ʾͼζջ
 	stack->countroute=0;//¼һͼ״̬ջжٸ·
@@ -102,31 +126,35 @@ void initstack(struct zblstack* stack)
 	stack->currentclip=NULL;
 	//Ĭϲתþ
 	stack->existcm=0;
-	stack->matrix=NULL;
+	setidentity(stack->matrix);
+	stack->xobject=0;
 	//ɫ
 	stack->shadowtype=0;//Ĭϲڽɫ
 	stack->bcolor=NULL;
 	stack->ecolor=NULL;
 	stack->ca=1;
 
-	stack->stackheadler=(struct zblstack*)malloc(sizeof (struct zblstack));
+	stack->stackheadler=(struct zblstack*)arenaalloc(arena,sizeof (struct zblstack));
 	stack->currentstack=stack->stackheadler;
-	stack->routeheadler=(struct zblroute*)malloc(sizeof(struct zblroute));
+	stack->routeheadler=(struct zblroute*)arenaalloc(arena,sizeof(struct zblroute));
 	stack->currentroute=stack->routeheadler;
-	initroute(stack->routeheadler);
+	initroute(arena,stack->routeheadler);
 	stack->nextstack=NULL;
 }
 
-void initrouteset(struct zblrouteset* getline)
+void initrouteset(fz_context* ctx,struct zblrouteset* getline)
 {
 	getline->count=0;
-	getline->stackheadler=(struct zblstack*)malloc(sizeof(struct zblstack));
+	getline->arena=initarena(ctx);//ÿһڴ,fz_free_lineͷ
+	getline->stackheadler=(struct zblstack*)arenaalloc(getline->arena,sizeof(struct zblstack));
 	getline->currentstack=getline->stackheadler;
-	initstack(getline->stackheadler);
+	getline->xobjectheadler=NULL;
+	getline->patternheadler=NULL;
+	initstack(getline->arena,getline->stackheadler);
 }
-void addpoint(struct zblroute* route)
+void addpoint(struct zblarena* arena,struct zblroute* route)
 {
-	struct routepoint* point=(struct routepoint*)malloc(sizeof(struct routepoint));
+	struct routepoint* point=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));
 	point->p0=-1;
 	point->p1=-1;
 	point->p2=-1;
@@ -139,9 +167,9 @@ void addpoint(struct zblroute* route)
 	route->currentpoint=route->currentpoint->nextpoint;
 }
 
-void addroute(struct zblstack* stack)
+void addroute(struct zblarena* arena,struct zblstack* stack)
 {
-	struct zblroute* route=(struct zblroute*)malloc(sizeof(struct zblroute));
+	struct zblroute* route=(struct zblroute*)arenaalloc(arena,sizeof(struct zblroute));
 	//ʼ
 	route->type=0;
 	route->linewidth=-1;
@@ -154,18 +182,21 @@ void addroute(struct zblstack* stack)
 	route->scolor=NULL;
 	route->countpoint=0;
 	route->drawingmethord=0;
+	route->pattern=0;
+	route->spattern=0;
+	initstroke(route);
 	//ͷָռ
-	route->pointheadler=(struct routepoint*)malloc(sizeof(struct routepoint));
+	route->pointheadler=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));
 	route->currentpoint=route->pointheadler;
 	route->nextroute=NULL;
-	addpoint(route);
+	addpoint(arena,route);
 	stack->currentroute->nextroute=route;
 	stack->currentroute=stack->currentroute->nextroute;
 }
 
-void addneststack(struct zblstack* pointer)//ΪջǶջ
+void addneststack(struct zblarena* arena,struct zblstack* pointer)//ΪջǶջ
 {
-	struct zblstack* stack=(struct zblstack*)malloc(sizeof(struct zblstack));
+	struct zblstack* stack=(struct zblstack*)arenaalloc(arena,sizeof(struct zblstack));
 	stack->existstack=0;//Ĭ0ʾͼζջ
 	stack->countroute=0;
 	//Ĭϲڼ·
@@ -177,7 +208,8 @@ void addneststack(struct zblstack* pointer)//ΪջǶ
 	stack->currentclip=NULL;
 	//Ĭϲתþ
 	stack->existcm=0;
-	stack->matrix=NULL;
+	setidentity(stack->matrix);
+	stack->xobject=0;
 
 	//ɫ
 	stack->shadowtype=0;//Ĭϲڽɫ
@@ -185,13 +217,13 @@ void addneststack(struct zblstack* pointer)//ΪջǶ
 	stack->ecolor=NULL;
 	stack->ca=1;
 
-	stack->routeheadler=(struct zblroute*)malloc(sizeof(struct zblroute));
+	stack->routeheadler=(struct zblroute*)arenaalloc(arena,sizeof(struct zblroute));
 	stack->currentroute=stack->routeheadler;
 	stack->nextstack=NULL;
 
-	initstack(stack);
+	initstack(arena,stack);
 
-	addroute(stack);//ջ
+	addroute(arena,stack);//ջ
 	//pointer->stackheadler=(struct zblstack*)malloc(sizeof(struct zblstack));
 	pointer->currentstack->nextstack=stack;
 	pointer->currentstack=pointer->currentstack->nextstack;
@@ -200,7 +232,8 @@ void addneststack(struct zblstack* pointer)//ΪջǶ
 
 void addstack(struct zblrouteset* getline)
 {
-	struct zblstack* stack=(struct zblstack*)malloc(sizeof(struct zblstack));
+	struct zblarena* arena=getline->arena;
+	struct zblstack* stack=(struct zblstack*)arenaalloc(arena,sizeof(struct zblstack));
 	stack->existstack=0;//Ĭ0ʾͼζջ
 	stack->countroute=0;
 	//Ĭϲڼ·
@@ -217,21 +250,22 @@ void addstack(struct zblrouteset* getline)
 	stack->currentclip=NULL;
 	//Ĭϲתþ
 	stack->existcm=0;
-	stack->matrix=NULL;
+	setidentity(stack->matrix);
+	stack->xobject=0;
 
-	stack->stackheadler=(struct zblstack*)malloc(sizeof (struct zblstack));
+	stack->stackheadler=(struct zblstack*)arenaalloc(arena,sizeof (struct zblstack));
 	stack->currentstack=stack->stackheadler;
-	stack->routeheadler=(struct zblroute*)malloc(sizeof(struct zblroute));
+	stack->routeheadler=(struct zblroute*)arenaalloc(arena,sizeof(struct zblroute));
 	stack->currentroute=stack->routeheadler;
 	stack->nextstack=NULL;
-	addroute(stack);//ջ
+	addroute(arena,stack);//ջ
 	getline->currentstack->nextstack=stack;
 	getline->currentstack=getline->currentstack->nextstack;
 }
 
-void addclippoint(struct zblstack* stack)
+void addclippoint(struct zblarena* arena,struct zblstack* stack)
 {
-	struct routepoint* point=(struct routepoint*)malloc(sizeof(struct routepoint));
+	struct routepoint* point=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));
 	point->p0=-1;
 	point->p1=-1;
 	point->p2=-1;
@@ -255,7 +289,7 @@ void copyclippoint(struct zblstack* stack)
 	stack->currentclip->state=stack->currentroute->currentpoint->state;
 }
 
-void copycliproute(struct zblstack* stack)
+void copycliproute(struct zblarena* arena,struct zblstack* stack)
 {
 	struct zblroute* route=NULL;
 	route=stack->currentroute;//ǰջָ
@@ -263,13 +297,13 @@ void copycliproute(struct zblstack* stack)
 	stack->countclip=stack->currentroute->countpoint;
 	
 	stack->currentroute->currentpoint=stack->currentroute->pointheadler;
-	stack->clipheadler=(struct routepoint*)malloc(sizeof(struct routepoint));//䵱ǰ·ָ
+	stack->clipheadler=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));//䵱ǰ·ָ
 	stack->currentclip=stack->clipheadler;
 	initpoint(stack->clipheadler);
 	while(stack->currentroute->currentpoint->nextpoint!=NULL)
 	{
 		stack->currentroute->currentpoint=stack->currentroute->currentpoint->nextpoint;
-		addclippoint(stack);//ӵ㲢ʼ
+		addclippoint(arena,stack);//ӵ㲢ʼ
 		copyclippoint(stack);//и
 	}
 	/*
@@ -277,15 +311,13 @@ void copycliproute(struct zblstack* stack)
 	free(stack->currentroute);
 	stack->routeheadler=(struct zblroute*)malloc(sizeof(struct zblroute));//ʼroute
 	stack->currentroute=stack->routeheadler;
-	initroute(stack->routeheadler);
+	initroute(arena,stack->routeheadler);
 	*/
-	free(stack->currentroute->pointheadler);
-	free(stack->currentroute->currentpoint);
-	stack->currentroute->countpoint=0;
-	stack->currentroute->pointheadler=(struct routepoint*)malloc(sizeof(struct routepoint));
+	stack->currentroute->countpoint=0;//ɵĵڴ,ҳͷ
+	stack->currentroute->pointheadler=(struct routepoint*)arenaalloc(arena,sizeof(struct routepoint));
 	stack->currentroute->currentpoint=stack->currentroute->pointheadler;
 	initpoint(stack->currentroute->pointheadler);
-	addpoint(stack->currentroute);
+	addpoint(arena,stack->currentroute);
 }
 
 enum
@@ -383,11 +415,15 @@ struct pdf_csi_s
 
 	/* cookie support */
 	fz_cookie *cookie;
+
+	/* vector capture ʸȡ״̬,豸,ͬһ豸ϵcsi */
+	struct zblcapture *cap;
 };
 
 static void pdf_run_buffer(pdf_csi *csi, pdf_obj *rdb, fz_buffer *contents);
 static void pdf_run_xobject(pdf_csi *csi, pdf_obj *resources, pdf_xobject *xobj, fz_matrix transform);
 static void pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what);
+static int pdf_capture_pattern(pdf_csi *csi, pdf_pattern *pat, int what);
 
 static int
 ocg_intents_include(pdf_ocg_descriptor *desc, char *name)
@@ -623,6 +659,50 @@ pdf_end_group(pdf_csi *csi)
 		fz_pop_clip(csi->dev);
 }
 
+static void
+pdf_capture_shade(pdf_csi *csi, fz_shade *shd)//Ӱ뽥ɫ¼ǰջ
+{
+	struct zblstack *stack;
+	int i;
+
+	if (csi->cap == NULL)
+		return;
+	stack = csi->cap->currentstackpoint;
+	stack->shadowtype=shd->shadowtype;
+	if(stack->bcolor==NULL)
+		stack->bcolor=(float*)arenaalloc(csi->cap->getline->arena,4*sizeof(float));
+	if(stack->ecolor==NULL)
+		stack->ecolor=(float*)arenaalloc(csi->cap->getline->arena,4*sizeof(float));//Ϊɫռ
+	for(i=0;i<4;i++)
+	{
+		stack->bcolor[i]=shd->bcolor[i];
+		stack->ecolor[i]=shd->ecolor[i];
+	}
+}
+
+static void
+pdf_capture_stroke(pdf_csi *csi, fz_stroke_state *stroke)//߶,սʽ¼ǰ·
+{
+	struct zblroute *route;
+	int i;
+
+	if (csi->cap == NULL)
+		return;
+	route = csi->cap->currentstackpoint->currentroute;
+	route->linecap=stroke->start_cap;
+	route->linejoin=stroke->linejoin;
+	route->miterlimit=stroke->miterlimit;
+	route->dashphase=stroke->dash_phase;
+	route->dashlen=stroke->dash_len;
+	route->dash=NULL;
+	if(stroke->dash_len>0)
+	{
+		route->dash=(float*)arenaalloc(csi->cap->getline->arena,stroke->dash_len*sizeof(float));
+		for(i=0;i<stroke->dash_len;i++)
+			route->dash[i]=stroke->dash_list[i];
+	}
+}
+
 static void
 pdf_show_shade(pdf_csi *csi, fz_shade *shd)
 {
@@ -642,6 +722,60 @@ pdf_show_shade(pdf_csi *csi, fz_shade *shd)
 	pdf_end_group(csi);
 }
 
+static void
+pdf_capture_image(pdf_csi *csi, fz_image *image)//ȡͼƬ,תΪrgb׷ӵ豸ͼƬ
+{
+	fz_context *ctx = csi->dev->ctx;
+	struct zimages *images = &csi->cap->images;
+	struct zimagenode *node;
+	fz_pixmap *pix = NULL;
+	fz_pixmap *rgb = NULL;
+	size_t size;
+
+	fz_var(pix);
+	fz_var(rgb);
+	fz_try(ctx)
+	{
+		pix = fz_image_to_pixmap(ctx, image, image->w, image->h);
+		if (pix->colorspace != fz_device_rgb)
+		{
+			rgb = fz_new_pixmap(ctx, fz_device_rgb, pix->w, pix->h);
+			fz_convert_pixmap(ctx, rgb, pix);
+		}
+		else
+			rgb = fz_keep_pixmap(ctx, pix);
+		size = (size_t)rgb->w * rgb->h * rgb->n;
+		node = (struct zimagenode *)malloc(sizeof(struct zimagenode));
+		if (node == NULL)
+			fz_throw(ctx, "out of memory capturing image");
+		node->data = (unsigned char *)malloc(size);
+		if (node->data == NULL)
+		{
+			free(node);
+			fz_throw(ctx, "out of memory capturing image");
+		}
+		memcpy(node->data, rgb->samples, size);
+		node->w = rgb->w;
+		node->h = rgb->h;
+		node->n = rgb->n;
+		node->next = NULL;
+		if (images->head == NULL)
+			fz_init_images(images);
+		images->currentimage->next = node;
+		images->currentimage = node;
+		images->count++;
+	}
+	fz_always(ctx)
+	{
+		fz_drop_pixmap(ctx, rgb);
+		fz_drop_pixmap(ctx, pix);
+	}
+	fz_catch(ctx)
+	{
+		fz_warn(ctx, "cannot capture image");
+	}
+}
+
 static void
 pdf_show_image(pdf_csi *csi, fz_image *image)//ʾͼƬ
 {
@@ -699,6 +833,8 @@ pdf_show_image(pdf_csi *csi, fz_image *image)//
 	}
 	else
 	{
+		if (csi->cap)
+			pdf_capture_image(csi, image);
 		fz_fill_image(csi->dev, image, image_ctm, gstate->fill.alpha);
 	}
 
@@ -742,7 +878,10 @@ pdf_show_path(pdf_csi *csi, int doclose, int dofill, int dostroke, int even_odd)
 			fz_closepath(ctx, path);
 
 		if (dostroke)//?
+		{
 			bbox = fz_bound_path(ctx, path, gstate->stroke_state, gstate->ctm);
+			pdf_capture_stroke(csi, gstate->stroke_state);
+		}
 		else
 			bbox = fz_bound_path(ctx, path, NULL, gstate->ctm);
 
@@ -783,6 +922,8 @@ pdf_show_path(pdf_csi *csi, int doclose, int dofill, int dostroke, int even_odd)
 			case PDF_MAT_PATTERN:
 				if (gstate->fill.pattern)
 				{
+					if (csi->cap)//ȡʱ·ֻ¼ͼ,ͼԪȡһ
+						csi->cap->currentstackpoint->currentroute->pattern = pdf_capture_pattern(csi, gstate->fill.pattern, PDF_FILL);
 					fz_clip_path(csi->dev, path, NULL, even_odd, gstate->ctm);
 					pdf_show_pattern(csi, gstate->fill.pattern, bbox, PDF_FILL);
 					fz_pop_clip(csi->dev);
@@ -812,6 +953,8 @@ pdf_show_path(pdf_csi *csi, int doclose, int dofill, int dostroke, int even_odd)
 			case PDF_MAT_PATTERN:
 				if (gstate->stroke.pattern)
 				{
+					if (csi->cap)
+						csi->cap->currentstackpoint->currentroute->spattern = pdf_capture_pattern(csi, gstate->stroke.pattern, PDF_STROKE);
 					fz_clip_stroke_path(csi->dev, path, &bbox, gstate->stroke_state, gstate->ctm);
 					pdf_show_pattern(csi, gstate->stroke.pattern, bbox, PDF_STROKE);
 					fz_pop_clip(csi->dev);
@@ -1281,6 +1424,18 @@ pdf_new_csi(pdf_document *xref, fz_device *dev, fz_matrix ctm, char *event, fz_c
 		csi->gtop = 0;
 
 		csi->cookie = cookie;
+
+		if (dev->hints & FZ_NO_CAPTURE)//ʽ豸Լͼ,ʸȡṹ,еȡ
+			csi->cap = NULL;
+		else
+		{
+			if (dev->capture == NULL)
+			{
+				dev->capture = fz_malloc_struct(ctx, struct zblcapture);
+				dev->capture->currentlinewidth = 1;
+			}
+			csi->cap = dev->capture;
+		}
 	}
 	fz_catch(ctx)
 	{
@@ -1457,19 +1612,23 @@ pdf_set_color(pdf_csi *csi, int what, float *v)
 				//printf("ɫֵ:%d  %.2f\n",i,v[i]);
 				//getline.set[getline.count].color[i]=v[i];
 				//getline->set[getline->count].color[i]=v[i];//ɫ
-				currentstackpoint->currentroute->color[i]=v[i];
-				if(colorchanged==1)
-				{
-					currentfillcolor[i]=v[i];
-					//printf("ɫ:%d  %.2f\n",i,v[i]);
-				}
-				else if(colorchanged==2)
+				if(csi->cap)
 				{
-					currentstrokecolor[i]=v[i];
-					//printf("ɫ:%d  %.2f\n",i,v[i]);
+					csi->cap->currentstackpoint->currentroute->color[i]=v[i];
+					if(csi->cap->colorchanged==1)
+					{
+						csi->cap->currentfillcolor[i]=v[i];
+						//printf("ɫ:%d  %.2f\n",i,v[i]);
+					}
+					else if(csi->cap->colorchanged==2)
+					{
+						csi->cap->currentstrokecolor[i]=v[i];
+						//printf("ɫ:%d  %.2f\n",i,v[i]);
+					}
 				}
 			}
-			colorchanged=0;
+			if(csi->cap)
+				csi->cap->colorchanged=0;
 		//}
 		/*else
 		{
@@ -1549,15 +1708,61 @@ pdf_unset_pattern(pdf_csi *csi, int what)
  * Patterns, XObjects and ExtGState
  */
 
+struct pdf_capture_save_s//лȡλǰҳȡ״̬
+{
+	struct spointstack cstack;
+	struct zblstack *currentstackpoint;
+	int stackstate;
+	struct zblstack *stackheadler;
+	struct zblstack *currentstack;
+	int count;
+};
+
 static void
-pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what)
+pdf_capture_enter(pdf_csi *csi, struct pdf_capture_save_s *save, struct zblstack *stackheadler)//ȡλлµջ,ֻһεıͼ
+{
+	struct zblcapture *cap = csi->cap;
+	struct zblrouteset *getline = cap->getline;
+
+	save->cstack = cap->cstack;
+	save->currentstackpoint = cap->currentstackpoint;
+	save->stackstate = cap->stackstate;
+	save->stackheadler = getline->stackheadler;
+	save->currentstack = getline->currentstack;
+	save->count = getline->count;
+	getline->stackheadler = stackheadler;
+	getline->currentstack = stackheadler;
+	getline->count = 0;
+	initcstack(&cap->cstack);
+	cap->stackstate = 0;
+	cap->nested++;
+	addstack(getline);
+	cap->currentstackpoint = getline->currentstack;
+}
+
+static void
+pdf_capture_leave(pdf_csi *csi, struct pdf_capture_save_s *save, struct zblstack **currentstack, int *count)//ָҳȡλ,ջβջ
+{
+	struct zblcapture *cap = csi->cap;
+	struct zblrouteset *getline = cap->getline;
+
+	*currentstack = getline->currentstack;
+	*count = getline->count;
+	freecstack(&cap->cstack);
+	cap->cstack = save->cstack;
+	cap->currentstackpoint = save->currentstackpoint;
+	cap->stackstate = save->stackstate;
+	cap->nested--;
+	getline->stackheadler = save->stackheadler;
+	getline->currentstack = save->currentstack;
+	getline->count = save->count;
+}
+
+static void
+pdf_begin_pattern(pdf_csi *csi, pdf_pattern *pat, int what)//ͼǰͼ״̬,߸pdf_grestore
 {
 	fz_context *ctx = csi->dev->ctx;
 	pdf_gstate *gstate;
-	fz_matrix ptm, invptm;
-	fz_matrix oldtopctm;
-	int x0, y0, x1, y1;
-	int oldtop;
 
 	pdf_gsave(csi);
 	gstate = csi->gstate + csi->gtop;
@@ -1591,6 +1796,100 @@ pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what)
 		pdf_drop_xobject(ctx, gstate->softmask);
 		gstate->softmask = NULL;
 	}
+}
+
+static int
+pdf_capture_pattern(pdf_csi *csi, pdf_pattern *pat, int what)//ȡƽͼ,ÿͼֻһͼԪ,رҳڵı
+{
+	fz_context *ctx = csi->dev->ctx;
+	struct zblcapture *cap = csi->cap;
+	struct zblrouteset *getline = cap->getline;
+	struct zblpattern *p;
+	struct pdf_capture_save_s save;
+	pdf_gstate *gstate;
+	fz_device *dev;
+	fz_matrix oldtopctm;
+	int nested = cap->nested > 0;
+	int oldtop;
+
+	for (p = getline->patternheadler; p; p = p->nextpattern)
+		if (p->num == pat->num && p->nested == nested)
+			return p->id;
+
+	p = (struct zblpattern*)arenaalloc(getline->arena, sizeof(struct zblpattern));
+	p->id = getline->patternheadler ? getline->patternheadler->id + 1 : 1;
+	p->num = pat->num;
+	p->nested = nested;
+	p->xstep = pat->xstep;
+	p->ystep = pat->ystep;
+	p->matrix[0] = pat->matrix.a;//ͼĳʼϵ,ȡĵ㲻ҳĻ,ֱӼ¼
+	p->matrix[1] = pat->matrix.b;
+	p->matrix[2] = pat->matrix.c;
+	p->matrix[3] = pat->matrix.d;
+	p->matrix[4] = pat->matrix.e;
+	p->matrix[5] = pat->matrix.f;
+	p->bbox[0] = pat->bbox.x0;
+	p->bbox[1] = pat->bbox.y0;
+	p->bbox[2] = pat->bbox.x1;
+	p->bbox[3] = pat->bbox.y1;
+	p->count = 0;
+	p->stackheadler = (struct zblstack*)arenaalloc(getline->arena, sizeof(struct zblstack));
+	initstack(getline->arena, p->stackheadler);
+	p->currentstack = p->stackheadler;
+	p->nextpattern = getline->patternheadler;
+	getline->patternheadler = p;//ȵǼ,ͼʱֻ¼
+
+	dev = csi->dev;
+	if ((dev->hints & FZ_CAPTURE_ONLY) == 0)//豸ʱ,ͼԪֻȡ,pdf_show_patternƽչ
+		csi->dev = fz_new_capture_device(ctx, dev->hints);
+	oldtopctm = csi->top_ctm;
+	oldtop = csi->gtop;
+	pdf_begin_pattern(csi, pat, what);
+	gstate = csi->gstate + csi->gtop;
+	gstate->ctm = fz_concat(pat->matrix, csi->top_ctm);
+	csi->top_ctm = gstate->ctm;
+	pdf_capture_enter(csi, &save, p->stackheadler);
+	fz_try(ctx)
+	{
+		pdf_gsave(csi);
+		pdf_run_buffer(csi, pat->resources, pat->contents);
+	}
+	fz_always(ctx)
+	{
+		pdf_capture_leave(csi, &save, &p->currentstack, &p->count);
+		while (oldtop < csi->gtop)
+			pdf_grestore(csi);
+		csi->top_ctm = oldtopctm;
+		if (csi->dev != dev)
+		{
+			fz_free_device(csi->dev);
+			csi->dev = dev;
+		}
+	}
+	fz_catch(ctx)
+	{
+		fz_rethrow(ctx);
+	}
+	return p->id;
+}
+
+static void
+pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what)
+{
+	fz_context *ctx = csi->dev->ctx;
+	struct zblcapture *cap = csi->cap;
+	pdf_gstate *gstate;
+	fz_matrix ptm, invptm;
+	fz_matrix oldtopctm;
+	int x0, y0, x1, y1;
+	int oldtop;
+
+	if (cap && (csi->dev->hints & FZ_CAPTURE_ONLY))//ֻȡʱͼpdf_capture_pattern¼,ٰչ
+		return;
+
+	pdf_begin_pattern(csi, pat, what);
+	gstate = csi->gstate + csi->gtop;
+	csi->cap = NULL;//ƽ̵ÿͼԪֻƲȡ,һҳչɳǧ·
 
 	ptm = fz_concat(pat->matrix, csi->top_ctm);
 	invptm = fz_invert_matrix(ptm);
@@ -1622,12 +1921,23 @@ pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what)
 		gstate->ctm = ptm;
 		csi->top_ctm = gstate->ctm;
 		pdf_gsave(csi);
-		pdf_run_buffer(csi, pat->resources, pat->contents);
-		/* RJW: "cannot render pattern tile" */
-		pdf_grestore(csi);
-		while (oldtop < csi->gtop)
+		fz_try(ctx)
+		{
+			pdf_run_buffer(csi, pat->resources, pat->contents);
+		}
+		fz_always(ctx)
+		{
 			pdf_grestore(csi);
-		fz_end_tile(csi->dev);
+			while (oldtop < csi->gtop)
+				pdf_grestore(csi);
+			fz_end_tile(csi->dev);
+		}
+		fz_catch(ctx)
+		{
+			csi->top_ctm = oldtopctm;
+			csi->cap = cap;//ͼԪչʱһ,ҲҪָȡ
+			fz_throw(ctx, "cannot render pattern tile");
+		}
 	}
 	else
 	{
@@ -1649,6 +1959,7 @@ pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what)
 					while (oldtop < csi->gtop)
 						pdf_grestore(csi);
 					csi->top_ctm = oldtopctm;
+					csi->cap = cap;
 					fz_throw(ctx, "cannot render pattern tile");
 				}
 				pdf_grestore(csi);
@@ -1658,6 +1969,7 @@ pdf_show_pattern(pdf_csi *csi, pdf_pattern *pat, fz_rect area, int what)
 		}
 	}
 	csi->top_ctm = oldtopctm;
+	csi->cap = cap;
 
 	pdf_grestore(csi);
 }
@@ -1854,7 +2166,10 @@ pdf_run_extgstate(pdf_csi *csi, pdf_obj *rdb, pdf_obj *extgstate)//
 		else if (!strcmp(s, "CA"))
 		{
 			gstate->stroke.alpha = pdf_to_real(val);//˴Ϊ͸
-			currentstackpoint->ca=gstate->stroke.alpha;
+			if(csi->cap)
+			{
+				csi->cap->currentstackpoint->ca=gstate->stroke.alpha;
+			}
 			//printf("ȡ͸%f",gstate->stroke.alpha);
 		}
 		else if (!strcmp(s, "ca"))
@@ -1930,26 +2245,178 @@ pdf_run_extgstate(pdf_csi *csi, pdf_obj *rdb, pdf_obj *extgstate)//
  * Operators
  */
 
-static void pdf_run_BDC(pdf_csi *csi, pdf_obj *rdb)
+static void pdf_capture_push(pdf_csi *csi)//ȡ:һͼ״̬ջ
 {
-	pdf_obj *ocg;
-	stackstate++;
-	
-	if(stackstate==1)
+	csi->cap->stackstate++;
+
+	if(csi->cap->stackstate==1)//
+	{
+		csi->cap->currentstackpoint->existstack=1;
+		push(&csi->cap->cstack, csi->cap->currentstackpoint);
+	}
+	else
+	{
+		csi->cap->currentstackpoint->existnest=1;
+		addneststack(csi->cap->getline->arena,csi->cap->currentstackpoint);
+		csi->cap->currentstackpoint=csi->cap->currentstackpoint->currentstack;//ǰջָƶһ
+		push(&csi->cap->cstack, csi->cap->currentstackpoint);
+		csi->cap->currentstackpoint->existstack=1;
+	}
+}
+
+static void pdf_capture_pop(pdf_csi *csi)//ȡ:˳һͼ״̬ջ
+{
+	csi->cap->stackstate--;//ջ
+	if(csi->cap->stackstate==0)
 	{
-		currentstackpoint->existstack=1;
-		//printf("stack: %d\n",currentstackpoint->existnest);
-		//addneststack(currentstackpoint);
-		push(currentstackpoint);
+		pop(&csi->cap->cstack);
+		addstack(csi->cap->getline);
+		csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+		csi->cap->getline->count++;
 	}
 	else
 	{
-		currentstackpoint->existnest=1;
-		//printf("stack: %d\n",currentstackpoint->existnest);
-		addneststack(currentstackpoint);//ǰstackǶ
-		currentstackpoint=currentstackpoint->currentstack;//ǰջָƶһ
-		push(currentstackpoint);
-		currentstackpoint->existstack=1;
+		pop(&csi->cap->cstack);
+		csi->cap->currentstackpoint=currentstack(&csi->cap->cstack);//һ
+	}
+}
+
+static fz_matrix pdf_capture_cm(pdf_csi *csi, fz_matrix m)//ȡ:ǰջ¼תþ,ջкϲľ
+{
+	struct zblstack* stack=csi->cap->currentstackpoint;
+	fz_matrix sm=m;
+	if(stack->existcm==1)//ͬһջٴγcm,¾,еľ
+	{
+		fz_matrix om;
+		om.a=stack->matrix[0];
+		om.b=stack->matrix[1];
+		om.c=stack->matrix[2];
+		om.d=stack->matrix[3];
+		om.e=stack->matrix[4];
+		om.f=stack->matrix[5];
+		sm=fz_concat(m,om);
+	}
+	stack->existcm=1;
+	stack->matrix[0]=sm.a;//ֱӴջ,ٵ
+	stack->matrix[1]=sm.b;
+	stack->matrix[2]=sm.c;
+	stack->matrix[3]=sm.d;
+	stack->matrix[4]=sm.e;
+	stack->matrix[5]=sm.f;
+	return sm;
+}
+
+static struct zblxobject *
+pdf_find_captured_xobject(struct zblrouteset *getline, int num)//ҳǷȡöŵı
+{
+	struct zblxobject *x;
+	for (x = getline->xobjectheadler; x; x = x->nextxobject)
+		if (x->num == num)
+			return x;
+	return NULL;
+}
+
+static void
+pdf_run_form(pdf_csi *csi, pdf_obj *resources, pdf_xobject *xobj, int num)//ƱXObject,ȡʱÿֻһ,ÿεֻڵǰλһʵջ
+{
+	fz_context *ctx = csi->dev->ctx;
+	struct zblcapture *cap = csi->cap;
+	struct zblrouteset *getline;
+	struct zblxobject *x;
+	struct pdf_capture_save_s save;
+
+	if (cap == NULL || num <= 0)//ȡ,ûжŵֱӶ
+	{
+		pdf_run_xobject(csi, resources, xobj, fz_identity);
+		return;
+	}
+
+	getline = cap->getline;
+	pdf_capture_push(csi);
+	fz_try(ctx)
+	{
+		cap->currentstackpoint->xobject = num;
+		pdf_capture_cm(csi, xobj->matrix);//ʵջ¼,ľڽҳģʱϲ
+
+		x = pdf_find_captured_xobject(getline, num);
+		if (x)
+		{
+			if ((csi->dev->hints & FZ_CAPTURE_ONLY) == 0)//豸,ʱȡ
+			{
+				csi->cap = NULL;
+				fz_try(ctx)
+				{
+					pdf_run_xobject(csi, resources, xobj, fz_identity);
+				}
+				fz_always(ctx)
+				{
+					csi->cap = cap;
+				}
+				fz_catch(ctx)
+				{
+					fz_rethrow(ctx);
+				}
+			}
+		}
+		else
+		{
+			x = (struct zblxobject*)arenaalloc(getline->arena, sizeof(struct zblxobject));
+			x->num = num;
+			x->count = 0;
+			x->stackheadler = (struct zblstack*)arenaalloc(getline->arena, sizeof(struct zblstack));
+			initstack(getline->arena, x->stackheadler);
+			x->currentstack = x->stackheadler;
+			x->nextxobject = getline->xobjectheadler;
+			getline->xobjectheadler = x;//ȵǼ,ʱֻʵ
+
+			pdf_capture_enter(csi, &save, x->stackheadler);//ҳȡλ,ݴµջʼȡ
+			fz_try(ctx)
+			{
+				pdf_run_xobject(csi, resources, xobj, fz_identity);
+			}
+			fz_always(ctx)
+			{
+				pdf_capture_leave(csi, &save, &x->currentstack, &x->count);
+			}
+			fz_catch(ctx)
+			{
+				fz_rethrow(ctx);
+			}
+		}
+	}
+	fz_always(ctx)
+	{
+		pdf_capture_pop(csi);//ʧʱҲصջ,֮ݲʵջ
+	}
+	fz_catch(ctx)
+	{
+		fz_rethrow(ctx);
+	}
+}
+
+static void pdf_run_BDC(pdf_csi *csi, pdf_obj *rdb)
+{
+	pdf_obj *ocg;
+	if(csi->cap)
+	{
+		csi->cap->stackstate++;
+	
+		if(csi->cap->stackstate==1)
+		{
+			csi->cap->currentstackpoint->existstack=1;
+			//printf("stack: %d\n",currentstackpoint->existnest);
+			//addneststack(currentstackpoint);
+			push(&csi->cap->cstack, csi->cap->currentstackpoint);
+		}
+		else
+		{
+			csi->cap->currentstackpoint->existnest=1;
+			//printf("stack: %d\n",currentstackpoint->existnest);
+			addneststack(csi->cap->getline->arena,csi->cap->currentstackpoint);//ǰstackǶ
+			csi->cap->currentstackpoint=csi->cap->currentstackpoint->currentstack;//ǰջָƶһ
+			push(&csi->cap->cstack, csi->cap->currentstackpoint);
+			csi->cap->currentstackpoint->existstack=1;
+		}
 	}
 	/* If we are already in a hidden OCG, then we'll still be hidden -
 	 * just increment the depth so we pop back to visibility when we've
@@ -2012,67 +2479,70 @@ static void pdf_run_BI(pdf_csi *csi, pdf_obj *rdb, fz_stream *file)
 static void pdf_run_B(pdf_csi *csi)//B֮ͿĨ 
 {
 	pdf_show_path(csi, 0, 1, 1, 0);
-	currentstackpoint->currentroute->drawingmethord=5;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		currentstackpoint->currentroute->scolorspace=currentstrokecolorspace;
-		printf("ǰ˫ɫɫռ %d %d\n",currentstackpoint->currentroute->colorspace,currentstackpoint->currentroute->scolorspace);
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{//ҲͿĨ,Ҫɫ
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
-		}
-		else
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=5;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			csi->cap->currentstackpoint->currentroute->scolorspace=csi->cap->currentstrokecolorspace;
+			printf("ǰ˫ɫɫռ %d %d\n",csi->cap->currentstackpoint->currentroute->colorspace,csi->cap->currentstackpoint->currentroute->scolorspace);
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{//ҲͿĨ,Ҫɫ
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+			}
+			csi->cap->currentstackpoint->currentroute->scolor=(float*)arenaalloc(csi->cap->getline->arena,4*sizeof(float));
+			//Ϊscolorռ
+			if(csi->cap->currentstrokecolorspace==3||csi->cap->currentstrokecolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentstrokecolor[0];
+				csi->cap->currentstackpoint->currentroute->scolor[1]=csi->cap->currentstrokecolor[1];
+				csi->cap->currentstackpoint->currentroute->scolor[2]=csi->cap->currentstrokecolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentfillcolor[0];
+			}
+		
 		}
-		currentstackpoint->currentroute->scolor=(float*)malloc(4*sizeof(float));
-		//Ϊscolorռ
-		if(currentstrokecolorspace==3||currentstrokecolorspace==4)
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentstrokecolor[0];
-			currentstackpoint->currentroute->scolor[1]=currentstrokecolor[1];
-			currentstackpoint->currentroute->scolor[2]=currentstrokecolor[2];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
 		}
-		else
+		else//Ϊ
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentfillcolor[0];
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 }
 
@@ -2081,21 +2551,24 @@ static void pdf_run_BMC(pdf_csi *csi)
 	/* If we are already in a hidden OCG, then we'll still be hidden -
 	 * just increment the depth so we pop back to visibility when we've
 	 * seen enough EDCs. */
-	stackstate++;
-	currentstackpoint->existstack=1;
-	if(stackstate==1)
-	{
-		//printf("stack: %d\n",currentstackpoint->existnest);
-		//addneststack(currentstackpoint);
-		push(currentstackpoint);
-	}
-	else
+	if(csi->cap)
 	{
-		currentstackpoint->existnest=1;
-		//printf("stack: %d\n",currentstackpoint->existnest);
-		addneststack(currentstackpoint);
-		currentstackpoint=currentstackpoint->currentstack;//ǰջָƶһ
-		push(currentstackpoint);
+		csi->cap->stackstate++;
+		csi->cap->currentstackpoint->existstack=1;
+		if(csi->cap->stackstate==1)
+		{
+			//printf("stack: %d\n",currentstackpoint->existnest);
+			//addneststack(currentstackpoint);
+			push(&csi->cap->cstack, csi->cap->currentstackpoint);
+		}
+		else
+		{
+			csi->cap->currentstackpoint->existnest=1;
+			//printf("stack: %d\n",currentstackpoint->existnest);
+			addneststack(csi->cap->getline->arena,csi->cap->currentstackpoint);
+			csi->cap->currentstackpoint=csi->cap->currentstackpoint->currentstack;//ǰջָƶһ
+			push(&csi->cap->cstack, csi->cap->currentstackpoint);
+		}
 	}
 	if (csi->in_hidden_ocg > 0)
 	{
@@ -2118,66 +2591,69 @@ static void pdf_run_BX(pdf_csi *csi)
 static void pdf_run_Bstar(pdf_csi *csi)//B* ͿĨ ż
 {
 	pdf_show_path(csi, 0, 1, 1, 1);
-	currentstackpoint->currentroute->drawingmethord=6;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		currentstackpoint->currentroute->scolorspace=currentstrokecolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{//ҲͿĨ,Ҫɫ
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
-		}
-		else
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=6;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			csi->cap->currentstackpoint->currentroute->scolorspace=csi->cap->currentstrokecolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{//ҲͿĨ,Ҫɫ
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+			}
+			csi->cap->currentstackpoint->currentroute->scolor=(float*)arenaalloc(csi->cap->getline->arena,4*sizeof(float));
+			//Ϊscolorռ
+			if(csi->cap->currentstrokecolorspace==3||csi->cap->currentstrokecolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentstrokecolor[0];
+				csi->cap->currentstackpoint->currentroute->scolor[1]=csi->cap->currentstrokecolor[1];
+				csi->cap->currentstackpoint->currentroute->scolor[2]=csi->cap->currentstrokecolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentfillcolor[0];
+			}
+		
 		}
-		currentstackpoint->currentroute->scolor=(float*)malloc(4*sizeof(float));
-		//Ϊscolorռ
-		if(currentstrokecolorspace==3||currentstrokecolorspace==4)
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentstrokecolor[0];
-			currentstackpoint->currentroute->scolor[1]=currentstrokecolor[1];
-			currentstackpoint->currentroute->scolor[2]=currentstrokecolor[2];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
 		}
-		else
+		else//Ϊ
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentfillcolor[0];
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 }
 
@@ -2275,7 +2751,7 @@ static void pdf_run_Do(pdf_csi *csi, pdf_obj *rdb)//
 
 		fz_try(ctx)
 		{
-			pdf_run_xobject(csi, xobj->resources, xobj, fz_identity);
+			pdf_run_form(csi, xobj->resources, xobj, pdf_to_num(obj));
 		}
 		fz_catch(ctx)
 		{
@@ -2320,19 +2796,22 @@ static void pdf_run_Do(pdf_csi *csi, pdf_obj *rdb)//
 
 static void pdf_run_EMC(pdf_csi *csi)
 {
-	stackstate--;
-	if(stackstate==0)
-	{
-		//printf("emcӴ\n");
-		pop();
-		addstack(getline);	
-		currentstackpoint=getline->currentstack;
-		getline->count++;
-	}
-	else
+	if(csi->cap)
 	{
-		pop();
-		currentstackpoint=currentstack();//һ
+		csi->cap->stackstate--;
+		if(csi->cap->stackstate==0)
+		{
+			//printf("emcӴ\n");
+			pop(&csi->cap->cstack);
+			addstack(csi->cap->getline);	
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
+		}
+		else
+		{
+			pop(&csi->cap->cstack);
+			csi->cap->currentstackpoint=currentstack(&csi->cap->cstack);//һ
+		}
 	}
 	/*if(stackstate==0)//ջڵʱ
 	{
@@ -2358,57 +2837,62 @@ static void pdf_run_EX(pdf_csi *csi)
 static void pdf_run_F(pdf_csi *csi)
 {
 	pdf_show_path(csi, 0, 1, 0, 0);
-	currentstackpoint->currentroute->drawingmethord=3;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=3;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
+		{
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+			}
+		
 		}
-		else
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
+		}
+		else//Ϊ
+		{
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 }
 
 static void pdf_run_G(pdf_csi *csi)
 {
-	colorchanged=2;
+	if(csi->cap)
+		csi->cap->colorchanged=2;
 	csi->dev->flags &= ~FZ_DEVFLAG_STROKECOLOR_UNDEFINED;
 	pdf_set_colorspace(csi, PDF_STROKE, fz_device_gray);
 	pdf_set_color(csi, PDF_STROKE, csi->stack);
 	//getline->set[getline->count].colorspace=1;//ɫռΪ1G
 	//currentstackpoint->currentroute->colorspace=1;
-	currentstrokecolorspace=1;//浱ǰɫռ,Ա˳ʹ
+	if(csi->cap)
+		csi->cap->currentstrokecolorspace=1;//浱ǰɫռ,Ա˳ʹ
 }
 
 static void pdf_run_J(pdf_csi *csi)
@@ -2426,11 +2910,15 @@ static void pdf_run_J(pdf_csi *csi)
 
 static void pdf_run_K(pdf_csi *csi)
 {
-	colorchanged=2;
+	if(csi->cap)
+		csi->cap->colorchanged=2;
 	csi->dev->flags &= ~FZ_DEVFLAG_STROKECOLOR_UNDEFINED;
 	pdf_set_colorspace(csi, PDF_STROKE, fz_device_cmyk);
-	currentstackpoint->currentroute->colorspace=6;//cmykɫʿռ K
-	currentstrokecolorspace=6;//תΪrgbռ
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->colorspace=6;//cmykɫʿռ K
+		csi->cap->currentstrokecolorspace=6;//תΪrgbռ
+	}
 	pdf_set_color(csi, PDF_STROKE, csi->stack);
 }
 
@@ -2448,19 +2936,8 @@ static void pdf_run_MP(pdf_csi *csi)
 
 static void pdf_run_Q(pdf_csi *csi)
 {
-	stackstate--;//ջ
-	if(stackstate==0)
-	{
-		pop();
-		addstack(getline);	
-		currentstackpoint=getline->currentstack;
-		getline->count++;
-	}
-	else
-	{
-		pop();
-		currentstackpoint=currentstack();//һ
-	}
+	if(csi->cap)
+		pdf_capture_pop(csi);
 	/*if(stackstate==0)//ջڵʱ
 	{
 		getline->count=getline->count+1;//·
@@ -2473,13 +2950,15 @@ static void pdf_run_Q(pdf_csi *csi)
 
 static void pdf_run_RG(pdf_csi *csi)
 {
-	colorchanged=2;
+	if(csi->cap)
+		csi->cap->colorchanged=2;
 	csi->dev->flags &= ~FZ_DEVFLAG_STROKECOLOR_UNDEFINED;
 	pdf_set_colorspace(csi, PDF_STROKE, fz_device_rgb);
 	pdf_set_color(csi, PDF_STROKE, csi->stack);
 	//getline.set[getline.count].colorspace=3;//RGB
 	//currentstackpoint->currentroute->colorspace=3;
-	currentstrokecolorspace=3;//õǰɫռ Ա˳
+	if(csi->cap)
+		csi->cap->currentstrokecolorspace=3;//õǰɫռ Ա˳
 }
 
 static void pdf_run_S(pdf_csi *csi)
@@ -2490,47 +2969,50 @@ static void pdf_run_S(pdf_csi *csi)
 	}*/
 	//getline.count++;//һ·
 	//getline->set[getline->count].drawingmethord=1;//ûƷ 1-S
-	currentstackpoint->currentroute->drawingmethord=1;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)
-	{
-		currentstackpoint->currentroute->colorspace=currentstrokecolorspace;
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//rintf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentstrokecolorspace==3||currentstrokecolorspace==4)
-		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentstrokecolor[0];
-			currentstackpoint->currentroute->color[1]=currentstrokecolor[1];
-			currentstackpoint->currentroute->color[2]=currentstrokecolor[2];
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=1;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)
+		{
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentstrokecolorspace;
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//rintf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentstrokecolorspace==3||csi->cap->currentstrokecolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentstrokecolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentstrokecolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentstrokecolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentstrokecolor[0];
+			}	
 		}
-		else
+		if(csi->cap->currentstackpoint->currentroute->linewidth==-1)//߿˳
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentstrokecolor[0];
-		}	
-	}
-	if(currentstackpoint->currentroute->linewidth==-1)//߿˳
-	{
-		currentstackpoint->currentroute->linewidth=currentlinewidth;
-	}
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
+			csi->cap->currentstackpoint->currentroute->linewidth=csi->cap->currentlinewidth;
+		}
+		if(csi->cap->currentstackpoint->existstack!=0)
+		{
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
+		}
+		else//Ϊ
+		{
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
+		}
 	}
 
 	/*if(stackstate==0)//ջڵʱ
@@ -2593,6 +3075,7 @@ static void pdf_run_SC_imp(pdf_csi *csi, pdf_obj *rdb, int what, pdf_material *m
 			fz_shade *shd;
 			shd = pdf_load_shading(csi->xref, obj);
 			/* RJW: "cannot load shading (%d 0 R)", pdf_to_num(obj) */
+			pdf_capture_shade(csi, shd);
 			pdf_set_shade(csi, what, shd);
 			fz_drop_shade(ctx, shd);
 		}
@@ -2611,11 +3094,13 @@ static void pdf_run_SC(pdf_csi *csi, pdf_obj *rdb)
 {
 	pdf_gstate *gstate = csi->gstate + csi->gtop;
 	csi->dev->flags &= ~FZ_DEVFLAG_STROKECOLOR_UNDEFINED;
-	colorchanged=2;
+	if(csi->cap)
+		csi->cap->colorchanged=2;
 	pdf_run_SC_imp(csi, rdb, PDF_STROKE, &gstate->stroke);
 	
 	//currentstackpoint->currentroute->colorspace=3;
-	currentstrokecolorspace=3;//õǰɫռ Ա˳
+	if(csi->cap)
+		csi->cap->currentstrokecolorspace=3;//õǰɫռ Ա˳
 	/* RJW: "cannot set color and colorspace" */
 }
 
@@ -2623,11 +3108,13 @@ static void pdf_run_sc(pdf_csi *csi, pdf_obj *rdb)
 {
 	pdf_gstate *gstate = csi->gstate + csi->gtop;
 	csi->dev->flags &= ~FZ_DEVFLAG_FILLCOLOR_UNDEFINED;
-	colorchanged=1;
+	if(csi->cap)
+		csi->cap->colorchanged=1;
 	pdf_run_SC_imp(csi, rdb, PDF_FILL, &gstate->fill);
 
 	//currentstackpoint->currentroute->colorspace=4;
-	currentfillcolorspace=4;//õǰɫռ Ա˳
+	if(csi->cap)
+		csi->cap->currentfillcolorspace=4;//õǰɫռ Ա˳
 	/* RJW: "cannot set color and colorspace" */
 }
 
@@ -2751,9 +3238,12 @@ static void pdf_run_W(pdf_csi *csi)
 	//getline->set[getline->count].type=4;//Ϊ·
 	//getline->current->type=4;
 	//getline->current->pointsݸƸgetline->current->clipregion
-	currentstackpoint->existclip=1;
-	//˴Ʋü·
-	copycliproute(currentstackpoint);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->existclip=1;
+		//˴Ʋü·
+		copycliproute(csi->cap->getline->arena,csi->cap->currentstackpoint);
+	}
 	csi->clip = 1;
 	csi->clip_even_odd = 0;
 }
@@ -2762,9 +3252,12 @@ static void pdf_run_Wstar(pdf_csi *csi)
 {
 	//getline->set[getline->count].type=4;//Ϊ·
 	//getline->current->type=4;
-	currentstackpoint->existclip=2;//W*  ԴΪ
-	//˴Ʋü·
-	copycliproute(currentstackpoint);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->existclip=2;//W*  ԴΪ
+		//˴Ʋü·
+		copycliproute(csi->cap->getline->arena,csi->cap->currentstackpoint);
+	}
 	csi->clip = 1;
 	csi->clip_even_odd = 1;
 }
@@ -2772,132 +3265,138 @@ static void pdf_run_Wstar(pdf_csi *csi)
 static void pdf_run_b(pdf_csi *csi)//رȻ䲢ͿĨ· ൱h+B
 {
 	pdf_show_path(csi, 1, 1, 1, 0);
-	currentstackpoint->currentroute->drawingmethord=7;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		currentstackpoint->currentroute->scolorspace=currentstrokecolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{//ҲͿĨ,Ҫɫ
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
-		}
-		else
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=7;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			csi->cap->currentstackpoint->currentroute->scolorspace=csi->cap->currentstrokecolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{//ҲͿĨ,Ҫɫ
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+			}
+			csi->cap->currentstackpoint->currentroute->scolor=(float*)arenaalloc(csi->cap->getline->arena,4*sizeof(float));
+			//Ϊscolorռ
+			if(csi->cap->currentstrokecolorspace==3||csi->cap->currentstrokecolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentstrokecolor[0];
+				csi->cap->currentstackpoint->currentroute->scolor[1]=csi->cap->currentstrokecolor[1];
+				csi->cap->currentstackpoint->currentroute->scolor[2]=csi->cap->currentstrokecolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentfillcolor[0];
+			}
+		
 		}
-		currentstackpoint->currentroute->scolor=(float*)malloc(4*sizeof(float));
-		//Ϊscolorռ
-		if(currentstrokecolorspace==3||currentstrokecolorspace==4)
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentstrokecolor[0];
-			currentstackpoint->currentroute->scolor[1]=currentstrokecolor[1];
-			currentstackpoint->currentroute->scolor[2]=currentstrokecolor[2];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
 		}
-		else
+		else//Ϊ
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentfillcolor[0];
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 }
 
 static void pdf_run_bstar(pdf_csi *csi)//رͿĨ· żԭ
 {
 	pdf_show_path(csi, 1, 1, 1, 1);
-	currentstackpoint->currentroute->drawingmethord=8;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		currentstackpoint->currentroute->scolorspace=currentstrokecolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{//ҲͿĨ,Ҫɫ
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
-		}
-		else
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=8;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			csi->cap->currentstackpoint->currentroute->scolorspace=csi->cap->currentstrokecolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{//ҲͿĨ,Ҫɫ
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+			}
+			csi->cap->currentstackpoint->currentroute->scolor=(float*)arenaalloc(csi->cap->getline->arena,4*sizeof(float));
+			//Ϊscolorռ
+			if(csi->cap->currentstrokecolorspace==3||csi->cap->currentstrokecolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentstrokecolor[0];
+				csi->cap->currentstackpoint->currentroute->scolor[1]=csi->cap->currentstrokecolor[1];
+				csi->cap->currentstackpoint->currentroute->scolor[2]=csi->cap->currentstrokecolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->scolor[0]=csi->cap->currentfillcolor[0];
+			}
+		
 		}
-		currentstackpoint->currentroute->scolor=(float*)malloc(4*sizeof(float));
-		//Ϊscolorռ
-		if(currentstrokecolorspace==3||currentstrokecolorspace==4)
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentstrokecolor[0];
-			currentstackpoint->currentroute->scolor[1]=currentstrokecolor[1];
-			currentstackpoint->currentroute->scolor[2]=currentstrokecolor[2];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
 		}
-		else
+		else//Ϊ
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->scolor[0]=currentfillcolor[0];
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 }
 
@@ -2923,17 +3422,20 @@ static void pdf_run_c(pdf_csi *csi)
 	getline->set[getline->count].points[getline->set[getline->count].countpoint][6]=3;//Ӧc
 	getline->set[getline->count].countpoint++;
 	*/
-	currentstackpoint->currentroute->currentpoint->p0=a;
-	currentstackpoint->currentroute->currentpoint->p1=b;
-	currentstackpoint->currentroute->currentpoint->p2=c;
-	currentstackpoint->currentroute->currentpoint->p3=d;
-	currentstackpoint->currentroute->currentpoint->p4=e;
-	currentstackpoint->currentroute->currentpoint->p5=f;
-	currentstackpoint->currentroute->currentpoint->state=3;
-	Vpointx=e;
-	Vpointy=f;
-	currentstackpoint->currentroute->countpoint++;
-	addpoint(currentstackpoint->currentroute);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=a;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=b;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p2=c;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p3=d;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p4=e;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p5=f;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=3;
+		csi->cap->Vpointx=e;
+		csi->cap->Vpointy=f;
+		csi->cap->currentstackpoint->currentroute->countpoint++;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+	}
 	fz_curveto(csi->dev->ctx, csi->path, a, b, c, d, e, f);
 }
 
@@ -2941,7 +3443,6 @@ static void pdf_run_cm(pdf_csi *csi)//ָ
 {
 	pdf_gstate *gstate = csi->gstate + csi->gtop;
 	fz_matrix m;
-	int i=0;
 
 	m.a = csi->stack[0];
 	m.b = csi->stack[1];
@@ -2949,19 +3450,15 @@ static void pdf_run_cm(pdf_csi *csi)//ָ
 	m.d = csi->stack[3];
 	m.e = csi->stack[4];
 	m.f = csi->stack[5];
-	//getline->set[getline->count].matrix=(float*)malloc(6);
-	//getline->set[getline->count].existcm=1;
-	currentstackpoint->matrix=(float*)malloc(6*(sizeof(float)));/*(float*)malloc(6);*/
-	currentstackpoint->existcm=1;
-	for (i=0;i<6;i++)
-	{
-		//getline->set[getline->count].matrix[i]=csi->stack[i];
-		currentstackpoint->matrix[i]=csi->stack[i];
+	if(csi->cap)
+	{
 #ifdef debug
-		printf("תþ:%f\n",currentstackpoint->matrix[i]);
+		fz_matrix sm=pdf_capture_cm(csi,m);//ջм¼ľ
+		printf("תþ:%f %f %f %f %f %f\n",sm.a,sm.b,sm.c,sm.d,sm.e,sm.f);
+#else
+		pdf_capture_cm(csi,m);
 #endif
 	}
-	//printf("תþ%f %f %f %f %f %f \n",getline->set[getline->count].matrix[0],getline->set[getline->count].matrix[1],getline->set[getline->count].matrix[2],getline->set[getline->count].matrix[3],getline->set[getline->count].matrix[4],getline->set[getline->count].matrix[5]);
 	gstate->ctm = fz_concat(m, gstate->ctm);
 }
 
@@ -3002,45 +3499,48 @@ static void pdf_run_d1(pdf_csi *csi)
 static void pdf_run_f(pdf_csi *csi)
 {
 	pdf_show_path(csi, 0, 1, 0, 0);
-	currentstackpoint->currentroute->drawingmethord=3;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=3;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
+		{
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+			}
+		
 		}
-		else
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
+		}
+		else//Ϊ
+		{
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 }
 
@@ -3048,45 +3548,48 @@ static void pdf_run_fstar(pdf_csi *csi)
 {
 	pdf_show_path(csi, 0, 1, 0, 1);
 	//getline->set[getline->count].drawingmethord=2;//ûƷ 2-f*
-	currentstackpoint->currentroute->drawingmethord=2;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
-	{
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		currentstackpoint->currentroute->colorspace=currentfillcolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentfillcolorspace==3||currentfillcolorspace==4)
-		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentfillcolor[0];
-			currentstackpoint->currentroute->color[1]=currentfillcolor[1];
-			currentstackpoint->currentroute->color[2]=currentfillcolor[2];
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->drawingmethord=2;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)//ɫʿռ䲻,˳
+		{
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentfillcolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//printf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentfillcolorspace==3||csi->cap->currentfillcolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentfillcolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentfillcolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentfillcolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentstrokecolor[0];
+			}
+		
 		}
-		else
+		//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
+		if(csi->cap->currentstackpoint->existstack!=0)
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentstrokecolor[0];
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
+		}
+		else//Ϊ
+		{
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
 		}
-		
-	}
-	//printf("\nǰṹǷΪջ:%d\n",currentstackpoint->existstack);
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
 	}
 	/*if(stackstate==0)//ջڵʱ
 	{
@@ -3106,13 +3609,15 @@ static void pdf_run_fstar(pdf_csi *csi)
 
 static void pdf_run_g(pdf_csi *csi)
 {
-	colorchanged=1;
+	if(csi->cap)
+		csi->cap->colorchanged=1;
 	csi->dev->flags &= ~FZ_DEVFLAG_FILLCOLOR_UNDEFINED;
 	pdf_set_colorspace(csi, PDF_FILL, fz_device_gray);
 	pdf_set_color(csi, PDF_FILL, csi->stack);
 	//getline->set[getline->count].colorspace=2;//ɫռ 2g
 	//currentstackpoint->currentroute->colorspace=2;
-	currentfillcolorspace=2;//õǰɫռ Ա˳
+	if(csi->cap)
+		csi->cap->currentfillcolorspace=2;//õǰɫռ Ա˳
 }
 
 static void pdf_run_gs(pdf_csi *csi, pdf_obj *rdb)
@@ -3145,9 +3650,12 @@ static void pdf_run_h(pdf_csi *csi)
 	getline->set[getline->count].points[getline->set[getline->count].countpoint][6]=2;//յ,hǷ
 	getline->set[getline->count].countpoint++;//ĸ++;
 	*/
-	currentstackpoint->currentroute->currentpoint->state=2;
-	addpoint(currentstackpoint->currentroute);//һµĵ
-	currentstackpoint->currentroute->countpoint++;//++
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=2;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);//һµĵ
+		csi->cap->currentstackpoint->currentroute->countpoint++;//++
+	}
 }
 
 static void pdf_run_i(pdf_csi *csi)
@@ -3167,11 +3675,15 @@ static void pdf_run_j(pdf_csi *csi)
 
 static void pdf_run_k(pdf_csi *csi)
 {
-	colorchanged=1;
+	if(csi->cap)
+		csi->cap->colorchanged=1;
 	csi->dev->flags &= ~FZ_DEVFLAG_FILLCOLOR_UNDEFINED;
 	pdf_set_colorspace(csi, PDF_FILL, fz_device_cmyk);
-	currentstackpoint->currentroute->colorspace=5;//cmykɫʿռ
-	currentfillcolorspace=5;
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->colorspace=5;//cmykɫʿռ
+		csi->cap->currentfillcolorspace=5;
+	}
 	pdf_set_color(csi, PDF_FILL, csi->stack);//ɫ
 }
 
@@ -3187,14 +3699,17 @@ static void pdf_run_l(pdf_csi *csi)
 	getline->set[getline->count].points[getline->set[getline->count].countpoint][6]=1;
 	getline->set[getline->count].countpoint++;//ĸ++;
 	*/
-	currentstackpoint->currentroute->currentpoint->p0=a;
-	currentstackpoint->currentroute->currentpoint->p1=b;
-	Vpointx=a;
-	Vpointy=b;
-	currentstackpoint->currentroute->currentpoint->state=1;
-	currentstackpoint->currentroute->countpoint++;
-	//getline->current->type=1;
-	addpoint(currentstackpoint->currentroute);//һµĵ
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=a;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=b;
+		csi->cap->Vpointx=a;
+		csi->cap->Vpointy=b;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=1;
+		csi->cap->currentstackpoint->currentroute->countpoint++;
+		//getline->current->type=1;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);//һµĵ
+	}
 	fz_lineto(csi->dev->ctx, csi->path, a, b);
 }
 
@@ -3205,13 +3720,16 @@ static void pdf_run_m(pdf_csi *csi)
 	b = csi->stack[1];
 	
 	
-	currentstackpoint->currentroute->currentpoint->p0=a;
-	currentstackpoint->currentroute->currentpoint->p1=b;
-	currentstackpoint->currentroute->currentpoint->state=0;
-	currentstackpoint->currentroute->countpoint++;
-	Vpointx=a;
-	Vpointy=b;
-	addpoint(currentstackpoint->currentroute);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=a;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=b;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=0;
+		csi->cap->currentstackpoint->currentroute->countpoint++;
+		csi->cap->Vpointx=a;
+		csi->cap->Vpointy=b;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+	}
 #ifdef debug
 	printf("%f %f \n",a,b);
 #endif
@@ -3225,25 +3743,8 @@ static void pdf_run_n(pdf_csi *csi)
 
 static void pdf_run_q(pdf_csi *csi)
 {
-	stackstate++;
-	
-	if(stackstate==1)//
-	{
-		currentstackpoint->existstack=1;
-		//currentstackpoint->existnest=0;
-		//printf("stack: %d\n",currentstackpoint->existnest);
-		//addneststack(currentstackpoint);
-		push(currentstackpoint);
-	}
-	else
-	{
-		currentstackpoint->existnest=1;
-		//printf("stack: %d\n",currentstackpoint->existnest);
-		addneststack(currentstackpoint);
-		currentstackpoint=currentstackpoint->currentstack;//ǰջָƶһ
-		push(currentstackpoint);
-		currentstackpoint->existstack=1;
-	}
+	if(csi->cap)
+		pdf_capture_push(csi);
 	pdf_gsave(csi);
 }
 
@@ -3281,28 +3782,31 @@ static void pdf_run_re(pdf_csi *csi)
 	getline->set[getline->count].countpoint=5;
 	//εΪ5
 	*/
-	currentstackpoint->currentroute->currentpoint->p0=x;
-	currentstackpoint->currentroute->currentpoint->p1=y;
-	currentstackpoint->currentroute->currentpoint->state=0;
-	addpoint(currentstackpoint->currentroute);
-	currentstackpoint->currentroute->currentpoint->p0=x+w;
-	currentstackpoint->currentroute->currentpoint->p1=y;
-	currentstackpoint->currentroute->currentpoint->state=1;
-	addpoint(currentstackpoint->currentroute);
-	currentstackpoint->currentroute->currentpoint->p0=x+w;
-	currentstackpoint->currentroute->currentpoint->p1=y+h;
-	currentstackpoint->currentroute->currentpoint->state=1;
-	addpoint(currentstackpoint->currentroute);
-	currentstackpoint->currentroute->currentpoint->p0=x;
-	currentstackpoint->currentroute->currentpoint->p1=y+h;
-	currentstackpoint->currentroute->currentpoint->state=1;
-	addpoint(currentstackpoint->currentroute);
-	currentstackpoint->currentroute->currentpoint->p0=x;
-	currentstackpoint->currentroute->currentpoint->p1=y;
-	currentstackpoint->currentroute->currentpoint->state=2;
-	currentstackpoint->currentroute->countpoint+=5;
-	currentstackpoint->currentroute->type=3;
-	addpoint(currentstackpoint->currentroute);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=x;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=y;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=0;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=x+w;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=y;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=1;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=x+w;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=y+h;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=1;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=x;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=y+h;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=1;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=x;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=y;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=2;
+		csi->cap->currentstackpoint->currentroute->countpoint+=5;
+		csi->cap->currentstackpoint->currentroute->type=3;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+	}
 	fz_moveto(ctx, csi->path, x, y);
 	fz_lineto(ctx, csi->path, x + w, y);
 	fz_lineto(ctx, csi->path, x + w, y + h);
@@ -3312,13 +3816,15 @@ static void pdf_run_re(pdf_csi *csi)
 
 static void pdf_run_rg(pdf_csi *csi)
 {
-	colorchanged=1;
+	if(csi->cap)
+		csi->cap->colorchanged=1;
 	csi->dev->flags &= ~FZ_DEVFLAG_FILLCOLOR_UNDEFINED;
 	pdf_set_colorspace(csi, PDF_FILL, fz_device_rgb);
 	pdf_set_color(csi, PDF_FILL, csi->stack);
 	//getline->set[getline->count].colorspace=4;//ɫʿռ 4rg
 	//currentstackpoint->currentroute->colorspace=4;
-	currentfillcolorspace=4;//õǰɫռ Ա˳
+	if(csi->cap)
+		csi->cap->currentfillcolorspace=4;//õǰɫռ Ա˳
 }
 
 static void pdf_run_ri(pdf_csi *csi)
@@ -3328,50 +3834,53 @@ static void pdf_run_ri(pdf_csi *csi)
 static void pdf_run(pdf_csi *csi)//s ӦS+h
 {
 	pdf_show_path(csi, 1, 0, 1, 0);
-	currentstackpoint->currentroute->currentpoint->state=2;
-	addpoint(currentstackpoint->currentroute);//һµĵ
-	currentstackpoint->currentroute->countpoint++;
-	currentstackpoint->currentroute->drawingmethord=4;
-	currentstackpoint->countroute++;
-	if(currentstackpoint->currentroute->colorspace==-1)
-	{
-		currentstackpoint->currentroute->colorspace=currentstrokecolorspace;
-		//getline->set[getline->count].colorspace=currentcolorspace;
-		//printf(":currentcolorspace:  %d\n",currentcolorspace);
-		//rintf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
-		if(currentstrokecolorspace==3||currentstrokecolorspace==4)
-		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			getline->set[getline->count].color[1]=currentcolor[1];
-			getline->set[getline->count].color[2]=currentcolor[2];
-			*/
-			currentstackpoint->currentroute->color[0]=currentstrokecolor[0];
-			currentstackpoint->currentroute->color[1]=currentstrokecolor[1];
-			currentstackpoint->currentroute->color[2]=currentstrokecolor[2];
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=2;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);//һµĵ
+		csi->cap->currentstackpoint->currentroute->countpoint++;
+		csi->cap->currentstackpoint->currentroute->drawingmethord=4;
+		csi->cap->currentstackpoint->countroute++;
+		if(csi->cap->currentstackpoint->currentroute->colorspace==-1)
+		{
+			csi->cap->currentstackpoint->currentroute->colorspace=csi->cap->currentstrokecolorspace;
+			//getline->set[getline->count].colorspace=currentcolorspace;
+			//printf(":currentcolorspace:  %d\n",currentcolorspace);
+			//rintf(":˳RGBɫʿռ %.3f %.3f %.3f\n",currentcolor[0],currentcolor[1],currentcolor[2]);
+			if(csi->cap->currentstrokecolorspace==3||csi->cap->currentstrokecolorspace==4)
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				getline->set[getline->count].color[1]=currentcolor[1];
+				getline->set[getline->count].color[2]=currentcolor[2];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentstrokecolor[0];
+				csi->cap->currentstackpoint->currentroute->color[1]=csi->cap->currentstrokecolor[1];
+				csi->cap->currentstackpoint->currentroute->color[2]=csi->cap->currentstrokecolor[2];
+			}
+			else
+			{
+				/*
+				getline->set[getline->count].color[0]=currentcolor[0];
+				*/
+				csi->cap->currentstackpoint->currentroute->color[0]=csi->cap->currentstrokecolor[0];
+			}	
 		}
-		else
+		if(csi->cap->currentstackpoint->currentroute->linewidth==-1)//߿˳
 		{
-			/*
-			getline->set[getline->count].color[0]=currentcolor[0];
-			*/
-			currentstackpoint->currentroute->color[0]=currentstrokecolor[0];
-		}	
-	}
-	if(currentstackpoint->currentroute->linewidth==-1)//߿˳
-	{
-		currentstackpoint->currentroute->linewidth=currentlinewidth;
-	}
-	if(currentstackpoint->existstack!=0)
-	{
-		addroute(currentstackpoint);//ջ·  (֮һĵ)
-	}
-	else//Ϊ
-	{
-		currentstackpoint->countroute=1;//ֻһ·
-		addstack(getline);
-		currentstackpoint=getline->currentstack;
-		getline->count++;
+			csi->cap->currentstackpoint->currentroute->linewidth=csi->cap->currentlinewidth;
+		}
+		if(csi->cap->currentstackpoint->existstack!=0)
+		{
+			addroute(csi->cap->getline->arena,csi->cap->currentstackpoint);//ջ·  (֮һĵ)
+		}
+		else//Ϊ
+		{
+			csi->cap->currentstackpoint->countroute=1;//ֻһ·
+			addstack(csi->cap->getline);
+			csi->cap->currentstackpoint=csi->cap->getline->currentstack;
+			csi->cap->getline->count++;
+		}
 	}
 }
 
@@ -3394,6 +3903,7 @@ static void pdf_run_sh(pdf_csi *csi, pdf_obj *rdb)
 	{
 		shd = pdf_load_shading(csi->xref, obj);//Ӱ
 		/* RJW: "cannot load shading (%d %d R)", pdf_to_num(obj), pdf_to_gen(obj) */
+		pdf_capture_shade(csi, shd);
 		fz_try(ctx)
 		{
 			pdf_show_shade(csi, shd);
@@ -3414,17 +3924,20 @@ static void pdf_run_v(pdf_csi *csi)
 	b = csi->stack[1];
 	c = csi->stack[2];
 	d = csi->stack[3];
-	currentstackpoint->currentroute->currentpoint->p0=Vpointx;
-	currentstackpoint->currentroute->currentpoint->p1=Vpointy;
-	currentstackpoint->currentroute->currentpoint->p2=a;
-	currentstackpoint->currentroute->currentpoint->p3=b;
-	currentstackpoint->currentroute->currentpoint->p4=c;
-	currentstackpoint->currentroute->currentpoint->p5=d;
-	currentstackpoint->currentroute->currentpoint->state=3;
-	Vpointx=c;
-	Vpointy=d;
-	currentstackpoint->currentroute->countpoint++;
-	addpoint(currentstackpoint->currentroute);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=csi->cap->Vpointx;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=csi->cap->Vpointy;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p2=a;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p3=b;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p4=c;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p5=d;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=3;
+		csi->cap->Vpointx=c;
+		csi->cap->Vpointy=d;
+		csi->cap->currentstackpoint->currentroute->countpoint++;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+	}
 	fz_curvetov(csi->dev->ctx, csi->path, a, b, c, d);
 }
 
@@ -3437,8 +3950,11 @@ static void pdf_run_w(pdf_csi *csi)
 	gstate->stroke_state->linewidth = csi->stack[0];
 	//getline->set[getline->count].type=1;//·
 	//getline->set[getline->count].linewidth= csi->stack[0];//߿
-	currentstackpoint->currentroute->linewidth=csi->stack[0];
-	currentlinewidth=csi->stack[0];//˳߿
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->linewidth=csi->stack[0];
+		csi->cap->currentlinewidth=csi->stack[0];//˳߿
+	}
 }
 
 static void pdf_run_y(pdf_csi *csi)
@@ -3448,17 +3964,20 @@ static void pdf_run_y(pdf_csi *csi)
 	b = csi->stack[1];
 	c = csi->stack[2];
 	d = csi->stack[3];
-	currentstackpoint->currentroute->currentpoint->p0=a;
-	currentstackpoint->currentroute->currentpoint->p1=b;
-	currentstackpoint->currentroute->currentpoint->p2=c;
-	currentstackpoint->currentroute->currentpoint->p3=d;
-	currentstackpoint->currentroute->currentpoint->p4=c;
-	currentstackpoint->currentroute->currentpoint->p5=d;
-	currentstackpoint->currentroute->currentpoint->state=3;
-	Vpointx=c;
-	Vpointy=d;
-	currentstackpoint->currentroute->countpoint++;
-	addpoint(currentstackpoint->currentroute);
+	if(csi->cap)
+	{
+		csi->cap->currentstackpoint->currentroute->currentpoint->p0=a;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p1=b;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p2=c;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p3=d;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p4=c;
+		csi->cap->currentstackpoint->currentroute->currentpoint->p5=d;
+		csi->cap->currentstackpoint->currentroute->currentpoint->state=3;
+		csi->cap->Vpointx=c;
+		csi->cap->Vpointy=d;
+		csi->cap->currentstackpoint->currentroute->countpoint++;
+		addpoint(csi->cap->getline->arena,csi->cap->currentstackpoint->currentroute);
+	}
 	fz_curvetoy(csi->dev->ctx, csi->path, a, b, c, d);
 }
 
@@ -3639,18 +4158,30 @@ pdf_run_keyword(pdf_csi *csi, pdf_obj *rdb, fz_stream *file, char *buf)//
 	fz_assert_lock_not_held(ctx, FZ_LOCK_FILE);
 }
 
+static void
+pdf_begin_capture(pdf_csi *csi)//ʼȡһҳ,һεȡѲɴ,ͷڴ
+{
+	csi->cap->stackstate=0;//Ĭϲͼ״̬ջ
+	csi->cap->nested=0;
+	if(csi->cap->getline==NULL)
+		csi->cap->getline=(struct zblrouteset*)malloc(sizeof(struct zblrouteset));//ṹָռ
+	else
+		fz_free_line(csi->cap->getline);
+	//ʼ
+	freecstack(&csi->cap->cstack);
+	initcstack(&csi->cap->cstack);
+	initrouteset(csi->dev->ctx,csi->cap->getline);
+	addstack(csi->cap->getline);
+	csi->cap->currentstackpoint=csi->cap->getline->currentstack;//ǰջָΪgetlinestackheadler->next,һһջ
+}
+
 static void
 pdf_run_stream(pdf_csi *csi, pdf_obj *rdb, fz_stream *file, pdf_lexbuf *buf)//зಢӦ
 {
 	fz_context *ctx = csi->dev->ctx;
 	int tok, in_array;
-	stackstate=0;//Ĭϲͼ״̬ջ
-	getline=(struct zblrouteset*)malloc(sizeof(struct zblrouteset));//ȫֱṹָռ
-	//ʼ
-	initcstack();
-	initrouteset(getline);
-	addstack(getline);
-	currentstackpoint=getline->currentstack;//ǰջָΪgetlinestackheadler->next,һһջ
+	if(csi->cap&&(csi->cap->getline==NULL||csi->cap->getline->arena==NULL))//,ͼҳȡ,ֻлδʼȡʱųʼ
+		pdf_begin_capture(csi);
 /*
 	for(i=0;i<1000;i++)
 	{
@@ -3862,6 +4393,8 @@ pdf_run_page_with_usage(pdf_document *xref, pdf_page *page, fz_device *dev, fz_m
 	csi = pdf_new_csi(xref, dev, ctm, event, cookie, NULL);
 	fz_try(ctx)
 	{
+		if (csi->cap)//ҳͷȡ,֮ıעͶӵҳĽ
+			pdf_begin_capture(csi);
 		pdf_run_buffer(csi, page->resources, page->contents);//ҳcontents
 	}
 	fz_catch(ctx)
@@ -53,6 +53,7 @@ pdf_load_pattern(pdf_document *xref, pdf_obj *dict)
 	/* Store pattern now, to avoid possible recursion if objects refer back to this one */
 	pdf_store_item(ctx, dict, pat, pdf_pattern_size(pat));
 
+	pat->num = pdf_to_num(dict);
 	pat->ismask = pdf_to_int(pdf_dict_gets(dict, "PaintType")) == 2;
 	pat->xstep = pdf_to_real(pdf_dict_gets(dict, "XStep"));
 	pat->ystep = pdf_to_real(pdf_dict_gets(dict, "YStep"));
@@ -5,10 +5,6 @@
 #define FUNSEGS 32 /* size of sampled mesh for function-based shadings */
 #define RADSEGS 32 /* how many segments to generate for radial meshes */
 #define SUBDIV 3 /* how many levels to subdivide patches */
-//extern zblstack* currentstackpoint;
-int zcounter;
-extern struct zblrouteset *getline;
-extern struct zblstack* currentstackpoint;
 struct vertex
 {
 	float x, y;
@@ -332,7 +328,6 @@ pdf_sample_composite_shade_function(fz_context *ctx, fz_shade *shade, pdf_functi
 
 	for (i = 0; i < 256; i++)//ΪʲôҪ256?
 	{
-		zcounter=i;
 		t = t0 + (i / 255.0f) * (t1 - t0);//t01,ÿ1/255,4Ϊ1
 		pdf_eval_function(ctx, func, &t, 1, shade->function[i], shade->colorspace->n);
 		shade->function[i][shade->colorspace->n] = 1;
@@ -1059,9 +1054,6 @@ pdf_load_shading_dict(pdf_document *xref, pdf_obj *dict, fz_matrix transform)
 			}
 		}
 		printf("Ӱ%d %d\n",type,funcs);
-		currentstackpoint->shadowtype=type;
-		currentstackpoint->bcolor=(float*)malloc(4*sizeof(float));
-		currentstackpoint->ecolor=(float*)malloc(4*sizeof(float));//Ϊɫռ
 		switch (type)//ͬ͵Ӱ
 		{
 		case 1: pdf_load_function_based_shading(shade, xref, dict, func[0]); break;
@@ -1074,6 +1066,12 @@ pdf_load_shading_dict(pdf_document *xref, pdf_obj *dict, fz_matrix transform)
 		default:
 			fz_throw(ctx, "unknown shading type: %d", type);
 		}
+		shade->shadowtype=type;//¼Ӱֹɫ,ʾӰʱȡ
+		for (i = 0; i < 4; i++)
+		{
+			shade->bcolor[i] = shade->use_function && i < shade->colorspace->n ? shade->function[0][i] : 0;
+			shade->ecolor[i] = shade->use_function && i < shade->colorspace->n ? shade->function[255][i] : 0;
+		}
 
 		for (i = 0; i < funcs; i++)
 			if (func[i])